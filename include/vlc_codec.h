@@ -66,6 +66,8 @@ struct decoder_owner_callbacks
             /* Display rate
              * cf. decoder_GetDisplayRate */
             float       (*get_display_rate)( decoder_t * );
+            /* cf. decoder_IsScrubbing */
+            bool        (*is_scrubbing)( decoder_t * );
         } video;
         struct
         {
@@ -389,6 +391,41 @@ VLC_API int decoder_UpdateVideoFormat( decoder_t *dec );
  */
 VLC_API picture_t *decoder_NewPicture( decoder_t *dec );
 
+/**
+ * Threads reserved from the decoder thread budget.
+ */
+typedef struct
+{
+    unsigned count; /**< number of threads held, 0 if none */
+    uint64_t weight; /**< picture size accounted at reservation time */
+} decoder_threads_t;
+
+/**
+ * Reserves threads from the decoder thread budget.
+ *
+ * The budget is shared by all the decoders of the process, see the
+ * "dec-threads" option. The share depends on the picture size of the input
+ * format and on the threads already held by the other decoders.
+ *
+ * \param dec the decoder
+ * \param wanted the number of threads the decoder would use on its own
+ * \param threads the reservation, to be given back with
+ * decoder_ReleaseThreads()
+ * \return the number of threads to use, at least 1
+ */
+VLC_API unsigned decoder_AcquireThreads( decoder_t *dec, unsigned wanted,
+                                         decoder_threads_t *threads );
+
+/**
+ * Gives back threads reserved with decoder_AcquireThreads().
+ *
+ * This does nothing if the reservation holds no threads, and the reservation
+ * holds none after the call.
+ *
+ * \param threads the reservation
+ */
+VLC_API void decoder_ReleaseThreads( decoder_threads_t *threads );
+
 /**
  * Initialize a decoder structure before creating the decoder.
  *
@@ -583,6 +620,24 @@ static inline float decoder_GetDisplayRate( decoder_t *dec )
     return dec->cbs->video.get_display_rate( dec );
 }
 
+/**
+ * This function returns whether the owner is scrubbing.
+ *
+ * While scrubbing, pictures are only shown briefly: the decoder should favour
+ * speed over quality, e.g. by skipping the loop filters and the non-reference
+ * frames. It can be polled before each decode call.
+ */
+VLC_USED
+static inline bool decoder_IsScrubbing( decoder_t *dec )
+{
+    vlc_assert( dec->fmt_in->i_cat == VIDEO_ES && dec->cbs != NULL );
+
+    if( !dec->cbs->video.is_scrubbing )
+        return false;
+
+    return dec->cbs->video.is_scrubbing( dec );
+}
+
 /** @} */
 
 /**
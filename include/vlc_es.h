@@ -647,6 +647,8 @@ struct es_format_t
     int      i_level;         /**< codec specific information: indicates maximum restrictions on the stream (resolution, bitrate, codec features ...) */
 
     bool     b_packetized;  /**< whether the data is packetized (ie. not truncated) */
+    bool     b_framed;      /**< whether each block holds exactly one access unit
+                                 with valid timestamps (length prefixed NALs) */
     size_t   i_extra;       /**< length in bytes of extra data pointer */
     void    *p_extra;       /**< extra data needed by some decoders or muxers */
 
@@ -100,6 +100,11 @@ enum es_out_query_e
 
     ES_OUT_POST_SUBNODE, /* arg1=input_item_node_t *, res=can fail */
 
+    /* Post the sub items read so far, before the final node posted with
+     * ES_OUT_POST_SUBNODE. On failure, the caller keeps the ownership of the
+     * node, and should post its items with the final node. */
+    ES_OUT_POST_PARTIAL_SUBNODE, /* arg1=input_item_node_t *, res=can fail */
+
     ES_OUT_VOUT_SET_MOUSE_EVENT, /* arg1= es_out_id_t* (video es),
                                     arg2=vlc_mouse_event, arg3=void *(user_data),
                                     res=can fail */
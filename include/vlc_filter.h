@@ -115,6 +115,17 @@ struct vlc_filter_operations
         block_t *(*drain_audio)(filter_t *);
     };
 
+    /** Filter planar samples in place (audio filter, optional)
+     *
+     * Filters with identical FL32 input and output formats may provide this
+     * in addition to filter_audio. The audio output then runs successive
+     * such filters on a shared buffer with one plane of \p frames samples
+     * per channel, without allocations nor conversions between them.
+     * The result must be the same as with filter_audio.
+     */
+    void (*filter_audio_planar)(filter_t *, float *const *planes,
+                                size_t frames);
+
     /** Flush
      *
      * Flush (i.e. discard) any internal buffer in a video or audio filter.
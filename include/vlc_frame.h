@@ -324,6 +324,56 @@ static inline vlc_frame_t *vlc_frame_Duplicate( const vlc_frame_t *frame )
     return p_dup;
 }
 
+/**
+ * Makes a frame shareable.
+ *
+ * Converts a frame so that vlc_frame_Share() can reference its payload
+ * instead of copying it. This is a no-op if the frame is already shareable.
+ *
+ * @param frame the frame to convert, which must not be used after the call
+ * to this function
+ * @return the shareable frame, or the unmodified frame on memory error.
+ */
+VLC_API vlc_frame_t *vlc_frame_MakeShareable(vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Shares a frame.
+ *
+ * Creates a new frame referencing the same payload as the given frame,
+ * with a copy of its properties. The payload is reference-counted: it must be
+ * treated as read-only as long as it is shared, see vlc_frame_MakeWritable().
+ *
+ * If the frame was not made shareable with vlc_frame_MakeShareable(), this
+ * function is equivalent to vlc_frame_Duplicate().
+ *
+ * @return the new frame on success, NULL on error.
+ */
+VLC_API vlc_frame_t *vlc_frame_Share(const vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Checks if the payload of a frame is shared with other frames.
+ *
+ * @retval true if the payload must not be written to
+ * @retval false if the frame owns its payload
+ */
+VLC_API bool vlc_frame_IsShared(const vlc_frame_t *frame) VLC_USED;
+
+/**
+ * Makes the payload of a frame writable.
+ *
+ * Modules modifying a frame payload in place must call this function first.
+ * If the payload is shared, it is copied (copy-on-write), otherwise the frame
+ * is returned as is.
+ *
+ * @note vlc_frame_Realloc() and vlc_frame_TryRealloc() never expand a frame
+ * into the spare space of a shared payload.
+ *
+ * @param frame the frame, which will be freed if it needs to be copied
+ * @return the writable frame on success, NULL on error (the frame is then
+ * discarded).
+ */
+VLC_API vlc_frame_t *vlc_frame_MakeWritable(vlc_frame_t *frame) VLC_USED;
+
 /**
  * Wraps heap in a frame.
  *
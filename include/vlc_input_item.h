@@ -297,6 +297,54 @@ VLC_API vlc_tick_t input_item_GetDuration( input_item_t * p_i );
 VLC_API void input_item_SetDuration( input_item_t * p_i, vlc_tick_t i_duration );
 VLC_API bool input_item_IsPreparsed( input_item_t *p_i );
 VLC_API bool input_item_IsArtFetched( input_item_t *p_i );
+
+/**
+ * Returns a counter changed whenever the name, URI, duration or a meta value
+ * of the item is modified.
+ *
+ * It may be read without holding the item lock, to check whether a copy of
+ * these values is still up to date.
+ */
+VLC_API unsigned input_item_GetRevision( input_item_t *item );
+
+/**
+ * Immutable copy of the main metadata of an item
+ */
+struct input_item_meta_snapshot
+{
+    const char *name; /**< item name (nullable) */
+    const char *uri; /**< item MRL (nullable) */
+    vlc_tick_t duration; /**< item duration */
+    const char *meta[VLC_META_TYPE_COUNT]; /**< meta values (nullable) */
+};
+
+/**
+ * Get a snapshot of the metadata of an item, without locking nor copying
+ *
+ * The snapshot is shared by all the readers, and is only rebuilt (under the
+ * item lock) after the item has been modified. The values may be slightly
+ * out of date if the item is modified concurrently.
+ *
+ * The snapshot remains valid until input_item_ReleaseMetaSnapshot() is
+ * called. A replaced snapshot is freed when its last reader releases it.
+ *
+ * \param item the item
+ * \return the snapshot, or NULL on error (in that case,
+ * input_item_ReleaseMetaSnapshot() must not be called)
+ */
+VLC_API const struct input_item_meta_snapshot *
+input_item_AcquireMetaSnapshot( input_item_t *item ) VLC_USED;
+
+/**
+ * Release a snapshot acquired by input_item_AcquireMetaSnapshot()
+ *
+ * This function must be called without holding the item lock.
+ *
+ * \param item the item
+ * \param snap the snapshot to release
+ */
+VLC_API void input_item_ReleaseMetaSnapshot( input_item_t *item,
+                                const struct input_item_meta_snapshot *snap );
 VLC_API char * input_item_GetMetaExtra( input_item_t *p_i, const char *psz_name ) VLC_USED;
 VLC_API unsigned input_item_GetMetaExtraNames( input_item_t *p_i, char ***pppsz_names ) VLC_USED;
 VLC_API void input_item_SetMetaExtra( input_item_t *p_i, const char *psz_name, const char *psz_value );
@@ -467,6 +515,21 @@ typedef struct input_item_parser_cbs_t
     void (*on_attachments_added)(input_item_t *item,
                                  input_attachment_t *const *array,
                                  size_t count, void *userdata);
+
+    /**
+     * Event received when a part of the subtree is added
+     *
+     * @note This callback is optional. If set, large playlists may be
+     * received in several parts, before the last part received by
+     * on_subtree_added(). Otherwise, the whole subtree is received at once.
+     *
+     * @param item the parsed item
+     * @param subtree sub items read so far (the listener gets the ownership)
+     * @param userdata user data set by input_item_Parse()
+     */
+    void (*on_partial_subtree_added)(input_item_t *item,
+                                     input_item_node_t *subtree,
+                                     void *userdata);
 } input_item_parser_cbs_t;
 
 /**
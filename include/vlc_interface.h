@@ -93,6 +93,22 @@ VLC_API int intf_Create( libvlc_int_t *, const char * );
 
 VLC_API void libvlc_Quit( libvlc_int_t * );
 
+/**
+ * Registers a function to call when a LibVLC instance is cleaned up.
+ *
+ * This is meant for state shared by all the objects of an instance, such as
+ * a pool of network connections, that must outlive any of them but not the
+ * instance. The functions are called in reverse registration order, once
+ * the interfaces and the playlist are gone, while plugins are still loaded.
+ *
+ * \param libvlc the LibVLC instance
+ * \param cb function to call
+ * \param opaque data for the function
+ * \return 0 on success, -ENOMEM on error
+ */
+VLC_API int libvlc_AddCleanup( libvlc_int_t *libvlc, void (*cb)(void *),
+                               void *opaque );
+
 /**
  * Recover the main playlist from an interface module
  *
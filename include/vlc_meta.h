@@ -104,6 +104,14 @@ VLC_API char ** vlc_meta_CopyExtraNames( const vlc_meta_t *m ) VLC_USED;
 
 VLC_API void vlc_meta_Merge( vlc_meta_t *dst, const vlc_meta_t *src );
 
+/**
+ * Returns a counter incremented whenever a meta value is modified.
+ *
+ * It may be read without holding the lock protecting the meta, to check
+ * whether a copy of the values is still up to date.
+ */
+VLC_API unsigned vlc_meta_GetRevision( const vlc_meta_t *m );
+
 VLC_API int vlc_meta_GetStatus( vlc_meta_t *m );
 VLC_API void vlc_meta_SetStatus( vlc_meta_t *m, int status );
 
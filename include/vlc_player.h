@@ -606,6 +606,33 @@ vlc_player_IncrementRate(vlc_player_t *player);
 VLC_API void
 vlc_player_DecrementRate(vlc_player_t *player);
 
+/**
+ * Enable or disable the scrubbing mode
+ *
+ * This mode is meant to be enabled while the user drags the seek bar: video
+ * decoders favour speed over quality (by skipping the loop filters and the
+ * non-reference frames, if supported), audio is not decoded and a new seek
+ * request cancels the previous ones that are not completed yet.
+ *
+ * @note The scrubbing state is saved across several medias
+ *
+ * @param player locked player instance
+ * @param scrubbing true to enable the scrubbing mode
+ */
+VLC_API void
+vlc_player_SetScrubbing(vlc_player_t *player, bool scrubbing);
+
+/**
+ * Get the scrubbing state of the player
+ *
+ * @see vlc_player_SetScrubbing()
+ *
+ * @param player locked player instance
+ * @return true if the scrubbing mode is enabled
+ */
+VLC_API bool
+vlc_player_IsScrubbing(vlc_player_t *player);
+
 /**
  * Get the length of the current media
  *
@@ -112,6 +112,20 @@ struct vlc_preparser_cbs
     void (*on_attachments_added)(vlc_preparser_req *req,
                                  input_attachment_t *const *array,
                                  size_t count, void *data);
+
+    /**
+     * Event received when a part of the subtree is added
+     *
+     * @note This callback is optional. If set, large playlists may be
+     * received in several parts, before the last part received by
+     * on_subtree_added(). Otherwise, the whole subtree is received at once.
+     *
+     * @param req request handle returned by vlc_preparser_Push()
+     * @param subtree sub items read so far (the listener gets the ownership)
+     * @param data opaque pointer passed by vlc_preparser_Push()
+     */
+    void (*on_partial_subtree_added)(vlc_preparser_req *req,
+                                     input_item_node_t *subtree, void *data);
 };
 
 /**
@@ -148,6 +162,55 @@ struct vlc_thumbnailer_cbs
     void (*on_ended)(vlc_preparser_req *req, int status, picture_t* thumbnail, void *data);
 };
 
+/**
+ * Preparser thumbnailer batch callbacks
+ *
+ * Used by vlc_preparser_GenerateThumbnails()
+ */
+struct vlc_thumbnailer_batch_cbs
+{
+    /**
+     * Event received for each thumbnail of the batch
+     *
+     * Thumbnails are reported in the order of the arguments passed to
+     * vlc_preparser_GenerateThumbnails().
+     *
+     * @note This callback is mandatory if calling
+     * vlc_preparser_GenerateThumbnails()
+     *
+     * The picture, if any, is owned by the thumbnailer, and must be acquired
+     * by using \link picture_Hold \endlink to use it pass the callback's
+     * scope.
+     *
+     * @param req request handle returned by vlc_preparser_GenerateThumbnails()
+     * @param index index of the argument this thumbnail was generated for
+     * @param status VLC_SUCCESS in case of success, VLC_ETIMEOUT in case of
+     * timeout, an error otherwise
+     * @param thumbnail The generated thumbnail, or NULL in case of failure or
+     * timeout
+     * @param data opaque pointer passed by vlc_preparser_GenerateThumbnails()
+     */
+    void (*on_thumbnail)(vlc_preparser_req *req, size_t index, int status,
+                         picture_t *thumbnail, void *data);
+
+    /**
+     * Event received once the whole batch is processed
+     *
+     * This callback will always be called, provided
+     * vlc_preparser_GenerateThumbnails() returned a valid request, and
+     * provided the request is not cancelled before its completion.
+     *
+     * @note This callback is mandatory if calling
+     * vlc_preparser_GenerateThumbnails()
+     *
+     * @param req request handle returned by vlc_preparser_GenerateThumbnails()
+     * @param status VLC_SUCCESS if every thumbnail was attempted, -EINTR if
+     * cancelled, an error otherwise
+     * @param data opaque pointer passed by vlc_preparser_GenerateThumbnails()
+     */
+    void (*on_ended)(vlc_preparser_req *req, int status, void *data);
+};
+
 /**
  * Preparser thumbnailer to file callbacks
  *
@@ -213,7 +276,8 @@ struct vlc_thumbnailer_arg
         {
             /** Precise, but potentially slow */
             VLC_THUMBNAILER_SEEK_PRECISE,
-            /** Fast, but potentially imprecise */
+            /** Fast, but potentially imprecise: seek to the nearest keyframe
+             * and decode only that frame */
             VLC_THUMBNAILER_SEEK_FAST,
         } speed;
     } seek;
@@ -353,6 +417,34 @@ vlc_preparser_GenerateThumbnail( vlc_preparser_t *preparser, input_item_t *item,
                                  const struct vlc_thumbnailer_cbs *cbs,
                                  void *cbs_userdata );
 
+/**
+ * This function enqueues the provided item for generating several thumbnails
+ *
+ * All thumbnails are generated from a single opening of the item, by seeking
+ * from one argument to the next. If every argument uses
+ * VLC_THUMBNAILER_SEEK_FAST, only keyframes are decoded.
+ *
+ * @param preparser the preparser object
+ * @param item a valid item to generate the thumbnails for
+ * @param args array of arguments, one thumbnail is generated per argument
+ * (the hardware decoding setting of the first one applies to all)
+ * @param arg_count size of the args array, must be > 0
+ * @param cbs callbacks to listen to events (can't be NULL)
+ * @param cbs_userdata opaque pointer used by the callbacks
+ * @return NULL in case of error, or a valid request handle if the
+ * item was scheduled for thumbnailing. If this returns an
+ * error, the thumbnailer callbacks will *not* be invoked
+ *
+ * The provided input_item will be held by the thumbnailer and can safely be
+ * released safely after calling this function.
+ */
+VLC_API vlc_preparser_req *
+vlc_preparser_GenerateThumbnails( vlc_preparser_t *preparser, input_item_t *item,
+                                  const struct vlc_thumbnailer_arg *args,
+                                  size_t arg_count,
+                                  const struct vlc_thumbnailer_batch_cbs *cbs,
+                                  void *cbs_userdata );
+
 /**
  * Get the best possible format
  *
@@ -407,7 +499,8 @@ vlc_preparser_GenerateThumbnailToFiles( vlc_preparser_t *preparser, input_item_t
  *
  * @param preparser the preparser object
  * @param req request handle returned by vlc_preparser_Push(),
- * vlc_preparser_GenerateThumbnail(), or vlc_preparser_GenerateThumbnailToFiles().
+ * vlc_preparser_GenerateThumbnail(), vlc_preparser_GenerateThumbnails(), or
+ * vlc_preparser_GenerateThumbnailToFiles().
  * Pass NULL to cancel all pending and running tasks.
  * @return number of tasks cancelled
  *
@@ -425,7 +518,8 @@ VLC_API size_t vlc_preparser_Cancel( vlc_preparser_t *preparser,
  * Fetch the input item associated with the request.
  *
  * @param req request handle returned by vlc_preparser_Push(),
- * vlc_preparser_GenerateThumbnail(), or vlc_preparser_GenerateThumbnailToFiles().
+ * vlc_preparser_GenerateThumbnail(), vlc_preparser_GenerateThumbnails(), or
+ * vlc_preparser_GenerateThumbnailToFiles().
  * @return input_item_t associated with the request
  *
  * @note The returned input item is held by the request, it must not be
@@ -32,15 +32,29 @@
 
 #include <limits.h>
 #include <sys/stat.h>
+#ifdef HAVE_STATX
+# include <fcntl.h>
+#endif
 
 #include <vlc_common.h>
 #include "fs.h"
 #include <vlc_access.h>
+#include <vlc_executor.h>
 #include <vlc_input_item.h>
+#include <vlc_vector.h>
 
 #include <vlc_fs.h>
 #include <vlc_url.h>
 
+/* The type of the entries is known from readdir(), if the file system
+ * provides it, and their metadata are fetched relative to the directory. */
+#if defined (HAVE_FSTATAT) && defined (DTTOIF)
+# define DIR_HAVE_DTYPE
+#endif
+
+/* Number of entries whose metadata are fetched by one task */
+#define DIR_STAT_BATCH 64
+
 typedef struct
 {
     char *base_uri;
@@ -131,63 +145,196 @@ void DirClose(vlc_object_t *obj)
     vlc_closedir(sys->dir);
 }
 
+/**
+ * Return the next entry of the directory, and its file type if known (0
+ * otherwise).
+ */
+static const char *DirNext(vlc_DIR *dir, mode_t *mode)
+{
+#ifdef DIR_HAVE_DTYPE
+    struct dirent *ent = readdir(dir);
+    if (ent == NULL)
+        return NULL;
+    *mode = ent->d_type != DT_UNKNOWN ? DTTOIF(ent->d_type) : 0;
+    return ent->d_name;
+#else
+    *mode = 0;
+    return vlc_readdir(dir);
+#endif
+}
+
+static int DirStat(stream_t *access, const char *entry, struct stat *st)
+{
+    access_sys_t *sys = access->p_sys;
+#ifdef HAVE_FSTATAT
+    return fstatat(dirfd(sys->dir), entry, st, 0);
+#else
+    char *path;
+    int ret;
+
+    VLC_UNUSED(sys);
+    if (asprintf(&path, "%s"DIR_SEP"%s", access->psz_filepath, entry) == -1)
+        return -1;
+    ret = vlc_stat(path, st);
+    free(path);
+    return ret;
+#endif
+}
+
+/**
+ * Return the item type of a file type, or -1 if it must be ignored.
+ */
+static int DirItemType(mode_t mode, bool special_files)
+{
+    switch (mode & S_IFMT)
+    {
+#ifdef S_IFBLK
+        case S_IFBLK:
+            return special_files ? ITEM_TYPE_DISC : -1;
+#endif
+        case S_IFCHR:
+            return special_files ? ITEM_TYPE_CARD : -1;
+        case S_IFIFO:
+            return special_files ? ITEM_TYPE_STREAM : -1;
+        case S_IFREG:
+            return ITEM_TYPE_FILE;
+        case S_IFDIR:
+            return ITEM_TYPE_DIRECTORY;
+        /* S_IFLNK cannot occur while following symbolic links */
+        /* S_IFSOCK cannot be opened with open()/openat() */
+        default:
+            return -1; /* ignore */
+    }
+}
+
+static void DirAddStat(input_item_t *item, int64_t mtime, int64_t size)
+{
+    if (mtime >= 0 && size >= 0)
+    {
+        input_item_AddStat( item, "mtime", mtime );
+        input_item_AddStat( item, "size", size );
+    }
+}
+
+#ifdef DIR_HAVE_DTYPE
+/* Item the metadata of which are fetched after the listing */
+struct dir_stat
+{
+    input_item_t *item;
+    char *name;
+};
+
+typedef struct VLC_VECTOR(struct dir_stat) dir_stat_vector;
+
+struct dir_stat_task
+{
+    int fd;
+    const struct dir_stat *entries;
+    size_t count;
+    struct vlc_runnable runnable;
+};
+
+static void DirStatRun(void *data)
+{
+    const struct dir_stat_task *task = data;
+
+    for (size_t i = 0; i < task->count; i++)
+    {
+        const struct dir_stat *entry = &task->entries[i];
+#ifdef HAVE_STATX
+        const unsigned mask = STATX_MTIME | STATX_SIZE;
+        struct statx stx;
+
+        /* Only the size and date are needed, and they need not be
+         * revalidated against the server on network file systems. */
+        if (statx(task->fd, entry->name, AT_STATX_DONT_SYNC, mask, &stx) == 0
+         && (stx.stx_mask & mask) == mask)
+            DirAddStat(entry->item, stx.stx_mtime.tv_sec, stx.stx_size);
+#else
+        struct stat st;
+
+        if (fstatat(task->fd, entry->name, &st, 0) == 0)
+            DirAddStat(entry->item, st.st_mtime, st.st_size);
+#endif
+    }
+}
+
+/**
+ * Fetch the metadata of the listed items, on several threads since each
+ * request is a round-trip on network file systems.
+ */
+static void DirStatAll(stream_t *access, const dir_stat_vector *entries)
+{
+    access_sys_t *sys = access->p_sys;
+    size_t count = (entries->size + DIR_STAT_BATCH - 1) / DIR_STAT_BATCH;
+    unsigned threads = var_InheritInteger(access, "directory-stat-threads");
+    struct dir_stat_task *tasks = vlc_alloc(count, sizeof (*tasks));
+    vlc_executor_t *executor = NULL;
+
+    if (tasks == NULL)
+        count = 0;
+    else if (count > 1 && threads > 1)
+        executor = vlc_executor_New(__MIN(threads, count));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        struct dir_stat_task *task = &tasks[i];
+
+        task->fd = dirfd(sys->dir);
+        task->entries = &entries->data[i * DIR_STAT_BATCH];
+        task->count = __MIN(entries->size - i * DIR_STAT_BATCH,
+                            (size_t)DIR_STAT_BATCH);
+        task->runnable.run = DirStatRun;
+        task->runnable.userdata = task;
+
+        if (executor != NULL)
+            vlc_executor_Submit(executor, &task->runnable);
+        else
+            DirStatRun(task);
+    }
+
+    if (executor != NULL)
+    {
+        vlc_executor_WaitIdle(executor);
+        vlc_executor_Delete(executor);
+    }
+    free(tasks);
+}
+#endif
+
 static int DirRead (stream_t *access, input_item_node_t *node)
 {
     access_sys_t *sys = access->p_sys;
     const char *entry;
+    mode_t mode;
     int ret = VLC_SUCCESS;
 
     bool special_files = var_InheritBool(access, "list-special-files");
 
     struct vlc_readdir_helper rdh;
     vlc_readdir_helper_init(&rdh, access, node);
+#ifdef DIR_HAVE_DTYPE
+    dir_stat_vector pending = VLC_VECTOR_INITIALIZER;
+#endif
 
-    while (ret == VLC_SUCCESS && (entry = vlc_readdir(sys->dir)) != NULL)
+    while (ret == VLC_SUCCESS && (entry = DirNext(sys->dir, &mode)) != NULL)
     {
         struct stat st;
-        int type;
-
-#ifdef HAVE_FSTATAT
-        if (fstatat(dirfd(sys->dir), entry, &st, 0))
-            continue;
-#else
-        char *path;
+        bool has_stat = false;
 
-        if (asprintf(&path, "%s"DIR_SEP"%s", access->psz_filepath, entry) == -1
-         || (type = vlc_stat(path, &st), free(path), type))
-            continue;
-#endif
-        switch (st.st_mode & S_IFMT)
+        /* Symbolic links are followed */
+        if (mode == 0 || S_ISLNK(mode))
         {
-#ifdef S_IFBLK
-            case S_IFBLK:
-                if (!special_files)
-                    continue;
-                type = ITEM_TYPE_DISC;
-                break;
-#endif
-            case S_IFCHR:
-                if (!special_files)
-                    continue;
-                type = ITEM_TYPE_CARD;
-                break;
-            case S_IFIFO:
-                if (!special_files)
-                    continue;
-                type = ITEM_TYPE_STREAM;
-                break;
-            case S_IFREG:
-                type = ITEM_TYPE_FILE;
-                break;
-            case S_IFDIR:
-                type = ITEM_TYPE_DIRECTORY;
-                break;
-            /* S_IFLNK cannot occur while following symbolic links */
-            /* S_IFSOCK cannot be opened with open()/openat() */
-            default:
-                continue; /* ignore */
+            if (DirStat(access, entry, &st))
+                continue;
+            mode = st.st_mode;
+            has_stat = true;
         }
 
+        int type = DirItemType(mode, special_files);
+        if (type == -1)
+            continue;
+
         /* Create an input item for the current entry */
         char *encoded = vlc_uri_encode(entry);
         if (unlikely(encoded == NULL))
@@ -210,15 +357,37 @@ static int DirRead (stream_t *access, input_item_node_t *node)
         input_item_t *p_item;
         ret = vlc_readdir_helper_additem(&rdh, uri, NULL, entry, type,
                                          ITEM_NET_UNKNOWN, &p_item);
+        free(uri);
+
+        if (ret != VLC_SUCCESS || p_item == NULL)
+            continue; /* not listed (e.g. hidden or ignored file) */
 
-        if (ret == VLC_SUCCESS && p_item && st.st_mtime >= 0 && st.st_size >= 0)
+        if (has_stat)
+            DirAddStat(p_item, st.st_mtime, st.st_size);
+#ifdef DIR_HAVE_DTYPE
+        else
         {
-            input_item_AddStat( p_item, "mtime", st.st_mtime );
-            input_item_AddStat( p_item, "size", st.st_size );
+            /* Fetch the metadata of listed items only, once all the
+             * entries are known */
+            struct dir_stat pending_entry = { p_item, strdup(entry) };
+            if (unlikely(pending_entry.name == NULL
+                      || !vlc_vector_push(&pending, pending_entry)))
+            {
+                free(pending_entry.name);
+                ret = VLC_ENOMEM;
+            }
         }
-        free(uri);
+#endif
     }
 
+#ifdef DIR_HAVE_DTYPE
+    if (ret == VLC_SUCCESS && pending.size > 0)
+        DirStatAll(access, &pending);
+    for (size_t i = 0; i < pending.size; i++)
+        free(pending.data[i].name);
+    vlc_vector_destroy(&pending);
+#endif
+
     vlc_readdir_helper_finish(&rdh, ret == VLC_SUCCESS);
 
     return ret;
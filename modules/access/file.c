@@ -50,6 +50,9 @@
 #else
 #   include <unistd.h>
 #endif
+#ifdef HAVE_MMAP
+#   include <sys/mman.h>
+#endif
 
 #include <vlc_common.h>
 #include "fs.h"
@@ -60,14 +63,27 @@
 #endif
 #include <vlc_fs.h>
 #include <vlc_url.h>
+#ifdef HAVE_LINUX_IO_URING_H
+# include <vlc_block.h>
+# include "uring.h"
+#endif
 
 typedef struct
 {
     int fd;
+#ifdef HAVE_MMAP
+    uint64_t offset; /* read position, memory-mapped mode only */
+#endif
+#ifdef HAVE_LINUX_IO_URING_H
+    file_uring_t *uring;
+#endif
 
     bool b_pace_control;
 } access_sys_t;
 
+/* Size of each memory-mapped window handed out as a block */
+#define FILE_MMAP_SIZE (1 << 20)
+
 #if !defined (_WIN32) && !defined (__OS2__)
 static bool IsRemote (int fd)
 {
@@ -161,12 +177,45 @@ static bool IsRemote (const char *path)
 # define IsRemote(fd,path) IsRemote(path)
 #endif
 
+#ifdef HAVE_MMAP
+/* A mapped page past the end of a truncated file faults (SIGBUS) when it is
+ * accessed, possibly long after its block was handed out, and a module cannot
+ * install a signal handler to recover from it. Checking the size again before
+ * each window does not protect the blocks already handed out either, so only
+ * files that cannot shrink while they are being read are mapped; the others
+ * are read normally. */
+static bool CannotShrink (int fd)
+{
+#ifdef F_SEAL_SHRINK
+    int seals = fcntl (fd, F_GET_SEALS);
+    if (seals != -1 && (seals & F_SEAL_SHRINK))
+        return true;
+#endif
+#if defined (HAVE_FSTATVFS) && defined (ST_RDONLY)
+    struct statvfs stf;
+
+    if (fstatvfs (fd, &stf) == 0 && (stf.f_flag & ST_RDONLY))
+        return true;
+#endif
+    (void) fd;
+    return false;
+}
+#endif
+
 #ifndef HAVE_POSIX_FADVISE
 # define posix_fadvise(fd, off, len, adv)
 #endif
 
 static ssize_t Read (stream_t *, void *, size_t);
 static int FileSeek (stream_t *, uint64_t);
+#ifdef HAVE_MMAP
+static block_t *BlockMap (stream_t *, bool *);
+static int MapSeek (stream_t *, uint64_t);
+#endif
+#ifdef HAVE_LINUX_IO_URING_H
+static block_t *BlockUring (stream_t *, bool *);
+static int UringSeek (stream_t *, uint64_t);
+#endif
 static int FileControl (stream_t *, int, va_list);
 
 /*****************************************************************************
@@ -252,6 +301,9 @@ int FileOpen( vlc_object_t *p_this )
     p_access->pf_control = FileControl;
     p_access->p_sys = p_sys;
     p_sys->fd = fd;
+#ifdef HAVE_LINUX_IO_URING_H
+    p_sys->uring = NULL;
+#endif
 
     if (S_ISREG (st.st_mode) || S_ISBLK (st.st_mode))
     {
@@ -270,6 +322,40 @@ int FileOpen( vlc_object_t *p_this )
             fcntl (fd, F_RDAHEAD, 0);
         else
             fcntl (fd, F_RDAHEAD, 1);
+#endif
+#ifdef HAVE_LINUX_IO_URING_H
+        /* Keep several reads in flight without a dedicated thread. */
+        if (var_InheritBool (p_access, "file-uring"))
+        {
+            unsigned depth = var_InheritInteger (p_access, "file-uring-depth");
+
+            p_sys->uring = FileUringNew (p_this, fd, depth);
+        }
+        if (p_sys->uring != NULL)
+        {
+            msg_Dbg (p_access, "using asynchronous reads");
+            p_access->pf_read = NULL;
+            p_access->pf_block = BlockUring;
+            p_access->pf_seek = UringSeek;
+        }
+#endif
+#ifdef HAVE_MMAP
+        /* Local regular files can be handed out as memory mappings, saving
+         * the copy from the page cache into a freshly allocated block. */
+        if (p_access->pf_block == NULL && S_ISREG (st.st_mode) && !IsRemote(fd, p_access->psz_filepath)
+         && var_InheritBool (p_access, "file-mmap"))
+        {
+            if (CannotShrink (fd))
+            {
+                msg_Dbg (p_access, "using memory-mapped reads");
+                p_access->pf_read = NULL;
+                p_access->pf_block = BlockMap;
+                p_access->pf_seek = MapSeek;
+                p_sys->offset = 0;
+            }
+            else
+                msg_Dbg (p_access, "file may be truncated, not mapping it");
+        }
 #endif
     }
     else
@@ -292,7 +378,7 @@ void FileClose (vlc_object_t * p_this)
 {
     stream_t     *p_access = (stream_t*)p_this;
 
-    if (p_access->pf_read == NULL)
+    if (p_access->pf_readdir != NULL)
     {
         DirClose (p_this);
         return;
@@ -300,6 +386,10 @@ void FileClose (vlc_object_t * p_this)
 
     access_sys_t *p_sys = p_access->p_sys;
 
+#ifdef HAVE_LINUX_IO_URING_H
+    if (p_sys->uring != NULL)
+        FileUringDelete (p_sys->uring);
+#endif
     vlc_close (p_sys->fd);
 }
 
@@ -338,6 +428,98 @@ static int FileSeek (stream_t *p_access, uint64_t i_pos)
     return VLC_SUCCESS;
 }
 
+#ifdef HAVE_MMAP
+/*****************************************************************************
+ * BlockMap: return the next window of the file as a memory-mapped block
+ *****************************************************************************/
+static block_t *BlockMap (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *sys = p_access->p_sys;
+    struct stat st;
+
+    /* Only ever map what the file contains right now, so that a file
+     * growing while it is being read is followed. */
+    if (fstat (sys->fd, &st))
+    {
+        msg_Err (p_access, "read error: %s", vlc_strerror_c(errno));
+        return NULL;
+    }
+
+    if ((uint64_t)st.st_size <= sys->offset)
+    {
+        *eof = true;
+        return NULL;
+    }
+
+    size_t length = FILE_MMAP_SIZE;
+    if ((uint64_t)st.st_size - sys->offset < length)
+        length = st.st_size - sys->offset;
+
+    size_t skew = sys->offset % sysconf (_SC_PAGESIZE);
+    void *addr = mmap (NULL, skew + length, PROT_READ, MAP_SHARED, sys->fd,
+                       sys->offset - skew);
+    block_t *block;
+
+    if (addr != MAP_FAILED)
+    {
+#ifdef POSIX_MADV_WILLNEED
+        posix_madvise (addr, skew + length, POSIX_MADV_WILLNEED);
+#endif
+        /* The block owns the whole mapping and unmaps it when released. */
+        block = block_mmap_Alloc (addr, skew + length);
+        if (unlikely(block == NULL))
+            return NULL;
+        block->p_buffer += skew;
+        block->i_buffer -= skew;
+    }
+    else
+    {   /* Some file systems cannot be mapped: fall back to reading. */
+        block = block_Alloc (length);
+        if (unlikely(block == NULL))
+            return NULL;
+
+        ssize_t val = pread (sys->fd, block->p_buffer, length, sys->offset);
+        if (val <= 0)
+        {
+            if (val == 0)
+                *eof = true;
+            else
+                msg_Err (p_access, "read error: %s", vlc_strerror_c(errno));
+            block_Release (block);
+            return NULL;
+        }
+        block->i_buffer = val;
+    }
+
+    sys->offset += block->i_buffer;
+    return block;
+}
+
+static int MapSeek (stream_t *p_access, uint64_t i_pos)
+{
+    access_sys_t *sys = p_access->p_sys;
+
+    sys->offset = i_pos;
+    return VLC_SUCCESS;
+}
+#endif
+
+#ifdef HAVE_LINUX_IO_URING_H
+static block_t *BlockUring (stream_t *p_access, bool *restrict eof)
+{
+    access_sys_t *sys = p_access->p_sys;
+
+    return FileUringBlock (sys->uring, eof);
+}
+
+static int UringSeek (stream_t *p_access, uint64_t i_pos)
+{
+    access_sys_t *sys = p_access->p_sys;
+
+    return FileUringSeek (sys->uring, i_pos) ? VLC_EGENERIC : VLC_SUCCESS;
+}
+#endif
+
 /*****************************************************************************
  * Control:
  *****************************************************************************/
@@ -38,6 +38,24 @@ vlc_module_begin ()
     add_shortcut( "file", "fd", "stream" )
     set_callbacks( FileOpen, FileClose )
 
+    add_bool("file-mmap", false, N_("Memory-map local files"),
+             N_("Read local regular files through memory mappings, handing "
+                "the data to demuxers without intermediate copies. "
+                "Only files that cannot be truncated while they are being "
+                "read are mapped, i.e. files on read-only file systems and "
+                "memory files sealed against shrinking: truncating a mapped "
+                "file would crash the player. Other files are read "
+                "normally."))
+#ifdef HAVE_LINUX_IO_URING_H
+    add_bool("file-uring", false, N_("Asynchronous file reads"),
+             N_("Read local files through io_uring, keeping several reads "
+                "in flight ahead of the current position."))
+    add_integer_with_range("file-uring-depth", 8, 1, 64,
+                           N_("Asynchronous reads in flight"),
+                           N_("Number of reads queued ahead of the current "
+                              "position when reading through io_uring."))
+#endif
+
     add_submodule()
     set_section( N_("Directory" ), NULL )
     set_capability( "access", 55 )
@@ -50,5 +68,10 @@ vlc_module_begin ()
 
     add_bool("list-special-files", false, N_("List special files"),
              N_("Include devices and pipes when listing directories"))
+    add_integer_with_range("directory-stat-threads", 4, 1, 32,
+                           N_("Metadata threads"),
+                           N_("Number of threads fetching the size and date "
+                              "of directory entries, to hide the latency of "
+                              "network file systems."))
     add_obsolete_string("directory-sort") /* since 3.0.0 */
 vlc_module_end ()
@@ -24,7 +24,11 @@
 
 #include <assert.h>
 #include <vlc_common.h>
+#include <vlc_interface.h>
+#include <vlc_list.h>
 #include <vlc_network.h>
+#include <vlc_strings.h>
+#include <vlc_threads.h>
 #include <vlc_tls.h>
 #include <vlc_url.h>
 #include "transport.h"
@@ -96,42 +100,291 @@ static char *vlc_http_proxy_find(const char *hostname, unsigned port,
 }
 
 
+/*
+ * Connections are pooled per LibVLC instance, so that inputs fetching from
+ * the same origin share them: HTTP/2 connections are used by several managers
+ * at once, and HTTP/1.x connections are handed over to a new manager once
+ * their previous manager is gone. The pool also holds the TLS credentials,
+ * so that certificates are loaded, and TLS sessions resumed, only once.
+ *
+ * The pool lives as long as the LibVLC instance, so that successive inputs
+ * reuse connections and resume TLS sessions. It is destroyed when the
+ * instance is cleaned up, after all managers are gone.
+ */
+
+/** Maximum number of idle HTTP/1.x connections kept per instance */
+#define VLC_HTTP_POOL_MAX_IDLE 8
+
+struct vlc_http_pool_conn
+{
+    struct vlc_list node;
+    struct vlc_http_conn *conn;
+    bool https;
+    bool shared; /**< Multiplexed (HTTP/2), can have several users */
+    bool dead; /**< Failed, no longer in the pool */
+    unsigned users;
+    unsigned port;
+    char host[];
+};
+
+struct vlc_http_pool
+{
+    struct vlc_list node;
+    libvlc_int_t *instance;
+
+    vlc_mutex_t lock;
+    struct vlc_list conns; /**< Most recently used first */
+    vlc_tls_client_t *creds;
+
+    /* Connections may outlive the manager that created them: they log to
+     * the instance rather than to any input. */
+    struct vlc_logger *logger;
+};
+
 struct vlc_http_mgr
 {
     struct vlc_logger *logger;
     vlc_object_t *obj;
-    vlc_tls_client_t *creds;
+    struct vlc_http_pool *pool;
     struct vlc_http_cookie_jar_t *jar;
-    struct vlc_http_conn *conn;
+    struct vlc_http_pool_conn *conn;
 };
 
-static struct vlc_http_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
-                                               const char *host, unsigned port)
+static vlc_mutex_t pools_lock = VLC_STATIC_MUTEX;
+static struct vlc_list pools = { &pools, &pools };
+
+static void vlc_http_pool_destroy(void *data)
 {
-    (void) host; (void) port;
-    return mgr->conn;
+    struct vlc_http_pool *pool = data;
+    struct vlc_http_pool_conn *entry;
+
+    vlc_mutex_lock(&pools_lock);
+    vlc_list_remove(&pool->node);
+    vlc_mutex_unlock(&pools_lock);
+
+    vlc_list_foreach(entry, &pool->conns, node)
+    {
+        assert(entry->users == 0);
+        vlc_http_conn_release(entry->conn);
+        free(entry);
+    }
+
+    if (pool->creds != NULL)
+        vlc_tls_ClientDelete(pool->creds);
+    if (pool->logger != NULL)
+        vlc_LogDestroy(pool->logger);
+    free(pool);
 }
 
-static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
-                                 struct vlc_http_conn *conn)
+static struct vlc_http_pool *vlc_http_pool_get(vlc_object_t *obj)
 {
-    assert(mgr->conn == conn);
+    libvlc_int_t *instance = vlc_object_instance(obj);
+    struct vlc_http_pool *pool;
+
+    vlc_mutex_lock(&pools_lock);
+    vlc_list_foreach(pool, &pools, node)
+        if (pool->instance == instance)
+            goto out;
+
+    pool = malloc(sizeof (*pool));
+    if (likely(pool != NULL))
+    {
+        pool->instance = instance;
+        vlc_mutex_init(&pool->lock);
+        vlc_list_init(&pool->conns);
+        pool->creds = NULL;
+        pool->logger = vlc_LogHeaderCreate(VLC_OBJECT(instance)->logger,
+                                           "http");
+
+        if (libvlc_AddCleanup(instance, vlc_http_pool_destroy, pool))
+        {
+            if (pool->logger != NULL)
+                vlc_LogDestroy(pool->logger);
+            free(pool);
+            pool = NULL;
+        }
+        else
+            vlc_list_append(&pool->node, &pools);
+    }
+out:
+    vlc_mutex_unlock(&pools_lock);
+    return pool;
+}
+
+static bool vlc_http_pool_match(const struct vlc_http_pool_conn *entry,
+                                bool https, const char *host, unsigned port)
+{
+    return entry->https == https && entry->port == port
+        && !vlc_ascii_strcasecmp(entry->host, host);
+}
+
+/**
+ * Stops using the current connection of a manager.
+ *
+ * The connection is left in the pool for reuse, unless it failed.
+ */
+static void vlc_http_mgr_put(struct vlc_http_mgr *mgr)
+{
+    struct vlc_http_pool *pool = mgr->pool;
+    struct vlc_http_pool_conn *entry = mgr->conn, *evicted = NULL;
+
+    if (entry == NULL)
+        return;
+
     mgr->conn = NULL;
 
-    vlc_http_conn_release(conn);
+    vlc_mutex_lock(&pool->lock);
+    assert(entry->users > 0);
+    entry->users--;
+
+    if (entry->dead)
+    {
+        if (entry->users > 0)
+            entry = NULL; /* the last user will close it */
+    }
+    else
+    {
+        unsigned idle = 0;
+        struct vlc_http_pool_conn *e;
+
+        /* Keep recently used connections first, evict the oldest idle. */
+        vlc_list_remove(&entry->node);
+        vlc_list_prepend(&entry->node, &pool->conns);
+        entry = NULL;
+
+        vlc_list_foreach(e, &pool->conns, node)
+            if (e->users == 0 && ++idle > VLC_HTTP_POOL_MAX_IDLE)
+            {
+                vlc_list_remove(&e->node);
+                evicted = e;
+                break;
+            }
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (entry == NULL)
+        entry = evicted;
+    if (entry != NULL)
+    {
+        vlc_http_conn_release(entry->conn);
+        free(entry);
+    }
+}
+
+static void vlc_http_mgr_release(struct vlc_http_mgr *mgr,
+                                 struct vlc_http_pool_conn *entry)
+{
+    struct vlc_http_pool *pool = mgr->pool;
+
+    assert(mgr->conn == entry);
+
+    /* Get the connection out of the pool, so no one else picks it. */
+    vlc_mutex_lock(&pool->lock);
+    if (!entry->dead)
+    {
+        entry->dead = true;
+        vlc_list_remove(&entry->node);
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    vlc_http_mgr_put(mgr);
+}
+
+/**
+ * Stops using the current connection of a manager, before switching to
+ * another one. A non-multiplexed connection may still carry a stream of
+ * the manager, so it cannot be handed over to anyone else.
+ */
+static void vlc_http_mgr_drop(struct vlc_http_mgr *mgr)
+{
+    if (mgr->conn == NULL)
+        return;
+    if (mgr->conn->shared)
+        vlc_http_mgr_put(mgr);
+    else
+        vlc_http_mgr_release(mgr, mgr->conn);
 }
 
 static
-struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
+struct vlc_http_pool_conn *vlc_http_mgr_find(struct vlc_http_mgr *mgr,
+                                             bool https, const char *host,
+                                             unsigned port)
+{
+    struct vlc_http_pool *pool = mgr->pool;
+    struct vlc_http_pool_conn *entry = mgr->conn, *found = NULL;
+
+    if (entry != NULL && vlc_http_pool_match(entry, https, host, port))
+        return entry;
+
+    vlc_mutex_lock(&pool->lock);
+    vlc_list_foreach(entry, &pool->conns, node)
+        if ((entry->shared || entry->users == 0)
+         && vlc_http_pool_match(entry, https, host, port))
+        {
+            entry->users++;
+            found = entry;
+            break;
+        }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (found != NULL)
+    {
+        vlc_http_mgr_drop(mgr);
+        mgr->conn = found;
+        vlc_http_dbg(mgr->logger, "reusing %s connection to %s",
+                     found->shared ? "shared" : "idle", host);
+    }
+    return found;
+}
+
+/**
+ * Adds a new connection to the pool, as the current one of a manager.
+ */
+static int vlc_http_mgr_add(struct vlc_http_mgr *mgr, bool https,
+                            const char *host, unsigned port,
+                            struct vlc_http_conn *conn, bool shared)
+{
+    struct vlc_http_pool *pool = mgr->pool;
+    size_t len = strlen(host) + 1;
+    struct vlc_http_pool_conn *entry = malloc(sizeof (*entry) + len);
+
+    if (unlikely(entry == NULL))
+    {
+        vlc_http_conn_release(conn);
+        return -1;
+    }
+
+    entry->conn = conn;
+    entry->https = https;
+    entry->shared = shared;
+    entry->dead = false;
+    entry->users = 1;
+    entry->port = port;
+    memcpy(entry->host, host, len);
+
+    vlc_http_mgr_drop(mgr);
+
+    vlc_mutex_lock(&pool->lock);
+    vlc_list_prepend(&entry->node, &pool->conns);
+    vlc_mutex_unlock(&pool->lock);
+
+    mgr->conn = entry;
+    return 0;
+}
+
+static
+struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr, bool https,
                                         const char *host, unsigned port,
                                         const struct vlc_http_msg *req,
                                         bool payload)
 {
-    struct vlc_http_conn *conn = vlc_http_mgr_find(mgr, host, port);
-    if (conn == NULL)
+    struct vlc_http_pool_conn *entry = vlc_http_mgr_find(mgr, https, host,
+                                                         port);
+    if (entry == NULL)
         return NULL;
 
-    struct vlc_http_stream *stream = vlc_http_stream_open(conn, req, payload);
+    struct vlc_http_stream *stream = vlc_http_stream_open(entry->conn, req,
+                                                          payload);
     if (stream != NULL)
     {
         struct vlc_http_msg *m = vlc_http_msg_get_initial(stream);
@@ -139,10 +392,41 @@ struct vlc_http_msg *vlc_http_mgr_reuse(struct vlc_http_mgr *mgr,
             return m;
     }
     /* Get rid of closing or reset connection */
-    vlc_http_mgr_release(mgr, conn);
+    vlc_http_mgr_release(mgr, entry);
     return NULL;
 }
 
+static vlc_tls_client_t *vlc_http_mgr_get_creds(struct vlc_http_mgr *mgr)
+{
+    struct vlc_http_pool *pool = mgr->pool;
+    vlc_tls_client_t *creds;
+
+    vlc_mutex_lock(&pool->lock);
+    creds = pool->creds;
+    vlc_mutex_unlock(&pool->lock);
+
+    if (creds != NULL)
+        return creds;
+
+    /* First TLS connection: load x509 credentials. They are shared by all
+     * managers of the instance, hence not bound to the calling object. */
+    creds = vlc_tls_ClientCreate(VLC_OBJECT(pool->instance));
+    if (creds == NULL)
+        return NULL;
+
+    vlc_mutex_lock(&pool->lock);
+    if (pool->creds == NULL)
+    {
+        pool->creds = creds;
+        creds = NULL;
+    }
+    vlc_mutex_unlock(&pool->lock);
+
+    if (creds != NULL) /* Lost the race against another manager */
+        vlc_tls_ClientDelete(creds);
+    return pool->creds;
+}
+
 static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
                                               const char *host, unsigned port,
                                               const struct vlc_http_msg *req,
@@ -151,37 +435,30 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
     vlc_tls_t *tls;
     bool http2 = true;
 
-    if (mgr->creds == NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTP to HTTPS not implemented */
-
-    if (mgr->creds == NULL)
-    {   /* First TLS connection: load x509 credentials */
-        mgr->creds = vlc_tls_ClientCreate(mgr->obj);
-        if (mgr->creds == NULL)
-            return NULL;
-    }
-
     if (idempotent)
     {   /* If the request is idempotent, try to reuse an existing connection.
          * Otherwise, it is possible but unadvisable as we would not know if
          * the nonidempotent request was processed if the connection fails
          * before the response is received.
          */
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, true, host, port,
+                                                       req, payload);
         if (resp != NULL)
             return resp; /* existing connection reused */
     }
 
+    vlc_tls_client_t *creds = vlc_http_mgr_get_creds(mgr);
+    if (creds == NULL)
+        return NULL;
+
     char *proxy = vlc_http_proxy_find(host, port, true);
     if (proxy != NULL)
     {
-        tls = vlc_https_connect_proxy(mgr->creds, mgr->creds,
-                                      host, port, &http2, proxy);
+        tls = vlc_https_connect_proxy(creds, creds, host, port, &http2, proxy);
         free(proxy);
     }
     else
-        tls = vlc_https_connect(mgr->creds, host, port, &http2);
+        tls = vlc_https_connect(creds, host, port, &http2);
 
     if (tls == NULL)
         return NULL;
@@ -196,9 +473,9 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
      * NOTE: We do not enforce TLS version 1.2 for HTTP 2.0 explicitly.
      */
     if (http2)
-        conn = vlc_h2_conn_create(mgr->logger, tls);
+        conn = vlc_h2_conn_create(mgr->pool->logger, tls);
     else
-        conn = vlc_h1_conn_create(mgr->logger, tls, false);
+        conn = vlc_h1_conn_create(mgr->pool->logger, tls, false);
 
     if (unlikely(conn == NULL))
     {
@@ -206,11 +483,10 @@ static struct vlc_http_msg *vlc_https_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
+    if (vlc_http_mgr_add(mgr, true, host, port, conn, http2))
+        return NULL;
 
-    mgr->conn = conn;
-    return vlc_http_mgr_reuse(mgr, host, port, req, payload);
+    return vlc_http_mgr_reuse(mgr, true, host, port, req, payload);
 }
 
 static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
@@ -218,13 +494,10 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
                                              const struct vlc_http_msg *req,
                                              bool idempotent, bool payload)
 {
-    if (mgr->creds != NULL && mgr->conn != NULL)
-        return NULL; /* switch from HTTPS to HTTP not implemented */
-
     if (idempotent)
     {
-        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, host, port, req,
-                                                       payload);
+        struct vlc_http_msg *resp = vlc_http_mgr_reuse(mgr, false, host, port,
+                                                       req, payload);
         if (resp != NULL)
             return resp;
     }
@@ -241,7 +514,7 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         free(proxy);
 
         if (url.psz_host != NULL)
-            stream = vlc_h1_request(mgr->logger, url.psz_host,
+            stream = vlc_h1_request(mgr->pool->logger, url.psz_host,
                                     url.i_port ? url.i_port : 80, true, req,
                                     idempotent, payload, &conn);
         else
@@ -250,8 +523,8 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         vlc_UrlClean(&url);
     }
     else
-        stream = vlc_h1_request(mgr->logger, host, port ? port : 80, false,
-                                req, idempotent, payload, &conn);
+        stream = vlc_h1_request(mgr->pool->logger, host, port ? port : 80,
+                                false, req, idempotent, payload, &conn);
 
     if (stream == NULL)
         return NULL;
@@ -263,10 +536,11 @@ static struct vlc_http_msg *vlc_http_request(struct vlc_http_mgr *mgr,
         return NULL;
     }
 
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-
-    mgr->conn = conn;
+    if (vlc_http_mgr_add(mgr, false, host, port, conn, false))
+    {   /* The connection is gone: so is the response. */
+        vlc_http_msg_destroy(resp);
+        return NULL;
+    }
     return resp;
 }
 
@@ -294,9 +568,15 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
     if (unlikely(mgr == NULL))
         return NULL;
 
+    mgr->pool = vlc_http_pool_get(obj);
+    if (unlikely(mgr->pool == NULL))
+    {
+        free(mgr);
+        return NULL;
+    }
+
     mgr->logger = obj->logger;
     mgr->obj = obj;
-    mgr->creds = NULL;
     mgr->jar = jar;
     mgr->conn = NULL;
     return mgr;
@@ -304,9 +584,6 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
 
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr)
 {
-    if (mgr->conn != NULL)
-        vlc_http_mgr_release(mgr, mgr->conn);
-    if (mgr->creds != NULL)
-        vlc_tls_ClientDelete(mgr->creds);
+    vlc_http_mgr_put(mgr);
     free(mgr);
 }
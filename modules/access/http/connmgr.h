@@ -61,6 +61,8 @@ struct vlc_http_cookie_jar_t *vlc_http_mgr_get_jar(struct vlc_http_mgr *);
  * Creates an HTTP connection manager
  *
  * Allocates an HTTP client connections manager.
+ * Connections and TLS credentials are shared by all the managers of a LibVLC
+ * instance.
  *
  * @param obj parent VLC object
  * @param jar HTTP cookies jar (NULL to disable cookies)
@@ -72,7 +74,8 @@ struct vlc_http_mgr *vlc_http_mgr_create(vlc_object_t *obj,
  * Destroys an HTTP connection manager
  *
  * Deallocates an HTTP client connections manager created by
- * vlc_http_msg_destroy(). Any remaining connection is closed and destroyed.
+ * vlc_http_mgr_create(). Any remaining connection is returned to the pool of
+ * the LibVLC instance for reuse; it is closed when the instance is cleaned up.
  */
 void vlc_http_mgr_destroy(struct vlc_http_mgr *mgr);
 
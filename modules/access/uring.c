@@ -0,0 +1,616 @@
+/*****************************************************************************
+ * uring.c: asynchronous file reads through Linux io_uring
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+#include <vlc_common.h>
+#include <vlc_block.h>
+#include <vlc_fs.h>
+#include <vlc_interrupt.h>
+#include "uring.h"
+
+/* Size of each read, and of each registered buffer */
+#define URING_READ_SIZE (256 << 10)
+/* user_data of cancellation requests, reads use their queue index */
+#define URING_CANCEL_TAG UINT64_MAX
+
+/* Registered buffers, shared by the reader and the blocks it returned */
+struct file_uring_pool
+{
+    vlc_mutex_t lock;
+    atomic_uint refs;
+    unsigned free_count;
+    uint8_t *base;
+    unsigned free[];
+};
+
+struct file_uring_block
+{
+    block_t self;
+    struct file_uring_pool *pool;
+    unsigned slot;
+};
+
+struct file_uring_req
+{
+    block_t *block; /* destination if not reading into a registered buffer */
+    int slot; /* registered buffer index, or -1 */
+    int result;
+    bool pending;
+    uint64_t offset;
+};
+
+struct file_uring
+{
+    vlc_object_t *obj;
+    int fd;
+    int ring_fd;
+
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;
+    size_t cq_map_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    unsigned to_submit;
+
+    struct file_uring_pool *pool;
+
+    unsigned depth;
+    unsigned head; /* oldest queued read */
+    unsigned count; /* queued reads, completed or not */
+    unsigned cancels; /* cancellations in flight */
+    bool failed; /* reads may still be in flight, nothing can be queued */
+    uint64_t offset; /* offset of the next read to queue */
+    struct file_uring_req reqs[];
+};
+
+static unsigned load_acquire(const unsigned *p)
+{
+    return atomic_load_explicit((const _Atomic unsigned *)p,
+                                memory_order_acquire);
+}
+
+static void store_release(unsigned *p, unsigned v)
+{
+    atomic_store_explicit((_Atomic unsigned *)p, v, memory_order_release);
+}
+
+static void PoolRelease(struct file_uring_pool *pool)
+{
+    if (atomic_fetch_sub_explicit(&pool->refs, 1, memory_order_acq_rel) != 1)
+        return;
+
+    free(pool->base);
+    free(pool);
+}
+
+static int PoolGet(struct file_uring_pool *pool)
+{
+    int slot = -1;
+
+    vlc_mutex_lock(&pool->lock);
+    if (pool->free_count > 0)
+        slot = pool->free[--pool->free_count];
+    vlc_mutex_unlock(&pool->lock);
+    return slot;
+}
+
+static void PoolPut(struct file_uring_pool *pool, unsigned slot)
+{
+    vlc_mutex_lock(&pool->lock);
+    pool->free[pool->free_count++] = slot;
+    vlc_mutex_unlock(&pool->lock);
+}
+
+static void PoolBlockRelease(block_t *block)
+{
+    struct file_uring_block *b =
+        container_of(block, struct file_uring_block, self);
+
+    PoolPut(b->pool, b->slot);
+    PoolRelease(b->pool);
+    free(b);
+}
+
+static const struct vlc_block_callbacks pool_block_cbs =
+{
+    PoolBlockRelease,
+};
+
+static struct file_uring_pool *PoolNew(int ring_fd, unsigned count)
+{
+    struct file_uring_pool *pool =
+        malloc(sizeof (*pool) + count * sizeof (pool->free[0]));
+    if (unlikely(pool == NULL))
+        return NULL;
+
+    pool->base = aligned_alloc(4096, (size_t)count * URING_READ_SIZE);
+    if (unlikely(pool->base == NULL))
+    {
+        free(pool);
+        return NULL;
+    }
+
+    struct iovec *iov = vlc_alloc(count, sizeof (*iov));
+    if (unlikely(iov == NULL))
+    {
+        free(pool->base);
+        free(pool);
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        iov[i].iov_base = pool->base + (size_t)i * URING_READ_SIZE;
+        iov[i].iov_len = URING_READ_SIZE;
+        pool->free[i] = count - 1 - i;
+    }
+
+    /* This fails if the locked memory limit is too low. */
+    int val = syscall(__NR_io_uring_register, ring_fd,
+                      IORING_REGISTER_BUFFERS, iov, count);
+    free(iov);
+    if (val)
+    {
+        free(pool->base);
+        free(pool);
+        return NULL;
+    }
+
+    vlc_mutex_init(&pool->lock);
+    atomic_init(&pool->refs, 1);
+    pool->free_count = count;
+    return pool;
+}
+
+static struct io_uring_sqe *GetSQE(file_uring_t *u)
+{
+    unsigned tail = *u->sq_tail;
+    unsigned index = tail & u->sq_mask;
+
+    /* At most depth reads and depth cancellations are ever queued. */
+    assert(tail - load_acquire(u->sq_head) < u->sq_entries);
+
+    struct io_uring_sqe *sqe = &u->sqes[index];
+    memset(sqe, 0, sizeof (*sqe));
+    u->sq_array[index] = index;
+    return sqe;
+}
+
+static void PushSQE(file_uring_t *u)
+{
+    store_release(u->sq_tail, *u->sq_tail + 1);
+    u->to_submit++;
+}
+
+static int Enter(file_uring_t *u, unsigned min_complete)
+{
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+
+    for (;;)
+    {
+        int val = syscall(__NR_io_uring_enter, u->ring_fd, u->to_submit,
+                          min_complete, flags, NULL, 0);
+        if (val >= 0)
+        {
+            assert((unsigned)val <= u->to_submit);
+            u->to_submit -= val;
+            return 0;
+        }
+        if (errno != EINTR)
+        {
+            msg_Err(u->obj, "io_uring error: %s", vlc_strerror_c(errno));
+            return -1;
+        }
+    }
+}
+
+static void Reap(file_uring_t *u)
+{
+    unsigned head = *u->cq_head;
+    unsigned tail = load_acquire(u->cq_tail);
+
+    while (head != tail)
+    {
+        const struct io_uring_cqe *cqe = &u->cqes[head & u->cq_mask];
+
+        if (cqe->user_data == URING_CANCEL_TAG)
+        {
+            assert(u->cancels > 0);
+            u->cancels--;
+        }
+        else
+        {
+            struct file_uring_req *req = &u->reqs[cqe->user_data];
+
+            assert(req->pending);
+            req->result = cqe->res;
+            req->pending = false;
+        }
+        head++;
+    }
+    store_release(u->cq_head, head);
+}
+
+static void Queue(file_uring_t *u)
+{
+    while (u->count < u->depth)
+    {
+        unsigned index = (u->head + u->count) % u->depth;
+        struct file_uring_req *req = &u->reqs[index];
+        struct io_uring_sqe *sqe;
+
+        req->slot = (u->pool != NULL) ? PoolGet(u->pool) : -1;
+        if (req->slot >= 0)
+        {
+            sqe = GetSQE(u);
+            sqe->opcode = IORING_OP_READ_FIXED;
+            sqe->addr = (uintptr_t)(u->pool->base
+                                    + (size_t)req->slot * URING_READ_SIZE);
+            sqe->buf_index = req->slot;
+            req->block = NULL;
+        }
+        else
+        {   /* All registered buffers are held downstream */
+            req->block = block_Alloc(URING_READ_SIZE);
+            if (unlikely(req->block == NULL))
+                break;
+
+            sqe = GetSQE(u);
+            sqe->opcode = IORING_OP_READ;
+            sqe->addr = (uintptr_t)req->block->p_buffer;
+        }
+
+        sqe->fd = u->fd;
+        sqe->off = u->offset;
+        sqe->len = URING_READ_SIZE;
+        sqe->user_data = index;
+        PushSQE(u);
+
+        req->offset = u->offset;
+        req->pending = true;
+        u->offset += URING_READ_SIZE;
+        u->count++;
+    }
+}
+
+static void Dequeue(file_uring_t *u)
+{
+    assert(u->count > 0);
+    u->head = (u->head + 1) % u->depth;
+    u->count--;
+}
+
+/**
+ * Gives up on the queued reads after the kernel could not be waited for.
+ *
+ * The buffers of the reads still in flight are leaked, since the kernel may
+ * still write into them, and the reader cannot be used anymore.
+ */
+static void Abandon(file_uring_t *u)
+{
+    bool pool_leaked = false;
+
+    while (u->count > 0)
+    {
+        struct file_uring_req *req = &u->reqs[u->head];
+
+        if (!req->pending)
+        {
+            if (req->block != NULL)
+                block_Release(req->block);
+            else
+                PoolPut(u->pool, req->slot);
+        }
+        else if (req->block == NULL && !pool_leaked)
+        {   /* Keep the registered buffers allocated */
+            atomic_fetch_add_explicit(&u->pool->refs, 1, memory_order_relaxed);
+            pool_leaked = true;
+        }
+        Dequeue(u);
+    }
+    u->head = 0;
+    u->failed = true;
+    msg_Err(u->obj, "cannot cancel the pending reads, giving up");
+}
+
+/**
+ * Cancels all queued reads, waits for the kernel to let go of their buffers
+ * and discards them.
+ */
+static int Drain(file_uring_t *u)
+{
+    for (unsigned i = 0; i < u->count; i++)
+    {
+        unsigned index = (u->head + i) % u->depth;
+
+        if (!u->reqs[index].pending)
+            continue;
+
+        struct io_uring_sqe *sqe = GetSQE(u);
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = index;
+        sqe->user_data = URING_CANCEL_TAG;
+        PushSQE(u);
+        u->cancels++;
+    }
+
+    for (;;)
+    {
+        bool pending = u->cancels > 0;
+
+        Reap(u);
+        for (unsigned i = 0; i < u->count && !pending; i++)
+            pending = u->reqs[(u->head + i) % u->depth].pending;
+        if (!pending)
+            break;
+        /* Reads on local files cannot block for long: no interruption. */
+        if (Enter(u, 1))
+        {
+            Abandon(u);
+            return -1;
+        }
+    }
+
+    while (u->count > 0)
+    {
+        struct file_uring_req *req = &u->reqs[u->head];
+
+        if (req->block != NULL)
+            block_Release(req->block);
+        else
+            PoolPut(u->pool, req->slot);
+        Dequeue(u);
+    }
+    u->head = 0;
+    return 0;
+}
+
+block_t *FileUringBlock(file_uring_t *u, bool *restrict eof)
+{
+    if (u->failed)
+    {
+        *eof = true;
+        return NULL;
+    }
+
+    Queue(u);
+
+    if (u->count == 0)
+        return NULL; /* out of memory */
+    if (u->to_submit > 0 && Enter(u, 0))
+        return NULL;
+
+    struct file_uring_req *req = &u->reqs[u->head];
+
+    for (;;)
+    {
+        Reap(u);
+        if (!req->pending)
+            break;
+
+        struct pollfd ufd = { .fd = u->ring_fd, .events = POLLIN };
+        if (vlc_poll_i11e(&ufd, 1, -1) < 0)
+            return NULL;
+    }
+
+    uint64_t offset = req->offset;
+    int val = req->result;
+
+    if (val <= 0)
+    {
+        if (val != -EINTR && val != -EAGAIN)
+        {
+            if (val < 0)
+                msg_Err(u->obj, "read error: %s", vlc_strerror_c(-val));
+            *eof = true;
+        }
+        /* Drop the read-ahead, and try again from here next time, in case
+         * the file grows. */
+        if (Drain(u))
+            *eof = true;
+        u->offset = offset;
+        return NULL;
+    }
+
+    block_t *block;
+
+    if (req->block != NULL)
+    {
+        block = req->block;
+        block->i_buffer = val;
+    }
+    else
+    {
+        struct file_uring_block *b = malloc(sizeof (*b));
+        if (unlikely(b == NULL))
+            return NULL; /* retry next time */
+
+        block_Init(&b->self, &pool_block_cbs,
+                   u->pool->base + (size_t)req->slot * URING_READ_SIZE, val);
+        b->pool = u->pool;
+        b->slot = req->slot;
+        atomic_fetch_add_explicit(&u->pool->refs, 1, memory_order_relaxed);
+        block = &b->self;
+    }
+    Dequeue(u);
+
+    if (val < URING_READ_SIZE)
+    {   /* Short read: the reads queued after this one are misaligned.
+         * On failure, the next call reports the end of the stream. */
+        Drain(u);
+        u->offset = offset + val;
+    }
+    return block;
+}
+
+int FileUringSeek(file_uring_t *u, uint64_t offset)
+{
+    if (u->failed || Drain(u))
+        return -1;
+    u->offset = offset;
+    return 0;
+}
+
+file_uring_t *FileUringNew(vlc_object_t *obj, int fd, unsigned depth)
+{
+    file_uring_t *u = malloc(sizeof (*u) + depth * sizeof (u->reqs[0]));
+    if (unlikely(u == NULL))
+        return NULL;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof (params));
+
+    /* Room for one read and one cancellation per queued request */
+    u->ring_fd = syscall(__NR_io_uring_setup, 2 * depth, &params);
+    if (u->ring_fd == -1)
+    {
+        msg_Dbg(obj, "io_uring not available: %s", vlc_strerror_c(errno));
+        free(u);
+        return NULL;
+    }
+
+    /* IORING_OP_READ comes with the same kernel version as this flag. */
+    if (!(params.features & IORING_FEAT_RW_CUR_POS))
+    {
+        msg_Dbg(obj, "io_uring too old");
+        goto error;
+    }
+
+    u->sq_map_size = params.sq_off.array
+                   + params.sq_entries * sizeof (unsigned);
+    u->cq_map_size = params.cq_off.cqes
+                   + params.cq_entries * sizeof (struct io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (u->cq_map_size > u->sq_map_size)
+            u->sq_map_size = u->cq_map_size;
+        u->cq_map_size = 0;
+    }
+
+    u->sq_map = mmap(NULL, u->sq_map_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, u->ring_fd,
+                     IORING_OFF_SQ_RING);
+    if (u->sq_map == MAP_FAILED)
+        goto error;
+
+    if (u->cq_map_size > 0)
+    {
+        u->cq_map = mmap(NULL, u->cq_map_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, u->ring_fd,
+                         IORING_OFF_CQ_RING);
+        if (u->cq_map == MAP_FAILED)
+        {
+            munmap(u->sq_map, u->sq_map_size);
+            goto error;
+        }
+    }
+    else
+        u->cq_map = u->sq_map;
+
+    u->sqes_size = params.sq_entries * sizeof (struct io_uring_sqe);
+    u->sqes = mmap(NULL, u->sqes_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, u->ring_fd, IORING_OFF_SQES);
+    if (u->sqes == MAP_FAILED)
+    {
+        if (u->cq_map_size > 0)
+            munmap(u->cq_map, u->cq_map_size);
+        munmap(u->sq_map, u->sq_map_size);
+        goto error;
+    }
+
+    char *sq = u->sq_map, *cq = u->cq_map;
+
+    u->sq_head = (unsigned *)(sq + params.sq_off.head);
+    u->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    u->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    u->sq_entries = params.sq_entries;
+    u->sq_array = (unsigned *)(sq + params.sq_off.array);
+    u->cq_head = (unsigned *)(cq + params.cq_off.head);
+    u->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    u->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    u->to_submit = 0;
+
+    /* Twice as many buffers as reads, so that returned blocks can be held
+     * downstream while the queue is kept full. */
+    u->pool = PoolNew(u->ring_fd, 2 * depth);
+    if (u->pool == NULL)
+        msg_Dbg(obj, "cannot register io_uring buffers");
+
+    u->obj = obj;
+    u->fd = fd;
+    u->depth = depth;
+    u->head = 0;
+    u->count = 0;
+    u->cancels = 0;
+    u->failed = false;
+    u->offset = 0;
+    return u;
+
+error:
+    vlc_close(u->ring_fd);
+    free(u);
+    return NULL;
+}
+
+void FileUringDelete(file_uring_t *u)
+{
+    if (!u->failed)
+        Drain(u);
+
+    munmap(u->sqes, u->sqes_size);
+    if (u->cq_map_size > 0)
+        munmap(u->cq_map, u->cq_map_size);
+    munmap(u->sq_map, u->sq_map_size);
+    /* Closing the ring also unregisters the buffers. Those still held by
+     * blocks remain valid until the last one is released. */
+    vlc_close(u->ring_fd);
+
+    if (u->pool != NULL)
+        PoolRelease(u->pool);
+    free(u);
+}
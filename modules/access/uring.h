@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * uring.h: asynchronous file reads through Linux io_uring
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_ACCESS_URING_H
+#define VLC_ACCESS_URING_H
+
+/**
+ * Sequential reader keeping several reads of a file in flight.
+ *
+ * Reads are queued ahead of the current position on a private io_uring and
+ * completed blocks are returned in file order. Read buffers are registered
+ * with the kernel when possible and handed out without copies.
+ */
+typedef struct file_uring file_uring_t;
+
+/**
+ * Creates a reader for an open file descriptor.
+ *
+ * @param obj object used for logging
+ * @param fd file descriptor (not owned, must outlive the reader)
+ * @param depth number of reads to keep in flight
+ * @return the reader, or NULL if io_uring is not usable on this system
+ */
+file_uring_t *FileUringNew(vlc_object_t *obj, int fd, unsigned depth);
+
+/**
+ * Cancels outstanding reads and destroys the reader.
+ *
+ * Blocks already returned remain valid until released.
+ */
+void FileUringDelete(file_uring_t *);
+
+/**
+ * Returns the next block of the file, waiting for its read if needed.
+ *
+ * This function is interruptible (see vlc_interrupt_set()).
+ */
+block_t *FileUringBlock(file_uring_t *, bool *restrict eof);
+
+/**
+ * Cancels outstanding reads and restarts reading from the given offset.
+ *
+ * @return 0 on success, -1 if the outstanding reads could not be waited for
+ * (the reader then only reports the end of the stream)
+ */
+int FileUringSeek(file_uring_t *, uint64_t offset);
+
+#endif
@@ -0,0 +1,296 @@
+/*****************************************************************************
+ * biquad.c: second-order IIR filters for audio filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Filters use the transposed direct form II: each one keeps two state
+ * values, and the recursion of a filter only depends on its own state.
+ * Independent filters are laid out in groups of LANES, so that a group is
+ * computed with one vector operation per step: channels for a cascade
+ * (the stages of which depend on each other), and bands for a bank.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+
+#include "biquad.h"
+
+#define LANES 4
+
+#if defined __has_attribute
+# if __has_attribute(__vector_size__)
+#  define HAVE_VECTOR_FLOAT
+/* Compiled to SSE on x86 and to NEON on ARM */
+typedef float v4sf __attribute__((__vector_size__(LANES * sizeof (float))));
+# endif
+#endif
+
+static unsigned Groups(unsigned count)
+{
+    return (count + LANES - 1) / LANES;
+}
+
+/*****************************************************************************
+ * Cascade
+ *****************************************************************************/
+struct biquad_cascade
+{
+    unsigned stages;
+    unsigned channels;
+    struct biquad_coeffs *coeffs;
+    float *state; /**< z1 and z2 for each stage and group of channels */
+};
+
+biquad_cascade_t *biquad_cascade_New(unsigned stages, unsigned channels)
+{
+    biquad_cascade_t *bq = malloc(sizeof (*bq));
+    if (unlikely(bq == NULL))
+        return NULL;
+
+    bq->stages = stages;
+    bq->channels = channels;
+    bq->coeffs = calloc(stages, sizeof (*bq->coeffs));
+    bq->state = calloc(stages * Groups(channels) * 2 * LANES,
+                       sizeof (*bq->state));
+    if (unlikely(bq->coeffs == NULL || bq->state == NULL))
+    {
+        biquad_cascade_Delete(bq);
+        return NULL;
+    }
+
+    /* Pass-through until configured */
+    for (unsigned i = 0; i < stages; i++)
+        bq->coeffs[i].b0 = 1.f;
+    return bq;
+}
+
+void biquad_cascade_Delete(biquad_cascade_t *bq)
+{
+    free(bq->state);
+    free(bq->coeffs);
+    free(bq);
+}
+
+void biquad_cascade_Set(biquad_cascade_t *bq, unsigned stage,
+                        const struct biquad_coeffs *coeffs)
+{
+    assert(stage < bq->stages);
+    bq->coeffs[stage] = *coeffs;
+}
+
+void biquad_cascade_Reset(biquad_cascade_t *bq)
+{
+    memset(bq->state, 0, bq->stages * Groups(bq->channels) * 2 * LANES
+                         * sizeof (*bq->state));
+}
+
+void biquad_cascade_Process(biquad_cascade_t *bq, float *samples,
+                            size_t frames)
+{
+    const unsigned channels = bq->channels;
+    const unsigned groups = Groups(channels);
+
+    for (unsigned g = 0; g < groups; g++)
+    {
+        const unsigned first = g * LANES;
+        const size_t size = ((channels - first < LANES) ? channels - first
+                                                        : LANES)
+                          * sizeof (float);
+        float *s = samples + first;
+
+        for (size_t i = 0; i < frames; i++, s += channels)
+        {
+#ifdef HAVE_VECTOR_FLOAT
+            v4sf x = { 0 };
+
+            memcpy(&x, s, size);
+            for (unsigned j = 0; j < bq->stages; j++)
+            {
+                const struct biquad_coeffs *k = &bq->coeffs[j];
+                float *z = bq->state + (j * groups + g) * 2 * LANES;
+                v4sf z1, z2, y;
+
+                memcpy(&z1, z, sizeof (z1));
+                memcpy(&z2, z + LANES, sizeof (z2));
+                y = k->b0 * x + z1;
+                z1 = k->b1 * x - k->a1 * y + z2;
+                z2 = k->b2 * x - k->a2 * y;
+                memcpy(z, &z1, sizeof (z1));
+                memcpy(z + LANES, &z2, sizeof (z2));
+                x = y;
+            }
+            memcpy(s, &x, size);
+#else
+            float x[LANES] = { 0 };
+
+            memcpy(x, s, size);
+            for (unsigned j = 0; j < bq->stages; j++)
+            {
+                const struct biquad_coeffs *k = &bq->coeffs[j];
+                float *z = bq->state + (j * groups + g) * 2 * LANES;
+
+                for (unsigned l = 0; l < LANES; l++)
+                {
+                    const float y = k->b0 * x[l] + z[l];
+
+                    z[l] = k->b1 * x[l] - k->a1 * y + z[LANES + l];
+                    z[LANES + l] = k->b2 * x[l] - k->a2 * y;
+                    x[l] = y;
+                }
+            }
+            memcpy(s, x, size);
+#endif
+        }
+    }
+}
+
+/*****************************************************************************
+ * Bank
+ *****************************************************************************/
+struct biquad_bank
+{
+    unsigned bands;
+    unsigned channels;
+    float *coeffs; /**< b0, b1, b2, a1, a2, gain rows, padded to groups */
+    float *state;  /**< z1 and z2 for each channel and group of bands */
+};
+
+enum { BANK_B0, BANK_B1, BANK_B2, BANK_A1, BANK_A2, BANK_GAIN, BANK_ROWS };
+
+biquad_bank_t *biquad_bank_New(unsigned bands, unsigned channels)
+{
+    biquad_bank_t *bq = malloc(sizeof (*bq));
+    if (unlikely(bq == NULL))
+        return NULL;
+
+    const size_t padded = Groups(bands) * LANES;
+
+    bq->bands = bands;
+    bq->channels = channels;
+    /* Padding bands have zero coefficients and gains, hence no output. */
+    bq->coeffs = calloc(BANK_ROWS * padded, sizeof (*bq->coeffs));
+    bq->state = calloc(channels * padded * 2, sizeof (*bq->state));
+    if (unlikely(bq->coeffs == NULL || bq->state == NULL))
+    {
+        biquad_bank_Delete(bq);
+        return NULL;
+    }
+    return bq;
+}
+
+void biquad_bank_Delete(biquad_bank_t *bq)
+{
+    free(bq->state);
+    free(bq->coeffs);
+    free(bq);
+}
+
+void biquad_bank_Set(biquad_bank_t *bq, unsigned band,
+                     const struct biquad_coeffs *coeffs)
+{
+    const size_t padded = Groups(bq->bands) * LANES;
+
+    assert(band < bq->bands);
+    bq->coeffs[BANK_B0 * padded + band] = coeffs->b0;
+    bq->coeffs[BANK_B1 * padded + band] = coeffs->b1;
+    bq->coeffs[BANK_B2 * padded + band] = coeffs->b2;
+    bq->coeffs[BANK_A1 * padded + band] = coeffs->a1;
+    bq->coeffs[BANK_A2 * padded + band] = coeffs->a2;
+}
+
+void biquad_bank_Reset(biquad_bank_t *bq)
+{
+    memset(bq->state, 0, bq->channels * Groups(bq->bands) * LANES * 2
+                         * sizeof (*bq->state));
+}
+
+void biquad_bank_Process(biquad_bank_t *bq, const float *gains,
+                         float *samples, size_t frames, float dry, float wet)
+{
+    const unsigned channels = bq->channels;
+    const unsigned groups = Groups(bq->bands);
+    const size_t padded = groups * LANES;
+    const float *b0 = bq->coeffs + BANK_B0 * padded;
+    const float *b1 = bq->coeffs + BANK_B1 * padded;
+    const float *b2 = bq->coeffs + BANK_B2 * padded;
+    const float *a1 = bq->coeffs + BANK_A1 * padded;
+    const float *a2 = bq->coeffs + BANK_A2 * padded;
+    const float *gain = bq->coeffs + BANK_GAIN * padded;
+
+    memcpy(bq->coeffs + BANK_GAIN * padded, gains,
+           bq->bands * sizeof (*gains));
+
+    for (unsigned c = 0; c < channels; c++)
+    {
+        float *state = bq->state + c * padded * 2;
+        float *s = samples + c;
+
+        for (size_t i = 0; i < frames; i++, s += channels)
+        {
+            const float x = *s;
+#ifdef HAVE_VECTOR_FLOAT
+            v4sf acc = { 0 };
+
+            for (size_t l = 0; l < padded; l += LANES)
+            {
+                float *z = state + 2 * l;
+                v4sf k0, k1, k2, k3, k4, g, z1, z2, y;
+
+                memcpy(&k0, b0 + l, sizeof (k0));
+                memcpy(&k1, b1 + l, sizeof (k1));
+                memcpy(&k2, b2 + l, sizeof (k2));
+                memcpy(&k3, a1 + l, sizeof (k3));
+                memcpy(&k4, a2 + l, sizeof (k4));
+                memcpy(&g, gain + l, sizeof (g));
+                memcpy(&z1, z, sizeof (z1));
+                memcpy(&z2, z + LANES, sizeof (z2));
+
+                y = k0 * x + z1;
+                z1 = k1 * x - k3 * y + z2;
+                z2 = k2 * x - k4 * y;
+                acc += g * y;
+
+                memcpy(z, &z1, sizeof (z1));
+                memcpy(z + LANES, &z2, sizeof (z2));
+            }
+            *s = dry * x + wet * ((acc[0] + acc[1]) + (acc[2] + acc[3]));
+#else
+            float acc = 0.f;
+
+            for (size_t l = 0; l < padded; l++)
+            {
+                float *z = state + 2 * (l & ~(LANES - 1)) + (l & (LANES - 1));
+                const float y = b0[l] * x + z[0];
+
+                z[0] = b1[l] * x - a1[l] * y + z[LANES];
+                z[LANES] = b2[l] * x - a2[l] * y;
+                acc += gain[l] * y;
+            }
+            *s = dry * x + wet * acc;
+#endif
+        }
+    }
+}
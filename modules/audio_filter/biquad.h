@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * biquad.h: second-order IIR filters for audio filters
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_AUDIO_FILTER_BIQUAD_H
+#define VLC_AUDIO_FILTER_BIQUAD_H
+
+/**
+ * Normalized biquad coefficients (a0 = 1):
+ * y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+ */
+struct biquad_coeffs
+{
+    float b0, b1, b2;
+    float a1, a2;
+};
+
+/**
+ * Filters applied one after the other to each channel of interleaved FL32
+ * samples. Several channels are computed at once.
+ */
+typedef struct biquad_cascade biquad_cascade_t;
+
+biquad_cascade_t *biquad_cascade_New(unsigned stages, unsigned channels);
+void biquad_cascade_Delete(biquad_cascade_t *);
+void biquad_cascade_Set(biquad_cascade_t *, unsigned stage,
+                        const struct biquad_coeffs *);
+void biquad_cascade_Reset(biquad_cascade_t *);
+
+/**
+ * Filters samples in place.
+ */
+void biquad_cascade_Process(biquad_cascade_t *, float *samples,
+                            size_t frames);
+
+/**
+ * Filters applied side by side to each channel of interleaved FL32 samples,
+ * the outputs of which are summed with per-band gains. Several bands are
+ * computed at once.
+ */
+typedef struct biquad_bank biquad_bank_t;
+
+biquad_bank_t *biquad_bank_New(unsigned bands, unsigned channels);
+void biquad_bank_Delete(biquad_bank_t *);
+void biquad_bank_Set(biquad_bank_t *, unsigned band,
+                     const struct biquad_coeffs *);
+void biquad_bank_Reset(biquad_bank_t *);
+
+/**
+ * Filters samples in place.
+ *
+ * Each sample x is replaced with dry * x + wet * sum(gains[i] * y[i]), where
+ * y[i] is the output of the i-th band.
+ *
+ * @param gains one gain per band
+ */
+void biquad_bank_Process(biquad_bank_t *, const float *gains,
+                         float *samples, size_t frames, float dry, float wet);
+
+#endif
@@ -38,9 +38,9 @@
 #include <vlc_filter.h>
 
 #include "equalizer_presets.h"
+#include "biquad.h"
 
 /* TODO:
- *  - optimize a bit (you can hardly do slower ;)
  *  - add tables for more bands (15 and 32 would be cool), maybe with auto coeffs
  *    computation (not too hard once the Q is found).
  *  - support for external preset
@@ -103,22 +103,15 @@ typedef struct
 {
     /* Filter static config */
     int i_band;
-    float *f_alpha;
-    float *f_beta;
-    float *f_gamma;
 
     /* Filter dyn config */
     float *f_amp;   /* Per band amp */
     float f_gamp;   /* Global preamp */
     bool b_2eqz;
 
-    /* Filter state */
-    float x[32][2];
-    float y[32][128][2];
-
-    /* Second filter state */
-    float x2[32][2];
-    float y2[32][128][2];
+    /* Filter and second filter (with their state) */
+    biquad_bank_t *bank;
+    biquad_bank_t *bank2;
 
     vlc_mutex_t lock;
 } filter_sys_t;
@@ -127,7 +120,7 @@ static block_t *DoWork( filter_t *, block_t * );
 
 #define EQZ_IN_FACTOR (0.25f)
 static int  EqzInit( filter_t *, int );
-static void EqzFilter( filter_t *, float *, float *, int, int );
+static void EqzFilter( filter_t *, float *, size_t );
 static void EqzClean( filter_t * );
 
 static int PresetCallback ( vlc_object_t *, char const *, vlc_value_t,
@@ -190,9 +183,7 @@ static void Close( filter_t *p_filter )
  *****************************************************************************/
 static block_t * DoWork( filter_t * p_filter, block_t * p_in_buf )
 {
-    EqzFilter( p_filter, (float*)p_in_buf->p_buffer,
-               (float*)p_in_buf->p_buffer, p_in_buf->i_nb_samples,
-               aout_FormatNbChannels( &p_filter->fmt_in.audio ) );
+    EqzFilter( p_filter, (float*)p_in_buf->p_buffer, p_in_buf->i_nb_samples );
     return p_in_buf;
 }
 
@@ -280,7 +271,7 @@ static int EqzInit( filter_t *p_filter, int i_rate )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
     eqz_config_t cfg;
-    int i, ch;
+    int i;
     vlc_value_t val1, val2, val3;
     vlc_object_t *p_aout = vlc_object_parent(p_filter);
     int i_ret = VLC_ENOMEM;
@@ -289,18 +280,28 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     EqzCoeffs( i_rate, 1.0f, b_vlcFreqs, &cfg );
 
     /* Create the static filter config */
+    const unsigned i_channels = aout_FormatNbChannels( &p_filter->fmt_in.audio );
+
     p_sys->i_band = cfg.i_band;
-    p_sys->f_alpha = vlc_alloc( p_sys->i_band, sizeof(float) );
-    p_sys->f_beta  = vlc_alloc( p_sys->i_band, sizeof(float) );
-    p_sys->f_gamma = vlc_alloc( p_sys->i_band, sizeof(float) );
-    if( !p_sys->f_alpha || !p_sys->f_beta || !p_sys->f_gamma )
+    p_sys->f_amp = NULL;
+    p_sys->bank  = biquad_bank_New( p_sys->i_band, i_channels );
+    p_sys->bank2 = biquad_bank_New( p_sys->i_band, i_channels );
+    if( !p_sys->bank || !p_sys->bank2 )
         goto error;
 
     for( i = 0; i < p_sys->i_band; i++ )
     {
-        p_sys->f_alpha[i] = cfg.band[i].f_alpha;
-        p_sys->f_beta[i]  = cfg.band[i].f_beta;
-        p_sys->f_gamma[i] = cfg.band[i].f_gamma;
+        /* y = alpha * ( x - x[-2] ) + gamma * y[-1] - beta * y[-2] */
+        const struct biquad_coeffs coeffs = {
+            .b0 = cfg.band[i].f_alpha,
+            .b1 = 0.f,
+            .b2 = -cfg.band[i].f_alpha,
+            .a1 = -cfg.band[i].f_gamma,
+            .a2 = cfg.band[i].f_beta,
+        };
+
+        biquad_bank_Set( p_sys->bank, i, &coeffs );
+        biquad_bank_Set( p_sys->bank2, i, &coeffs );
     }
 
     /* Filter dyn config */
@@ -315,23 +316,6 @@ static int EqzInit( filter_t *p_filter, int i_rate )
         p_sys->f_amp[i] = 0.0f;
     }
 
-    /* Filter state */
-    for( ch = 0; ch < 32; ch++ )
-    {
-        p_sys->x[ch][0]  =
-        p_sys->x[ch][1]  =
-        p_sys->x2[ch][0] =
-        p_sys->x2[ch][1] = 0.0f;
-
-        for( i = 0; i < p_sys->i_band; i++ )
-        {
-            p_sys->y[ch][i][0]  =
-            p_sys->y[ch][i][1]  =
-            p_sys->y2[ch][i][0] =
-            p_sys->y2[ch][i][1] = 0.0f;
-        }
-    }
-
     var_Create( p_aout, "equalizer-bands", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
     var_Create( p_aout, "equalizer-preset", VLC_VAR_STRING | VLC_VAR_DOINHERIT );
 
@@ -356,7 +340,6 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     {
         msg_Err(p_filter, "No preset selected");
         free( val2.psz_string );
-        free( p_sys->f_amp );
         i_ret = VLC_EGENERIC;
         goto error;
     }
@@ -374,77 +357,37 @@ static int EqzInit( filter_t *p_filter, int i_rate )
     {
         msg_Dbg( p_filter, "   %.2f Hz -> factor:%f alpha:%f beta:%f gamma:%f",
                  cfg.band[i].f_frequency, p_sys->f_amp[i],
-                 p_sys->f_alpha[i], p_sys->f_beta[i], p_sys->f_gamma[i]);
+                 cfg.band[i].f_alpha, cfg.band[i].f_beta, cfg.band[i].f_gamma );
     }
     return VLC_SUCCESS;
 
 error:
-    free( p_sys->f_alpha );
-    free( p_sys->f_beta );
-    free( p_sys->f_gamma );
+    free( p_sys->f_amp );
+    if( p_sys->bank )
+        biquad_bank_Delete( p_sys->bank );
+    if( p_sys->bank2 )
+        biquad_bank_Delete( p_sys->bank2 );
     return i_ret;
 }
 
-static void EqzFilter( filter_t *p_filter, float *out, float *in,
-                       int i_samples, int i_channels )
+static void EqzFilter( filter_t *p_filter, float *samples, size_t i_samples )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    int i, ch, j;
 
     vlc_mutex_lock( &p_sys->lock );
-    for( i = 0; i < i_samples; i++ )
+    /* We add source PCM + filtered PCM */
+    if( p_sys->b_2eqz )
     {
-        for( ch = 0; ch < i_channels; ch++ )
-        {
-            const float x = in[ch];
-            float o = 0.0f;
-
-            for( j = 0; j < p_sys->i_band; j++ )
-            {
-                float y = p_sys->f_alpha[j] * ( x - p_sys->x[ch][1] ) +
-                          p_sys->f_gamma[j] * p_sys->y[ch][j][0] -
-                          p_sys->f_beta[j]  * p_sys->y[ch][j][1];
-
-                p_sys->y[ch][j][1] = p_sys->y[ch][j][0];
-                p_sys->y[ch][j][0] = y;
-
-                o += y * p_sys->f_amp[j];
-            }
-            p_sys->x[ch][1] = p_sys->x[ch][0];
-            p_sys->x[ch][0] = x;
-
-            /* Second filter */
-            if( p_sys->b_2eqz )
-            {
-                const float x2 = EQZ_IN_FACTOR * x + o;
-                o = 0.0f;
-                for( j = 0; j < p_sys->i_band; j++ )
-                {
-                    float y = p_sys->f_alpha[j] * ( x2 - p_sys->x2[ch][1] ) +
-                              p_sys->f_gamma[j] * p_sys->y2[ch][j][0] -
-                              p_sys->f_beta[j]  * p_sys->y2[ch][j][1];
-
-                    p_sys->y2[ch][j][1] = p_sys->y2[ch][j][0];
-                    p_sys->y2[ch][j][0] = y;
-
-                    o += y * p_sys->f_amp[j];
-                }
-                p_sys->x2[ch][1] = p_sys->x2[ch][0];
-                p_sys->x2[ch][0] = x2;
-
-                /* We add source PCM + filtered PCM */
-                out[ch] = p_sys->f_gamp * p_sys->f_gamp *( EQZ_IN_FACTOR * x2 + o );
-            }
-            else
-            {
-                /* We add source PCM + filtered PCM */
-                out[ch] = p_sys->f_gamp *( EQZ_IN_FACTOR * x + o );
-            }
-        }
+        const float f_gamp2 = p_sys->f_gamp * p_sys->f_gamp;
 
-        in  += i_channels;
-        out += i_channels;
+        biquad_bank_Process( p_sys->bank, p_sys->f_amp, samples, i_samples,
+                             EQZ_IN_FACTOR, 1.f );
+        biquad_bank_Process( p_sys->bank2, p_sys->f_amp, samples, i_samples,
+                             f_gamp2 * EQZ_IN_FACTOR, f_gamp2 );
     }
+    else
+        biquad_bank_Process( p_sys->bank, p_sys->f_amp, samples, i_samples,
+                             p_sys->f_gamp * EQZ_IN_FACTOR, p_sys->f_gamp );
     vlc_mutex_unlock( &p_sys->lock );
 }
 
@@ -458,9 +401,8 @@ static void EqzClean( filter_t *p_filter )
     var_DelCallback( p_aout, "equalizer-preamp", PreampCallback, p_sys );
     var_DelCallback( p_aout, "equalizer-2pass", TwoPassCallback, p_sys );
 
-    free( p_sys->f_alpha );
-    free( p_sys->f_beta );
-    free( p_sys->f_gamma );
+    biquad_bank_Delete( p_sys->bank );
+    biquad_bank_Delete( p_sys->bank2 );
 
     free( p_sys->f_amp );
 }
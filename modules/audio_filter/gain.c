@@ -43,6 +43,7 @@
 static int      Open        ( vlc_object_t * );
 static void     Close       ( filter_t * );
 static block_t  *Process    ( filter_t *, block_t * );
+static void     ProcessPlanar( filter_t *, float *const *, size_t );
 
 typedef struct
 {
@@ -100,7 +101,13 @@ static int Open( vlc_object_t *p_this )
 
     static const struct vlc_filter_operations filter_ops =
         { .filter_audio = Process, .close = Close };
-    p_filter->ops = &filter_ops;
+    static const struct vlc_filter_operations float_filter_ops =
+    {
+        .filter_audio = Process, .filter_audio_planar = ProcessPlanar,
+        .close = Close,
+    };
+    p_filter->ops = p_filter->fmt_in.audio.i_format == VLC_CODEC_FL32
+                  ? &float_filter_ops : &filter_ops;
 
     return VLC_SUCCESS;
 }
@@ -118,6 +125,21 @@ static block_t *Process( filter_t *p_filter, block_t *p_block )
     return p_block;
 }
 
+static void ProcessPlanar( filter_t *p_filter, float *const *pp_planes,
+                           size_t i_frames )
+{
+    filter_sys_t *p_sys = p_filter->p_sys;
+    const float f_gain = p_sys->f_gain;
+
+    for( unsigned c = 0; c < p_filter->fmt_in.audio.i_channels; c++ )
+    {
+        float *p_plane = pp_planes[c];
+
+        for( size_t i = 0; i < i_frames; i++ )
+            p_plane[i] *= f_gain;
+    }
+}
+
 
 /*****************************************************************************
  * Close: close filter
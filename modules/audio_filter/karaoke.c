@@ -39,6 +39,7 @@ vlc_module_begin ()
 vlc_module_end ()
 
 static block_t *Process (filter_t *, block_t *);
+static void ProcessPlanar (filter_t *, float *const *, size_t);
 
 static int Open (vlc_object_t *obj)
 {
@@ -57,6 +58,7 @@ static int Open (vlc_object_t *obj)
     static const struct vlc_filter_operations filter_ops =
     {
         .filter_audio = Process,
+        .filter_audio_planar = ProcessPlanar,
     };
     filter->ops = &filter_ops;
     return VLC_SUCCESS;
@@ -78,3 +80,19 @@ static block_t *Process (filter_t *filter, block_t *block)
     (void) filter;
     return block;
 }
+
+static void ProcessPlanar (filter_t *filter, float *const *planes,
+                           size_t frames)
+{
+    const float factor = .70710678 /* 1. / sqrtf (2) */;
+    float *left = planes[0], *right = planes[1];
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        float s = (left[i] - right[i]) * factor;
+
+        left[i] = s;
+        right[i] = s;
+    }
+    (void) filter;
+}
@@ -36,6 +36,8 @@
 #include <vlc_aout.h>
 #include <vlc_filter.h>
 
+#include "biquad.h"
+
 /*****************************************************************************
  * Module descriptor
  *****************************************************************************/
@@ -43,8 +45,6 @@ static int  Open ( vlc_object_t * );
 static void Close( filter_t * );
 static void CalcPeakEQCoeffs( float, float, float, float, float * );
 static void CalcShelfEQCoeffs( float, float, float, int, float, float * );
-static void ProcessEQ( const float *, float *, float *, unsigned, unsigned,
-                       const float *, unsigned );
 static block_t *DoWork( filter_t *, block_t * );
 
 vlc_module_begin ()
@@ -89,15 +89,24 @@ typedef struct
     float   f_f2, f_Q2, f_gain2;
     float   f_f3, f_Q3, f_gain3;
     float   f_highf, f_highgain;
-    /* Filter computed coeffs */
-    float   coeffs[5*5];
-    /* State */
-    float  *p_state;
+    /* Filters with their computed coeffs and state */
+    biquad_cascade_t *p_eq;
 } filter_sys_t;
 
 
 
 
+static void SetCoeffs( biquad_cascade_t *p_eq, unsigned i_stage,
+                       const float *coeffs )
+{
+    const struct biquad_coeffs k = {
+        .b0 = coeffs[0], .b1 = coeffs[1], .b2 = coeffs[2],
+        .a1 = coeffs[3], .a2 = coeffs[4],
+    };
+
+    biquad_cascade_Set( p_eq, i_stage, &k );
+}
+
 /*****************************************************************************
  * Open:
  *****************************************************************************/
@@ -138,19 +147,31 @@ static int Open( vlc_object_t *p_this )
     p_sys->f_gain3 = var_InheritFloat( p_this, "param-eq-gain3");
 
 
+    p_sys->p_eq = biquad_cascade_New( 5, p_filter->fmt_in.audio.i_channels );
+    if( !p_sys->p_eq )
+    {
+        free( p_sys );
+        return VLC_ENOMEM;
+    }
+
+    float coeffs[5];
+
     i_samplerate = p_filter->fmt_in.audio.i_rate;
     CalcPeakEQCoeffs(p_sys->f_f1, p_sys->f_Q1, p_sys->f_gain1,
-                     i_samplerate, p_sys->coeffs+0*5);
+                     i_samplerate, coeffs);
+    SetCoeffs(p_sys->p_eq, 0, coeffs);
     CalcPeakEQCoeffs(p_sys->f_f2, p_sys->f_Q2, p_sys->f_gain2,
-                     i_samplerate, p_sys->coeffs+1*5);
+                     i_samplerate, coeffs);
+    SetCoeffs(p_sys->p_eq, 1, coeffs);
     CalcPeakEQCoeffs(p_sys->f_f3, p_sys->f_Q3, p_sys->f_gain3,
-                     i_samplerate, p_sys->coeffs+2*5);
+                     i_samplerate, coeffs);
+    SetCoeffs(p_sys->p_eq, 2, coeffs);
     CalcShelfEQCoeffs(p_sys->f_lowf, 1, p_sys->f_lowgain, 0,
-                      i_samplerate, p_sys->coeffs+3*5);
+                      i_samplerate, coeffs);
+    SetCoeffs(p_sys->p_eq, 3, coeffs);
     CalcShelfEQCoeffs(p_sys->f_highf, 1, p_sys->f_highgain, 0,
-                      i_samplerate, p_sys->coeffs+4*5);
-    p_sys->p_state = (float*)calloc( p_filter->fmt_in.audio.i_channels*5*4,
-                                     sizeof(float) );
+                      i_samplerate, coeffs);
+    SetCoeffs(p_sys->p_eq, 4, coeffs);
 
     return VLC_SUCCESS;
 }
@@ -158,7 +179,7 @@ static int Open( vlc_object_t *p_this )
 static void Close( filter_t *p_filter )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    free( p_sys->p_state );
+    biquad_cascade_Delete( p_sys->p_eq );
     free( p_sys );
 }
 
@@ -170,10 +191,8 @@ static void Close( filter_t *p_filter )
 static block_t *DoWork( filter_t * p_filter, block_t * p_in_buf )
 {
     filter_sys_t *p_sys = p_filter->p_sys;
-    ProcessEQ( (float*)p_in_buf->p_buffer, (float*)p_in_buf->p_buffer,
-               p_sys->p_state,
-               p_filter->fmt_in.audio.i_channels, p_in_buf->i_nb_samples,
-               p_sys->coeffs, 5 );
+    biquad_cascade_Process( p_sys->p_eq, (float*)p_in_buf->p_buffer,
+                            p_in_buf->i_nb_samples );
     return p_in_buf;
 }
 
@@ -277,49 +296,3 @@ static void CalcShelfEQCoeffs( float f0, float slope, float gainDB, int high,
     coeffs[3] = a1/a0;
     coeffs[4] = a2/a0;
 }
-
-/*
-  src is assumed to be interleaved
-  dest is assumed to be interleaved
-  size of state is 4*channels*eqCount
-  samples is not premultiplied by channels
-  size of coeffs is 5*eqCount
-*/
-void ProcessEQ( const float *src, float *dest, float *state,
-                unsigned channels, unsigned samples, const float *coeffs,
-                unsigned eqCount )
-{
-    unsigned i, chn, eq;
-    float   b0, b1, b2, a1, a2;
-    float   x, y = 0;
-    const float *src1 = src;
-    float *dest1 = dest;
-
-    for (i = 0; i < samples; i++)
-    {
-        float *state1 = state;
-        for (chn = 0; chn < channels; chn++)
-        {
-            const float *coeffs1 = coeffs;
-            x = *src1++;
-            /* Direct form 1 IIRs */
-            for (eq = 0; eq < eqCount; eq++)
-            {
-                b0 = coeffs1[0];
-                b1 = coeffs1[1];
-                b2 = coeffs1[2];
-                a1 = coeffs1[3];
-                a2 = coeffs1[4];
-                coeffs1 += 5;
-                y = x*b0 + state1[0]*b1 + state1[1]*b2 - state1[2]*a1 - state1[3]*a2;
-                state1[1] = state1[0];
-                state1[0] = x;
-                state1[3] = state1[2];
-                state1[2] = y;
-                x = y;
-                state1 += 4;
-            }
-            *dest1++ = y;
-        }
-    }
-}
@@ -0,0 +1,739 @@
+/*****************************************************************************
+ * polyphase.c : windowed-sinc polyphase audio resampler
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+/*
+ * Rate conversion uses a bank of Kaiser-windowed sinc filters, one per
+ * fractional input position ("phase"). Output samples between two phases
+ * linearly interpolate their coefficients, so any ratio, including one that
+ * changes from a block to the next, is handled by the same tables.
+ *
+ * When the input and output rates are the same, the resampler is only used
+ * by the audio output to correct small clock drifts. Samples are then passed
+ * through untouched and a 4-point cubic interpolator takes over while the
+ * rate is being adjusted, which is plenty for a ratio within a few percent
+ * of one and costs a fraction of a full sinc filter.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <math.h>
+
+#include <vlc_common.h>
+#include <vlc_aout.h>
+#include <vlc_cpu.h>
+#include <vlc_filter.h>
+#include <vlc_plugin.h>
+
+#define QUALITY_TEXT N_("Resampling quality")
+#define QUALITY_LONGTEXT N_("Resampling quality, from worst to best. " \
+    "Higher qualities use longer filters.")
+
+static const int quality_values[] = { 0, 1, 2 };
+static const char *const quality_texts[] = {
+    N_("Low"), N_("Medium"), N_("High"),
+};
+
+static int OpenConverter(vlc_object_t *);
+static int OpenResampler(vlc_object_t *);
+static int OpenDriftResampler(vlc_object_t *);
+
+vlc_module_begin()
+    set_shortname(N_("Polyphase resampler"))
+    set_description(N_("Windowed-sinc polyphase audio resampler"))
+    set_subcategory(SUBCAT_AUDIO_RESAMPLER)
+    add_integer("polyphase-resampler-quality", 1,
+                QUALITY_TEXT, QUALITY_LONGTEXT)
+        change_integer_list(quality_values, quality_texts)
+    set_capability("audio converter", 10)
+    set_callback(OpenConverter)
+
+    add_submodule()
+    set_capability("audio resampler", 10)
+    set_callback(OpenResampler)
+    add_shortcut("polyphase")
+
+    /* Drift correction only: preferred over the full filters, including
+     * soxr and src, as it does not run one for a fraction of a percent of
+     * rate change. It refuses any other use. */
+    add_submodule()
+    set_capability("audio resampler", 52)
+    set_callback(OpenDriftResampler)
+    add_shortcut("polyphase")
+vlc_module_end()
+
+/* Number of filter phases per input sample */
+#define PHASE_BITS   8
+#define PHASES       (1u << PHASE_BITS)
+/* Filter lengths are rounded to a multiple of the widest vector */
+#define TAPS_ALIGN   8u
+#define TAPS_MAX     512u
+
+static const struct
+{
+    unsigned taps;   /**< filter length without decimation */
+    float cutoff;    /**< pass band, relative to the lower Nyquist frequency */
+    float beta;      /**< Kaiser window shape */
+} qualities[] = {
+    { 16, .80f, 5.f },
+    { 32, .90f, 7.f },
+    { 64, .94f, 9.f },
+};
+
+typedef void (*polyphase_kernel)(float *restrict out, const float *restrict in,
+                                 size_t stride, unsigned channels,
+                                 const float *restrict coefs,
+                                 const float *restrict deltas, float alpha,
+                                 float *restrict tmp, unsigned taps);
+
+typedef struct
+{
+    unsigned channels;
+    unsigned taps;     /**< filter length (0 in drift correction mode) */
+    unsigned half;     /**< number of input frames needed after a position */
+
+    float *coefs;      /**< PHASES x taps filter bank */
+    float *deltas;     /**< differences to the next phase */
+    float *tmp;        /**< interpolated filter */
+    polyphase_kernel kernel;
+
+    /* Planar input history, one row of hist_size frames per channel */
+    float *hist;
+    size_t hist_size;
+    size_t hist_frames;
+
+    /* Position of the next output sample in the history (32.32 fixed) */
+    size_t pos;
+    uint32_t frac;
+
+    bool bypass;       /**< drift correction mode, passing samples through */
+} filter_sys_t;
+
+/*****************************************************************************
+ * Kernels
+ *****************************************************************************/
+static void KernelC(float *restrict out, const float *restrict in,
+                    size_t stride, unsigned channels,
+                    const float *restrict coefs, const float *restrict deltas,
+                    float alpha, float *restrict tmp, unsigned taps)
+{
+    for (unsigned k = 0; k < taps; k++)
+        tmp[k] = coefs[k] + alpha * deltas[k];
+
+    for (unsigned c = 0; c < channels; c++, in += stride)
+    {
+        float acc = 0.f;
+
+        for (unsigned k = 0; k < taps; k++)
+            acc += tmp[k] * in[k];
+        out[c] = acc;
+    }
+}
+
+#if defined __has_attribute
+# if __has_attribute(__vector_size__)
+#  define HAVE_VECTOR_FLOAT
+/* Compiled to SSE on x86 and to NEON on ARM */
+typedef float v4sf __attribute__((__vector_size__(16)));
+
+static void KernelV4(float *restrict out, const float *restrict in,
+                     size_t stride, unsigned channels,
+                     const float *restrict coefs, const float *restrict deltas,
+                     float alpha, float *restrict tmp, unsigned taps)
+{
+    for (unsigned k = 0; k < taps; k += 4)
+    {
+        v4sf c, d;
+
+        memcpy(&c, coefs + k, sizeof (c));
+        memcpy(&d, deltas + k, sizeof (d));
+        c += alpha * d;
+        memcpy(tmp + k, &c, sizeof (c));
+    }
+
+    for (unsigned c = 0; c < channels; c++, in += stride)
+    {
+        v4sf acc0 = { 0 }, acc1 = { 0 };
+
+        for (unsigned k = 0; k < taps; k += 8)
+        {
+            v4sf t0, t1, x0, x1;
+
+            memcpy(&t0, tmp + k, sizeof (t0));
+            memcpy(&t1, tmp + k + 4, sizeof (t1));
+            memcpy(&x0, in + k, sizeof (x0));
+            memcpy(&x1, in + k + 4, sizeof (x1));
+            acc0 += t0 * x0;
+            acc1 += t1 * x1;
+        }
+        acc0 += acc1;
+        out[c] = (acc0[0] + acc0[1]) + (acc0[2] + acc0[3]);
+    }
+}
+
+#  if defined (__i386__) || defined (__x86_64__)
+#   define HAVE_KERNEL_AVX2
+typedef float v8sf __attribute__((__vector_size__(32)));
+
+__attribute__((__target__("avx2,fma")))
+static void KernelAVX2(float *restrict out, const float *restrict in,
+                       size_t stride, unsigned channels,
+                       const float *restrict coefs,
+                       const float *restrict deltas,
+                       float alpha, float *restrict tmp, unsigned taps)
+{
+    for (unsigned k = 0; k < taps; k += 8)
+    {
+        v8sf c, d;
+
+        memcpy(&c, coefs + k, sizeof (c));
+        memcpy(&d, deltas + k, sizeof (d));
+        c += alpha * d;
+        memcpy(tmp + k, &c, sizeof (c));
+    }
+
+    for (unsigned c = 0; c < channels; c++, in += stride)
+    {
+        v8sf acc = { 0 };
+
+        for (unsigned k = 0; k < taps; k += 8)
+        {
+            v8sf t, x;
+
+            memcpy(&t, tmp + k, sizeof (t));
+            memcpy(&x, in + k, sizeof (x));
+            acc += t * x;
+        }
+        out[c] = ((acc[0] + acc[4]) + (acc[1] + acc[5]))
+               + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    }
+}
+#  endif
+# endif
+#endif
+
+/*****************************************************************************
+ * Filter design
+ *****************************************************************************/
+static double BesselI0(double x)
+{
+    double sum = 1., term = 1.;
+
+    for (unsigned k = 1; term > sum * 1e-12; k++)
+    {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+static int DesignFilter(filter_t *filter, double ratio)
+{
+    filter_sys_t *sys = filter->p_sys;
+    int q = var_InheritInteger(filter, "polyphase-resampler-quality");
+
+    if (q < 0)
+        q = 0;
+    if ((unsigned)q >= ARRAY_SIZE(qualities))
+        q = ARRAY_SIZE(qualities) - 1;
+
+    /* When decimating, the filter is stretched to keep its transition band
+     * relative to the output rate. */
+    const double scale = ratio < 1. ? ratio : 1.;
+    unsigned taps = ceil(qualities[q].taps / scale);
+
+    taps = (taps + TAPS_ALIGN - 1) & ~(TAPS_ALIGN - 1);
+    if (taps > TAPS_MAX)
+        taps = TAPS_MAX;
+
+    const double cutoff = qualities[q].cutoff * scale;
+    const double beta = qualities[q].beta;
+    const double i0beta = BesselI0(beta);
+    const int half = taps / 2;
+
+    sys->coefs = vlc_alloc(2 * PHASES * taps + taps, sizeof (float));
+    if (unlikely(sys->coefs == NULL))
+        return VLC_ENOMEM;
+    sys->deltas = sys->coefs + PHASES * taps;
+    sys->tmp = sys->deltas + PHASES * taps;
+    sys->taps = taps;
+    sys->half = half;
+
+    /* One extra phase to compute the last differences */
+    float *prev = NULL;
+    float next[TAPS_MAX];
+
+    for (unsigned p = 0; p <= PHASES; p++)
+    {
+        float *row = (p < PHASES) ? sys->coefs + p * taps : next;
+        double sum = 0.;
+
+        for (unsigned k = 0; k < taps; k++)
+        {
+            /* Distance from the output position to input sample k */
+            const double x = (int)k - (half - 1) - (double)p / PHASES;
+            const double w = x / half;
+            double h = 0.;
+
+            if (fabs(w) < 1.)
+            {
+                const double s = cutoff * x;
+
+                h = cutoff * (s != 0. ? sin(M_PI * s) / (M_PI * s) : 1.)
+                  * BesselI0(beta * sqrt(1. - w * w)) / i0beta;
+            }
+            row[k] = h;
+            sum += h;
+        }
+
+        /* Unity gain at DC for every phase */
+        for (unsigned k = 0; k < taps; k++)
+            row[k] /= sum;
+
+        if (prev != NULL)
+        {
+            float *delta = sys->deltas + (p - 1) * taps;
+
+            for (unsigned k = 0; k < taps; k++)
+                delta[k] = row[k] - prev[k];
+        }
+        prev = row;
+    }
+
+    sys->kernel = KernelC;
+#ifdef HAVE_VECTOR_FLOAT
+    sys->kernel = KernelV4;
+#endif
+#ifdef HAVE_KERNEL_AVX2
+    if (vlc_CPU_AVX2())
+        sys->kernel = KernelAVX2;
+#endif
+    return VLC_SUCCESS;
+}
+
+/*****************************************************************************
+ * History management
+ *****************************************************************************/
+static void Reset(filter_sys_t *sys)
+{
+    /* The first output sample is aligned on the first input sample: the
+     * filter is primed with silence before it. */
+    sys->hist_frames = sys->half - 1;
+    sys->pos = sys->half - 1;
+    sys->frac = 0;
+    sys->bypass = sys->taps == 0;
+
+    for (unsigned c = 0; c < sys->channels; c++)
+        memset(sys->hist + c * sys->hist_size, 0,
+               sys->hist_frames * sizeof (float));
+}
+
+static int HistoryReserve(filter_sys_t *sys, size_t frames)
+{
+    size_t needed = sys->hist_frames + frames;
+
+    if (needed <= sys->hist_size)
+        return VLC_SUCCESS;
+
+    size_t size = needed + needed / 2;
+    float *hist = vlc_alloc(size * sys->channels, sizeof (float));
+    if (unlikely(hist == NULL))
+        return VLC_ENOMEM;
+
+    for (unsigned c = 0; c < sys->channels; c++)
+        memcpy(hist + c * size, sys->hist + c * sys->hist_size,
+               sys->hist_frames * sizeof (float));
+    free(sys->hist);
+    sys->hist = hist;
+    sys->hist_size = size;
+    return VLC_SUCCESS;
+}
+
+/** Appends interleaved frames (or silence) to the planar history. */
+static int HistoryAppend(filter_sys_t *sys, const float *in, size_t frames)
+{
+    if (HistoryReserve(sys, frames))
+        return VLC_ENOMEM;
+
+    const unsigned channels = sys->channels;
+
+    for (unsigned c = 0; c < channels; c++)
+    {
+        float *row = sys->hist + c * sys->hist_size + sys->hist_frames;
+
+        if (in == NULL)
+            memset(row, 0, frames * sizeof (float));
+        else
+            for (size_t i = 0; i < frames; i++)
+                row[i] = in[i * channels + c];
+    }
+    sys->hist_frames += frames;
+    return VLC_SUCCESS;
+}
+
+/** Drops the frames that no longer contribute to any output. */
+static void HistoryConsume(filter_sys_t *sys)
+{
+    const size_t keep_before = sys->half - 1;
+
+    if (sys->pos <= keep_before)
+        return;
+
+    size_t shift = sys->pos - keep_before;
+
+    if (shift > sys->hist_frames)
+        shift = sys->hist_frames;
+
+    for (unsigned c = 0; c < sys->channels; c++)
+    {
+        float *row = sys->hist + c * sys->hist_size;
+        memmove(row, row + shift, (sys->hist_frames - shift) * sizeof (float));
+    }
+    sys->hist_frames -= shift;
+    sys->pos -= shift;
+}
+
+/*****************************************************************************
+ * Processing
+ *****************************************************************************/
+static size_t RunSinc(filter_sys_t *sys, float *out, size_t max, uint64_t step)
+{
+    const unsigned channels = sys->channels;
+    const unsigned taps = sys->taps;
+    size_t n = 0;
+
+    while (n < max && sys->pos + sys->half < sys->hist_frames)
+    {
+        const unsigned phase = sys->frac >> (32 - PHASE_BITS);
+        const float alpha = (sys->frac & ((1u << (32 - PHASE_BITS)) - 1))
+                          * (1.f / (1u << (32 - PHASE_BITS)));
+
+        sys->kernel(out, sys->hist + sys->pos - (sys->half - 1),
+                    sys->hist_size, channels,
+                    sys->coefs + phase * taps, sys->deltas + phase * taps,
+                    alpha, sys->tmp, taps);
+        out += channels;
+        n++;
+
+        uint64_t next = sys->frac + step;
+        sys->pos += next >> 32;
+        sys->frac = next;
+    }
+    return n;
+}
+
+static size_t RunCubic(filter_sys_t *sys, float *out, size_t max, uint64_t step)
+{
+    const unsigned channels = sys->channels;
+    size_t n = 0;
+
+    while (n < max && sys->pos + sys->half < sys->hist_frames)
+    {
+        const float t = sys->frac * (1.f / 4294967296.f);
+
+        for (unsigned c = 0; c < channels; c++)
+        {
+            const float *x = sys->hist + c * sys->hist_size + sys->pos;
+            /* Catmull-Rom spline through x[-1], x[0], x[1] and x[2] */
+            const float a = .5f * (x[2] - x[-1]) + 1.5f * (x[0] - x[1]);
+            const float b = x[-1] - 2.5f * x[0] + 2.f * x[1] - .5f * x[2];
+            const float d = .5f * (x[1] - x[-1]);
+
+            out[c] = ((a * t + b) * t + d) * t + x[0];
+        }
+        out += channels;
+        n++;
+
+        uint64_t next = sys->frac + step;
+        sys->pos += next >> 32;
+        sys->frac = next;
+    }
+    return n;
+}
+
+static block_t *Process(filter_t *filter, block_t *in, uint64_t step)
+{
+    filter_sys_t *sys = filter->p_sys;
+    const unsigned channels = sys->channels;
+    const size_t in_frames = in != NULL ? in->i_nb_samples : 0;
+
+    if (in != NULL && HistoryAppend(sys, (const float *)in->p_buffer,
+                                    in_frames))
+        goto error;
+
+    /* Upper bound of the number of output samples */
+    size_t avail = sys->hist_frames > sys->pos
+                 ? sys->hist_frames - sys->pos : 0;
+    size_t max = (((uint64_t)avail << 32) / step) + 1;
+
+    block_t *out = block_Alloc(max * channels * sizeof (float));
+    if (unlikely(out == NULL))
+        goto error;
+
+    size_t n = (sys->taps != 0 ? RunSinc : RunCubic)(sys,
+                                          (float *)out->p_buffer, max, step);
+    HistoryConsume(sys);
+
+    out->i_nb_samples = n;
+    out->i_buffer = n * channels * sizeof (float);
+    out->i_length = vlc_tick_from_samples(n, filter->fmt_out.audio.i_rate);
+    if (in != NULL)
+    {
+        out->i_pts = in->i_pts;
+        block_Release(in);
+    }
+    return out;
+error:
+    if (in != NULL)
+        block_Release(in);
+    return NULL;
+}
+
+static uint64_t GetStep(const filter_t *filter)
+{
+    return ((uint64_t)filter->fmt_in.audio.i_rate << 32)
+           / filter->fmt_out.audio.i_rate;
+}
+
+static block_t *Resample(filter_t *filter, block_t *in)
+{
+    return Process(filter, in, GetStep(filter));
+}
+
+static block_t *Drain(filter_t *filter)
+{
+    filter_sys_t *sys = filter->p_sys;
+
+    if (sys->bypass)
+        return NULL;
+
+    /* Flush the look-ahead with silence */
+    block_t *out = NULL;
+
+    if (HistoryAppend(sys, NULL, sys->half) == VLC_SUCCESS)
+        out = Process(filter, NULL, GetStep(filter));
+    Reset(sys);
+    return out;
+}
+
+static void Flush(filter_t *filter)
+{
+    Reset(filter->p_sys);
+}
+
+/*****************************************************************************
+ * Drift correction
+ *****************************************************************************/
+static void KeepLastFrame(filter_sys_t *sys, const block_t *in)
+{
+    const unsigned channels = sys->channels;
+    const float *last = (const float *)in->p_buffer
+                      + (in->i_nb_samples - 1) * channels;
+
+    /* The cubic interpolator looks one frame behind its position */
+    for (unsigned c = 0; c < channels; c++)
+        sys->hist[c * sys->hist_size] = last[c];
+    sys->hist_frames = 1;
+    sys->pos = 1;
+    sys->frac = 0;
+}
+
+static block_t *DriftResample(filter_t *filter, block_t *in)
+{
+    filter_sys_t *sys = filter->p_sys;
+    const uint64_t step = GetStep(filter);
+
+    if (in->i_nb_samples == 0)
+        return in;
+
+    if (step != UINT64_C(1) << 32)
+    {
+        sys->bypass = false;
+        return Process(filter, in, step);
+    }
+
+    if (sys->bypass)
+    {
+        KeepLastFrame(sys, in);
+        return in;
+    }
+
+    /* Back to the nominal rate: rather than jumping back onto the input
+     * samples, which would be heard as a click, converge with a rate about
+     * 0.1% off, then pass the frames still pending in the history through. */
+    const uint32_t eps = UINT32_C(1) << 22;
+    uint64_t converge_step = step;
+    size_t count;
+
+    if (sys->frac < UINT32_C(1) << 31)
+    {
+        count = sys->frac / eps;
+        converge_step -= eps;
+    }
+    else
+    {
+        count = ((UINT64_C(1) << 32) - sys->frac + eps - 1) / eps;
+        converge_step += eps;
+    }
+
+    if (HistoryAppend(sys, (const float *)in->p_buffer, in->i_nb_samples))
+    {
+        block_Release(in);
+        return NULL;
+    }
+
+    const unsigned channels = sys->channels;
+    const size_t max = count + sys->hist_frames - sys->pos;
+    block_t *out = block_Alloc(max * channels * sizeof (float));
+
+    if (unlikely(out == NULL))
+    {
+        HistoryConsume(sys);
+        block_Release(in);
+        return NULL;
+    }
+
+    float *p = (float *)out->p_buffer;
+    size_t frames = RunCubic(sys, p, count, converge_step);
+
+    if (frames == count)
+    {
+        /* Less than eps away from an input sample */
+        p += frames * channels;
+        for (size_t i = sys->pos; i < sys->hist_frames; i++, frames++)
+            for (unsigned c = 0; c < channels; c++)
+                *(p++) = sys->hist[c * sys->hist_size + i];
+
+        KeepLastFrame(sys, in);
+        sys->bypass = true;
+    }
+    else
+        HistoryConsume(sys);
+
+    out->i_nb_samples = frames;
+    out->i_buffer = frames * channels * sizeof (float);
+    out->i_pts = in->i_pts;
+    out->i_length = vlc_tick_from_samples(frames, filter->fmt_out.audio.i_rate);
+    block_Release(in);
+    return out;
+}
+
+/*****************************************************************************
+ * Open/Close
+ *****************************************************************************/
+static void Close(filter_t *filter)
+{
+    filter_sys_t *sys = filter->p_sys;
+
+    free(sys->hist);
+    free(sys->coefs);
+    free(sys);
+}
+
+static int Open(filter_t *filter, bool drift)
+{
+    const audio_format_t *fin = &filter->fmt_in.audio;
+    const audio_format_t *fout = &filter->fmt_out.audio;
+
+    if (fin->i_format != VLC_CODEC_FL32 || fout->i_format != VLC_CODEC_FL32
+     || fin->i_channels != fout->i_channels
+     || fin->i_rate == 0 || fout->i_rate == 0)
+        return VLC_EGENERIC;
+
+    filter_sys_t *sys = calloc(1, sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    filter->p_sys = sys;
+    sys->channels = fin->i_channels;
+
+    if (drift)
+        sys->half = 2;
+    else if (DesignFilter(filter, fout->i_rate / (double)fin->i_rate))
+    {
+        free(sys);
+        return VLC_ENOMEM;
+    }
+
+    if (HistoryReserve(sys, 4096))
+    {
+        Close(filter);
+        return VLC_ENOMEM;
+    }
+    Reset(sys);
+
+    if (drift)
+        msg_Dbg(filter, "drift correction at %u Hz", fin->i_rate);
+    else
+        msg_Dbg(filter, "%u Hz to %u Hz with %u taps", fin->i_rate,
+                fout->i_rate, sys->taps);
+
+    static const struct vlc_filter_operations filter_ops =
+    {
+        .filter_audio = Resample,
+        .drain_audio = Drain,
+        .flush = Flush,
+        .close = Close,
+    };
+    static const struct vlc_filter_operations drift_ops =
+    {
+        .filter_audio = DriftResample,
+        .drain_audio = Drain,
+        .flush = Flush,
+        .close = Close,
+    };
+    filter->ops = drift ? &drift_ops : &filter_ops;
+    return VLC_SUCCESS;
+}
+
+static int OpenConverter(vlc_object_t *obj)
+{
+    filter_t *filter = (filter_t *)obj;
+
+    if (filter->fmt_in.audio.i_rate == filter->fmt_out.audio.i_rate)
+        return VLC_EGENERIC;
+    return Open(filter, false);
+}
+
+static int OpenResampler(vlc_object_t *obj)
+{
+    return Open((filter_t *)obj, false);
+}
+
+static int OpenDriftResampler(vlc_object_t *obj)
+{
+    filter_t *filter = (filter_t *)obj;
+
+    if (filter->fmt_in.audio.i_rate != filter->fmt_out.audio.i_rate)
+        return VLC_EGENERIC;
+
+    /* The cubic interpolator aliases audibly at actual rate changes: only
+     * handle the audio output clock drift, i.e. not the playback rate (no
+     * time stretching) nor the pitch shift of another filter. */
+    vlc_object_t *parent = vlc_object_parent(obj);
+    if (parent == NULL
+     || strcmp(vlc_object_typename(parent), "audio output")
+     || !var_InheritBool(obj, "audio-time-stretch"))
+        return VLC_EGENERIC;
+
+    return Open(filter, true);
+}
@@ -36,6 +36,7 @@
 #include <stdatomic.h>
 #include <string.h> /* for memset */
 #include <limits.h> /* form INT_MIN */
+#include <math.h>
 
 /*****************************************************************************
  * Module descriptor
@@ -87,6 +88,8 @@ vlc_module_end ()
  * Scaletempo smooths the overlap further by searching within the input buffer
  * for the best overlap position.  Scaletempo uses a statistical cross correlation
  * (roughly a dot-product).  Scaletempo consumes most of its CPU cycles here.
+ * Short searches compute each dot-product directly, long searches compute all
+ * of them at once with FFTs, whichever is cheaper for the configuration.
  *
  * NOTE:
  * sample: a single audio sample for one channel
@@ -128,6 +131,10 @@ typedef struct
     void     *buf_pre_corr;
     void     *table_window;
     unsigned(*best_overlap_offset)( filter_t *p_filter );
+    /* best overlap, FFT cross correlation */
+    unsigned  fft_size;
+    unsigned *fft_bitrev;
+    float    *fft_buf; /* twiddles, work and cross spectrum buffers */
 #ifdef PITCH_SHIFTER
     /* pitch */
     filter_t * resampler;
@@ -138,30 +145,64 @@ typedef struct
 /*****************************************************************************
  * best_overlap_offset: calculate best offset for overlap
  *****************************************************************************/
+static void pre_correlate_float( filter_sys_t *p )
+{
+    const float *pw = p->table_window;
+    const float *po = (float *)p->buf_overlap + p->samples_per_frame;
+    float *ppc = p->buf_pre_corr;
+
+    for( unsigned i = p->samples_per_frame; i < p->samples_overlap; i++ )
+        *ppc++ = *pw++ * *po++;
+}
+
+#if defined __has_attribute
+# if __has_attribute(__vector_size__)
+#  define HAVE_VECTOR_FLOAT
+typedef float v4sf __attribute__((__vector_size__(16)));
+# endif
+#endif
+
+static float dot_product_float( const float *restrict a,
+                                const float *restrict b, unsigned n )
+{
+    float sum = 0;
+    unsigned i = 0;
+#ifdef HAVE_VECTOR_FLOAT
+    /* Two independent accumulators hide the latency of the additions */
+    v4sf acc0 = { 0 }, acc1 = { 0 };
+
+    for( ; i + 8 <= n; i += 8 )
+    {
+        v4sf a0, a1, b0, b1;
+
+        memcpy( &a0, a + i, sizeof (a0) );
+        memcpy( &a1, a + i + 4, sizeof (a1) );
+        memcpy( &b0, b + i, sizeof (b0) );
+        memcpy( &b1, b + i + 4, sizeof (b1) );
+        acc0 += a0 * b0;
+        acc1 += a1 * b1;
+    }
+    acc0 += acc1;
+    sum = acc0[0] + acc0[1] + acc0[2] + acc0[3];
+#endif
+    for( ; i < n; i++ )
+        sum += a[i] * b[i];
+    return sum;
+}
+
 static unsigned best_overlap_offset_float( filter_t *p_filter )
 {
     filter_sys_t *p = p_filter->p_sys;
-    float *pw, *po, *ppc, *search_start;
+    const float *search_start;
     float best_corr = INT_MIN;
     unsigned best_off = 0;
-    unsigned i, off;
-
-    pw  = p->table_window;
-    po  = p->buf_overlap;
-    po += p->samples_per_frame;
-    ppc = p->buf_pre_corr;
-    for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-      *ppc++ = *pw++ * *po++;
-    }
+    unsigned samples = p->samples_overlap - p->samples_per_frame;
+
+    pre_correlate_float( p );
 
     search_start = (float *)p->buf_queue + p->samples_per_frame;
-    for( off = 0; off < p->frames_search; off++ ) {
-      float corr = 0;
-      float *ps = search_start;
-      ppc = p->buf_pre_corr;
-      for( i = p->samples_per_frame; i < p->samples_overlap; i++ ) {
-        corr += *ppc++ * *ps++;
-      }
+    for( unsigned off = 0; off < p->frames_search; off++ ) {
+      float corr = dot_product_float( p->buf_pre_corr, search_start, samples );
       if( corr > best_corr ) {
         best_corr = corr;
         best_off  = off;
@@ -172,6 +213,234 @@ static unsigned best_overlap_offset_float( filter_t *p_filter )
     return best_off * p->bytes_per_frame;
 }
 
+/*
+ * The FFT path computes the correlations for a block of offsets at once: the
+ * cross spectra conj(X).Y of the pre-correlated overlap x and of the search
+ * window y are accumulated over channels, and a single inverse transform
+ * yields the correlation for every offset of the block. The transform is
+ * large enough for the circular correlation not to wrap over the block.
+ *
+ * Real signals are transformed by pairs, as the real and imaginary parts of
+ * a complex signal. The spectra of the overlap are computed once per stride.
+ */
+static void fft_butterflies( float *restrict ar, float *restrict ai,
+                             float *restrict br, float *restrict bi,
+                             const float *restrict wr,
+                             const float *restrict wi, unsigned half )
+{
+    for( unsigned k = 0; k < half; k++ )
+    {
+        const float tr = br[k] * wr[k] - bi[k] * wi[k];
+        const float ti = br[k] * wi[k] + bi[k] * wr[k];
+
+        br[k] = ar[k] - tr;
+        bi[k] = ai[k] - ti;
+        ar[k] += tr;
+        ai[k] += ti;
+    }
+}
+
+/* Forward transform; swapping re and im yields the inverse (unscaled) one */
+static void fft_transform( const filter_sys_t *p, float *re, float *im )
+{
+    const unsigned n = p->fft_size;
+    const float *tw_re = p->fft_buf, *tw_im = tw_re + n;
+
+    for( unsigned i = 0; i < n; i++ )
+    {
+        unsigned j = p->fft_bitrev[i];
+        if( j > i )
+        {
+            float t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    /* The twiddles of the stage combining halves of size h are stored
+     * contiguously from index h. */
+    for( unsigned half = 1; half < n; half <<= 1 )
+        for( unsigned i = 0; i < n; i += 2 * half )
+            fft_butterflies( re + i, im + i, re + i + half, im + i + half,
+                             tw_re + half, tw_im + half, half );
+}
+
+/* Loads frames [start, start + count) of one or two channels, zero padded
+ * to the transform size, and transforms them. */
+static void fft_load_pair( const filter_sys_t *p, float *re, float *im,
+                           const float *samples, unsigned channel,
+                           unsigned start, unsigned count )
+{
+    const unsigned n = p->fft_size, channels = p->samples_per_frame;
+    const bool pair = channel + 1 < channels;
+    const float *ps = samples + (size_t)start * channels + channel;
+    unsigned i = 0;
+
+    for( ; i < count; i++, ps += channels )
+    {
+        re[i] = ps[0];
+        im[i] = pair ? ps[1] : 0.f;
+    }
+    for( ; i < n; i++ )
+        re[i] = im[i] = 0.f;
+
+    fft_transform( p, re, im );
+}
+
+static unsigned best_overlap_offset_fft( filter_t *p_filter )
+{
+    filter_sys_t *p = p_filter->p_sys;
+    const unsigned n = p->fft_size, channels = p->samples_per_frame;
+    const unsigned frames_corr = p->samples_overlap / channels - 1;
+    const unsigned frames_in = p->frames_search + frames_corr - 1;
+    const unsigned block = n - frames_corr + 1;
+    float *re = p->fft_buf + 2 * n, *im = re + n;
+    float *acc_re = im + n, *acc_im = acc_re + n;
+    float *spectra = acc_im + n;
+    const float *ps = (float *)p->buf_queue + channels;
+    float best_corr = INT_MIN;
+    unsigned best_off = 0;
+
+    pre_correlate_float( p );
+
+    /* Spectra of the overlap, two channels per transform */
+    for( unsigned c = 0; c < channels; c += 2 )
+    {
+        float *xr = spectra + 2 * n * c, *xi = xr + n;
+
+        fft_load_pair( p, xr, xi, p->buf_pre_corr, c, 0, frames_corr );
+        if( c + 1 < channels )
+        {   /* Split both spectra (scaled by 2) */
+            float *yr = xi + n, *yi = yr + n;
+
+            for( unsigned k = 0; k <= n / 2; k++ )
+            {
+                const unsigned kk = ( n - k ) & ( n - 1 );
+                const float zr = xr[k], zi = xi[k], zzr = xr[kk], zzi = xi[kk];
+
+                xr[k] = zr + zzr; xi[k] = zi - zzi;
+                yr[k] = zi + zzi; yi[k] = zzr - zr;
+                xr[kk] = xr[k]; xi[kk] = -xi[k];
+                yr[kk] = yr[k]; yi[kk] = -yi[k];
+            }
+        }
+        else
+        {   /* Scale the lone last channel alike, so that every channel
+             * weighs the same in the summed correlation. */
+            for( unsigned k = 0; k < n; k++ )
+            {
+                xr[k] *= 2.f;
+                xi[k] *= 2.f;
+            }
+        }
+    }
+
+    for( unsigned start = 0; start < p->frames_search; start += block )
+    {
+        unsigned count = __MIN( n, frames_in - start );
+
+        memset( acc_re, 0, 2 * n * sizeof (float) );
+
+        for( unsigned c = 0; c < channels; c += 2 )
+        {
+            const float *xr = spectra + 2 * n * c, *xi = xr + n;
+            const bool pair = c + 1 < channels;
+
+            fft_load_pair( p, re, im, ps, c, start, count );
+
+            /* Split the spectra of both channels, and accumulate conj(X).Y
+             * (the scale does not matter to find the best offset). */
+            for( unsigned k = 0; k < n; k++ )
+            {
+                const unsigned kk = ( n - k ) & ( n - 1 );
+                float yr = pair ? re[k] + re[kk] : 2.f * re[k];
+                float yi = pair ? im[k] - im[kk] : 2.f * im[k];
+
+                acc_re[k] += xr[k] * yr + xi[k] * yi;
+                acc_im[k] += xr[k] * yi - xi[k] * yr;
+
+                if( pair )
+                {
+                    const float *x2r = xi + n, *x2i = x2r + n;
+
+                    yr = im[k] + im[kk];
+                    yi = re[kk] - re[k];
+                    acc_re[k] += x2r[k] * yr + x2i[k] * yi;
+                    acc_im[k] += x2r[k] * yi - x2i[k] * yr;
+                }
+            }
+        }
+
+        fft_transform( p, acc_im, acc_re ); /* inverse */
+
+        unsigned end = __MIN( block, p->frames_search - start );
+        for( unsigned off = 0; off < end; off++ )
+            if( acc_re[off] > best_corr )
+            {
+                best_corr = acc_re[off];
+                best_off  = start + off;
+            }
+    }
+
+    return best_off * p->bytes_per_frame;
+}
+
+/**
+ * Prepares the FFT cross correlation if it is cheaper than the direct one.
+ */
+static int init_fft( filter_sys_t *p, unsigned frames_overlap )
+{
+    const unsigned channels = p->samples_per_frame;
+    const unsigned frames_corr = frames_overlap - 1;
+    const unsigned frames_in = p->frames_search + frames_corr - 1;
+    unsigned order = 1;
+
+    /* Transforms of about 4 times the overlap, unless a smaller one covers
+     * the whole search */
+    while( (1u << order) < 4 * frames_corr && (1u << order) < frames_in )
+        order++;
+
+    const unsigned n = 1u << order;
+    const unsigned blocks = ( p->frames_search + n - frames_corr )
+                          / ( n - frames_corr + 1 );
+    const unsigned pairs = ( channels + 1 ) / 2;
+
+    /* Rough costs: one (vectorized) multiply-add per sample and offset for
+     * the direct path, against n.log2(n) operations per transform, which
+     * are measured to be about 8 times as expensive. */
+    const uint64_t direct_cost = (uint64_t)p->frames_search
+                               * ( p->samples_overlap - channels );
+    const uint64_t fft_cost = (uint64_t)8 * n * order
+                            * ( pairs + blocks * ( pairs + 1 ) );
+
+    if( fft_cost >= direct_cost )
+        return VLC_SUCCESS;
+
+    p->fft_bitrev = vlc_alloc( n, sizeof (*p->fft_bitrev) );
+    /* twiddles, work buffer, accumulator and channel spectra */
+    p->fft_buf = vlc_alloc( n, sizeof (float) * ( 6 + 2 * 2 * pairs ) );
+    if( p->fft_bitrev == NULL || p->fft_buf == NULL )
+        return VLC_ENOMEM;
+
+    for( unsigned i = 0; i < n; i++ )
+    {
+        unsigned r = 0;
+        for( unsigned b = 0; b < order; b++ )
+            if( i & (1u << b) )
+                r |= 1u << (order - 1 - b);
+        p->fft_bitrev[i] = r;
+    }
+    for( unsigned half = 1; half < n; half <<= 1 )
+        for( unsigned k = 0; k < half; k++ )
+        {
+            p->fft_buf[half + k] = cosf( M_PI * k / half );
+            p->fft_buf[n + half + k] = -sinf( M_PI * k / half );
+        }
+
+    p->fft_size = n;
+    p->best_overlap_offset = best_overlap_offset_fft;
+    return VLC_SUCCESS;
+}
+
 /*****************************************************************************
  * output_overlap: blend end of previous stride with beginning of current stride
  *****************************************************************************/
@@ -351,6 +620,8 @@ static int reinit_buffers( filter_t *p_filter )
                 *pw++ = v;
         }
         p->best_overlap_offset = best_overlap_offset_float;
+        if( init_fft( p, frames_overlap ) != VLC_SUCCESS )
+            return VLC_ENOMEM;
     }
 
     unsigned new_size = ( p->frames_search + frames_stride + frames_overlap ) * p->bytes_per_frame;
@@ -380,13 +651,13 @@ static int reinit_buffers( filter_t *p_filter )
     p->frames_stride_scaled = p->bytes_stride_scaled / p->bytes_per_frame;
 
     msg_Dbg( VLC_OBJECT(p_filter),
-             "%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search, %i queue, %s mode",
+             "%.3f scale, %.3f stride_in, %i stride_out, %i standing, %i overlap, %i search (%s), %i queue, %s mode",
              p->scale,
              p->frames_stride_scaled,
              (int)( p->bytes_stride / p->bytes_per_frame ),
              (int)( p->bytes_standing / p->bytes_per_frame ),
              (int)( p->bytes_overlap / p->bytes_per_frame ),
-             p->frames_search,
+             p->frames_search, p->fft_size ? "fft" : "direct",
              (int)( p->bytes_queue_max / p->bytes_per_frame ),
              "fl32");
 
@@ -429,6 +700,9 @@ static int Open( vlc_object_t *p_this )
     p_sys->table_blend    = NULL;
     p_sys->buf_pre_corr   = NULL;
     p_sys->table_window   = NULL;
+    p_sys->fft_size       = 0;
+    p_sys->fft_bitrev     = NULL;
+    p_sys->fft_buf        = NULL;
     p_sys->bytes_overlap  = 0;
     p_sys->bytes_queued   = 0;
     p_sys->bytes_to_slide = 0;
@@ -531,6 +805,8 @@ static void Close( filter_t *p_filter )
     free( p_sys->table_blend );
     free( p_sys->buf_pre_corr );
     free( p_sys->table_window );
+    free( p_sys->fft_bitrev );
+    free( p_sys->fft_buf );
     free( p_sys );
 }
 
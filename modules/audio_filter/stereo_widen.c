@@ -36,6 +36,7 @@ static int  Open ( vlc_object_t * );
 static void Close( filter_t * );
 
 static block_t *Filter ( filter_t *, block_t * );
+static void FilterPlanar( filter_t *, float *const *, size_t );
 static int paramCallback( vlc_object_t *, char const *, vlc_value_t ,
                             vlc_value_t , void * );
 
@@ -154,7 +155,8 @@ static int Open( vlc_object_t *obj )
 
     static const struct vlc_filter_operations filter_ops =
     {
-        .filter_audio = Filter, .close = Close,
+        .filter_audio = Filter, .filter_audio_planar = FilterPlanar,
+        .close = Close,
     };
     p_filter->ops = &filter_ops;
     return VLC_SUCCESS;
@@ -163,26 +165,27 @@ static int Open( vlc_object_t *obj )
 /*****************************************************************************
  * Filter: process each sample
  *****************************************************************************/
-static block_t *Filter( filter_t *p_filter, block_t *p_block )
+static void Process( filter_sys_t *p_sys, float *p_left, float *p_right,
+                     size_t i_stride, size_t i_frames )
 {
-    filter_sys_t *p_sys = p_filter->p_sys;
-    float *p_out = (float *)p_block->p_buffer;
     float *pf_read;
 
-    for (unsigned i = p_block->i_nb_samples; i > 0; i--)
+    for( size_t i = 0; i < i_frames; i++ )
     {
         pf_read = p_sys->pf_write + 2;
         /* if at end of buffer put read ptr at begin */
         if( pf_read >= p_sys->pf_ringbuf + p_sys->i_len )
             pf_read = p_sys->pf_ringbuf;
 
-        float left  = p_out[0];
-        float right = p_out[1];
+        float left  = p_left[i * i_stride];
+        float right = p_right[i * i_stride];
 
-        *(p_out++) = p_sys->f_dry_mix * left  - p_sys->f_crossfeed * right
-                        - p_sys->f_feedback * pf_read[1];
-        *(p_out++) = p_sys->f_dry_mix * right - p_sys->f_crossfeed * left
-                        - p_sys->f_feedback * pf_read[0];
+        p_left[i * i_stride]  = p_sys->f_dry_mix * left
+                              - p_sys->f_crossfeed * right
+                              - p_sys->f_feedback * pf_read[1];
+        p_right[i * i_stride] = p_sys->f_dry_mix * right
+                              - p_sys->f_crossfeed * left
+                              - p_sys->f_feedback * pf_read[0];
         *(p_sys->pf_write++) = left ;
         *(p_sys->pf_write++) = right;
 
@@ -190,10 +193,22 @@ static block_t *Filter( filter_t *p_filter, block_t *p_block )
         if( p_sys->pf_write  == p_sys->pf_ringbuf + p_sys->i_len )
             p_sys->pf_write  =  p_sys->pf_ringbuf;
     }
+}
 
+static block_t *Filter( filter_t *p_filter, block_t *p_block )
+{
+    float *p_out = (float *)p_block->p_buffer;
+
+    Process( p_filter->p_sys, p_out, p_out + 1, 2, p_block->i_nb_samples );
     return p_block;
 }
 
+static void FilterPlanar( filter_t *p_filter, float *const *pp_planes,
+                          size_t i_frames )
+{
+    Process( p_filter->p_sys, pp_planes[0], pp_planes[1], 1, i_frames );
+}
+
 /*****************************************************************************
  * Close: close the plugin
  *****************************************************************************/
@@ -92,6 +92,9 @@ typedef struct
     bool b_from_preroll;
     bool b_hardware_only;
     enum AVDiscard i_skip_frame;
+    enum AVDiscard i_skip_loop_filter;
+    bool b_scrubbing;
+    decoder_threads_t budget_threads; /* held from the decoder thread budget */
 
 #if OPAQUE_REF_ONLY
     uint64_t i_next_sequence_number;
@@ -570,11 +573,12 @@ static int InitVideoDecCommon( decoder_t *p_dec )
 #endif
 
     i_val = var_CreateGetInteger( p_dec, "avcodec-skiploopfilter" );
-    if( i_val >= 4 ) p_context->skip_loop_filter = AVDISCARD_ALL;
-    else if( i_val == 3 ) p_context->skip_loop_filter = AVDISCARD_NONKEY;
-    else if( i_val == 2 ) p_context->skip_loop_filter = AVDISCARD_BIDIR;
-    else if( i_val == 1 ) p_context->skip_loop_filter = AVDISCARD_NONREF;
-    else p_context->skip_loop_filter = AVDISCARD_DEFAULT;
+    if( i_val >= 4 ) p_sys->i_skip_loop_filter = AVDISCARD_ALL;
+    else if( i_val == 3 ) p_sys->i_skip_loop_filter = AVDISCARD_NONKEY;
+    else if( i_val == 2 ) p_sys->i_skip_loop_filter = AVDISCARD_BIDIR;
+    else if( i_val == 1 ) p_sys->i_skip_loop_filter = AVDISCARD_NONREF;
+    else p_sys->i_skip_loop_filter = AVDISCARD_DEFAULT;
+    p_context->skip_loop_filter = p_sys->i_skip_loop_filter;
 
     /* ***** libavcodec frame skipping ***** */
     p_sys->b_hurry_up = var_CreateGetBool( p_dec, "avcodec-hurry-up" );
@@ -622,7 +626,8 @@ static int InitVideoDecCommon( decoder_t *p_dec )
 
     int max_thread_count;
     int i_thread_count = p_sys->b_hardware_only ? 1 : var_InheritInteger( p_dec, "avcodec-threads" );
-    if( i_thread_count <= 0 )
+    const bool b_auto_threads = i_thread_count <= 0;
+    if( b_auto_threads )
     {
         i_thread_count = vlc_GetCPUCount();
         if( i_thread_count > 1 )
@@ -640,6 +645,12 @@ static int InitVideoDecCommon( decoder_t *p_dec )
     else
         max_thread_count = p_codec->id == AV_CODEC_ID_HEVC ? 32 : 16;
     i_thread_count = __MIN( i_thread_count, max_thread_count );
+    if( b_auto_threads )
+    {
+        /* Share the cores with the other decoders of the process */
+        i_thread_count = decoder_AcquireThreads( p_dec, i_thread_count,
+                                                 &p_sys->budget_threads );
+    }
     msg_Dbg( p_dec, "allowing %d thread(s) for decoding", i_thread_count );
     p_context->thread_count = i_thread_count;
 #if LIBAVCODEC_VERSION_MAJOR < 60
@@ -694,6 +705,7 @@ static int InitVideoDecCommon( decoder_t *p_dec )
     /* ***** Open the codec ***** */
     if( OpenVideoCodec( p_dec ) < 0 )
     {
+        decoder_ReleaseThreads( &p_sys->budget_threads );
         free( p_sys );
         avcodec_free_context( &p_context );
         return VLC_EGENERIC;
@@ -1390,7 +1402,19 @@ static int DecodeBlock( decoder_t *p_dec, block_t **pp_block )
             p_block = filter_earlydropped_blocks( p_dec, p_block );
     }
 
-    if( !b_need_output_picture || p_sys->framedrop == FRAMEDROP_NONREF )
+    /* While scrubbing, favour speed over quality */
+    const bool b_scrubbing = decoder_IsScrubbing( p_dec );
+    if( b_scrubbing != p_sys->b_scrubbing )
+    {
+        p_sys->b_scrubbing = b_scrubbing;
+        p_context->skip_loop_filter = b_scrubbing ? AVDISCARD_ALL
+                                                  : p_sys->i_skip_loop_filter;
+        if( !b_scrubbing )
+            p_context->skip_frame = p_sys->i_skip_frame;
+    }
+
+    if( !b_need_output_picture || p_sys->framedrop == FRAMEDROP_NONREF
+     || b_scrubbing )
     {
         p_context->skip_frame = __MAX( p_context->skip_frame, AVDISCARD_NONREF );
     }
@@ -1754,6 +1778,8 @@ void EndVideoDec( vlc_object_t *obj )
     if( p_sys->p_va )
         ffmpeg_CloseVa(p_dec, NULL);
 
+    decoder_ReleaseThreads( &p_sys->budget_threads );
+
     free( p_sys );
 }
 
@@ -85,6 +85,8 @@ typedef struct
     Dav1dSettings s;
     Dav1dContext *c;
     cc_data_t cc;
+    decoder_threads_t budget_threads; /* held from the decoder thread budget */
+    bool b_scrubbing;
 } decoder_sys_t;
 
 struct user_data_s
@@ -270,11 +272,42 @@ static void FreePicture(Dav1dPicture *data, void *cookie)
  * Flush: clears decoder between seeks
  ****************************************************************************/
 
+#if DAV1D_API_VERSION_MAJOR > 6 || DAV1D_API_VERSION_MINOR >= 8
+static void SetScrubbing(decoder_sys_t *p_sys, bool b_scrubbing)
+{
+    /* While scrubbing, favour speed over quality */
+    p_sys->s.inloop_filters = b_scrubbing ? DAV1D_INLOOPFILTER_NONE
+                                          : DAV1D_INLOOPFILTER_ALL;
+    p_sys->s.decode_frame_type = b_scrubbing ? DAV1D_DECODEFRAMETYPE_REFERENCE
+                                             : DAV1D_DECODEFRAMETYPE_ALL;
+    p_sys->b_scrubbing = b_scrubbing;
+}
+#endif
+
 static void FlushDecoder(decoder_t *dec)
 {
     decoder_sys_t *p_sys = dec->p_sys;
     dav1d_flush(p_sys->c);
     cc_Flush(&p_sys->cc);
+
+#if DAV1D_API_VERSION_MAJOR > 6 || DAV1D_API_VERSION_MINOR >= 8
+    /* The settings of an opened context can't be changed, reopen it now that
+     * it holds no state to switch the scrubbing mode. */
+    const bool b_scrubbing = decoder_IsScrubbing(dec);
+    if (b_scrubbing != p_sys->b_scrubbing)
+    {
+        Dav1dContext *c;
+        SetScrubbing(p_sys, b_scrubbing);
+        if (dav1d_open(&c, &p_sys->s) < 0)
+        {
+            msg_Warn(dec, "Could not switch the scrubbing mode");
+            SetScrubbing(p_sys, !b_scrubbing);
+            return;
+        }
+        dav1d_close(&p_sys->c);
+        p_sys->c = c;
+    }
+#endif
 }
 
 static void release_block(const uint8_t *buf, void *b)
@@ -433,10 +466,14 @@ static int OpenDecoder(vlc_object_t *p_this)
         return VLC_ENOMEM;
 
     dav1d_default_settings(&p_sys->s);
+    p_sys->budget_threads.count = 0;
 #if DAV1D_API_VERSION_MAJOR >= 6
     p_sys->s.n_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_threads == 0)
-        p_sys->s.n_threads = __MAX(1, vlc_GetCPUCount());
+    {
+        p_sys->s.n_threads = decoder_AcquireThreads(dec, __MAX(1, vlc_GetCPUCount()),
+                                                    &p_sys->budget_threads);
+    }
 
 #if DAV1D_API_VERSION_MAJOR > 6 || DAV1D_API_VERSION_MINOR >= 7
     // after dav1d 1.0.0
@@ -464,9 +501,15 @@ static int OpenDecoder(vlc_object_t *p_this)
         p_sys->s.n_tile_threads = VLC_CLIP(vlc_GetCPUCount(), 1, 4);
     p_sys->s.n_frame_threads = var_InheritInteger(p_this, "dav1d-thread-frames");
     if (p_sys->s.n_frame_threads == 0)
-        p_sys->s.n_frame_threads = __MAX(1, vlc_GetCPUCount());
+    {
+        p_sys->s.n_frame_threads = decoder_AcquireThreads(dec, __MAX(1, vlc_GetCPUCount()),
+                                                          &p_sys->budget_threads);
+    }
 #endif
     p_sys->s.all_layers = var_InheritBool( p_this, "dav1d-all-layers" );
+#if DAV1D_API_VERSION_MAJOR > 6 || DAV1D_API_VERSION_MINOR >= 8
+    SetScrubbing(p_sys, false);
+#endif
     p_sys->s.allocator.cookie = dec;
     p_sys->s.allocator.alloc_picture_callback = NewPicture;
     p_sys->s.allocator.release_picture_callback = FreePicture;
@@ -510,6 +553,7 @@ static int OpenDecoder(vlc_object_t *p_this)
     if (dav1d_open(&p_sys->c, &p_sys->s) < 0)
     {
         msg_Err(p_this, "Could not open the Dav1d decoder");
+        decoder_ReleaseThreads(&p_sys->budget_threads);
         return VLC_EGENERIC;
     }
 
@@ -574,4 +618,6 @@ static void CloseDecoder(vlc_object_t *p_this)
     FlushDecoder(dec);
 
     dav1d_close(&p_sys->c);
+
+    decoder_ReleaseThreads(&p_sys->budget_threads);
 }
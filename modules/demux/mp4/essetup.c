@@ -654,6 +654,8 @@ int SetupVideoES( demux_t *p_demux, const mp4_track_t *p_track, const MP4_Box_t
                 CopyExtradata( BOXDATA(p_avcC)->p_avcC,
                                BOXDATA(p_avcC)->i_avcC,
                                p_fmt );
+                /* one sample per block, with its decoding and presentation times */
+                p_fmt->b_framed = true;
             }
             else
             {
@@ -677,6 +679,7 @@ int SetupVideoES( demux_t *p_demux, const mp4_track_t *p_track, const MP4_Box_t
                 CopyExtradata( p_hvcC->data.p_binary->p_blob,
                                p_hvcC->data.p_binary->i_blob,
                                p_fmt );
+                p_fmt->b_framed = true;
             }
             else
             {
@@ -220,6 +220,128 @@ static void entry_meta_Clean( struct entry_meta_s *e )
 
 static void parseEXTINF( char *, char *(*)(const char *), struct entry_meta_s * );
 
+/*****************************************************************************
+ * Line reader
+ *****************************************************************************
+ * vlc_stream_ReadLine() allocates every line, which dominates the loading
+ * time of large playlists. Lines are instead split in place within a single
+ * buffer. UTF-16 playlists still go through vlc_stream_ReadLine() for the
+ * conversion.
+ *****************************************************************************/
+#define M3U_READ_SIZE 65536
+#define M3U_LINE_MAX (2048*100) /* same limit as vlc_stream_ReadLine() */
+
+struct m3u_reader
+{
+    stream_t *s;
+    char *buf;
+    size_t size;   /* allocated size */
+    size_t begin;  /* start of the next line */
+    size_t end;    /* end of the data read */
+    bool eof;
+    bool convert;  /* UTF-16 */
+};
+
+static int m3u_reader_Init( struct m3u_reader *r, stream_t *s )
+{
+    const uint8_t *p_peek;
+
+    r->s = s;
+    r->buf = NULL;
+    r->size = r->begin = r->end = 0;
+    r->eof = false;
+    r->convert = vlc_stream_Peek( s, &p_peek, 2 ) == 2
+              && ( !memcmp( p_peek, "\xFF\xFE", 2 )
+                || !memcmp( p_peek, "\xFE\xFF", 2 ) );
+    if( !r->convert )
+    {
+        r->buf = malloc( M3U_READ_SIZE );
+        if( unlikely(r->buf == NULL) )
+            return VLC_ENOMEM;
+        r->size = M3U_READ_SIZE;
+    }
+    return VLC_SUCCESS;
+}
+
+static void m3u_reader_Clean( struct m3u_reader *r )
+{
+    free( r->buf );
+}
+
+/**
+ * Returns the next line, valid until the next call, or NULL at the end.
+ */
+static char *m3u_reader_Next( struct m3u_reader *r )
+{
+    if( r->convert )
+    {
+        free( r->buf );
+        r->buf = vlc_stream_ReadLine( r->s );
+        return r->buf;
+    }
+
+    for( ;; )
+    {
+        char *line = r->buf + r->begin;
+        size_t len = r->end - r->begin;
+
+        /* Empty lines between CR and LF are ignored by the parser */
+        char *eol = memchr( line, '\n', len );
+        char *cr = memchr( line, '\r', eol ? (size_t)(eol - line) : len );
+        if( cr != NULL )
+            eol = cr;
+
+        if( eol != NULL )
+        {
+            *eol = '\0';
+            r->begin = eol + 1 - r->buf;
+            return line;
+        }
+
+        if( r->eof )
+        {
+            if( len == 0 )
+                return NULL;
+            /* Last line without EOL: there is always room for the nul */
+            line[len] = '\0';
+            r->begin = r->end;
+            return line;
+        }
+
+        /* Move the incomplete line to the beginning, and read more data */
+        if( r->begin > 0 )
+        {
+            memmove( r->buf, line, len );
+            r->begin = 0;
+            r->end = len;
+        }
+
+        if( r->size - r->end < M3U_READ_SIZE / 2 )
+        {
+            size_t size = r->size ? r->size * 2 : M3U_READ_SIZE;
+            if( size > M3U_LINE_MAX + M3U_READ_SIZE )
+            {
+                msg_Err( r->s, "line too long, exceeding %zu bytes",
+                         (size_t) M3U_LINE_MAX );
+                return NULL;
+            }
+
+            char *buf = realloc( r->buf, size );
+            if( unlikely(buf == NULL) )
+                return NULL;
+            r->buf = buf;
+            r->size = size;
+        }
+
+        ssize_t i_read = vlc_stream_Read( r->s, r->buf + r->end,
+                                          r->size - r->end - 1 );
+        if( i_read <= 0 )
+            r->eof = true;
+        else
+            r->end += i_read;
+    }
+}
+
 static int CreateEntry( input_item_node_t *p_node, const struct entry_meta_s *meta )
 {
     if( !meta->psz_mrl )
@@ -259,11 +381,14 @@ static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
     char       *psz_line;
     char       *psz_group = NULL; /* group is toggling tag */
     struct entry_meta_s meta;
-    entry_meta_Init( &meta );
     char *    (*pf_dup) (const char *) = p_demux->p_sys;
+    struct m3u_reader reader;
 
-    psz_line = vlc_stream_ReadLine( p_demux->s );
-    while( psz_line )
+    if( m3u_reader_Init( &reader, p_demux->s ) )
+        return VLC_ENOMEM;
+    entry_meta_Init( &meta );
+
+    while( ( psz_line = m3u_reader_Next( &reader ) ) != NULL )
     {
         char *psz_parse = psz_line;
 
@@ -280,7 +405,7 @@ static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
                    *psz_parse == '\n' || *psz_parse == '\r' ||
                    *psz_parse == '#' ) psz_parse++;
 
-            if( !*psz_parse ) goto nextline;
+            if( !*psz_parse ) continue;
 
             if( !strncasecmp( psz_parse, "EXTINF:", sizeof("EXTINF:") -1 ) )
             {
@@ -305,7 +430,7 @@ static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
                 /* VLC Option */
                 char *psz_option;
                 psz_parse += sizeof("EXTVLCOPT:") -1;
-                if( !*psz_parse ) goto nextline;
+                if( !*psz_parse ) continue;
 
                 psz_option = pf_dup( psz_parse );
                 if( psz_option )
@@ -337,34 +462,28 @@ static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
         else if( *psz_parse )
         {
             psz_parse = pf_dup( psz_parse );
-            if( !meta.psz_name && psz_parse )
-                /* Use filename as name for relative entries */
-                meta.psz_name = strdup( psz_parse );
             if( psz_group && !meta.psz_grouptitle )
                 meta.psz_grouptitle = strdup( psz_group );
 
             meta.psz_mrl = ProcessMRL( psz_parse, p_demux->psz_url );
-            free( psz_parse );
+            if( !meta.psz_name )
+                /* Use filename as name for relative entries */
+                meta.psz_name = psz_parse;
+            else
+                free( psz_parse );
 
-            CreateEntry( p_subitems, &meta );
+            if( CreateEntry( p_subitems, &meta ) == VLC_SUCCESS )
+                PlaylistPostBatch( p_demux, p_subitems );
 
             /* Cleanup state after entry */
             entry_meta_Clean( &meta );
             entry_meta_Init( &meta );
         }
-
- nextline:
-        /* Fetch another line */
-        free( psz_line );
-        psz_line = vlc_stream_ReadLine( p_demux->s );
-        if( !psz_line )
-        {
-            /* Cleanup state */
-            entry_meta_Clean( &meta );
-            entry_meta_Init( &meta );
-            free( psz_group );
-        }
     }
+
+    entry_meta_Clean( &meta );
+    free( psz_group );
+    m3u_reader_Clean( &reader );
     return VLC_SUCCESS; /* Needed for correct operation of go back */
 }
 
@@ -30,6 +30,7 @@
 #include <vlc_common.h>
 #include <vlc_plugin.h>
 #include <vlc_demux.h>
+#include <vlc_es_out.h>
 #include <vlc_url.h>
 #include <vlc_access.h>
 
@@ -213,3 +214,39 @@ int PlaylistControl( stream_t *p_access, int i_query, va_list args )
             return access_vaDirectoryControlHelper( p_access, i_query, args );
     }
 }
+
+/* Number of items handed over at once while reading a playlist */
+#define PLAYLIST_BATCH_SIZE 512
+
+/**
+ * Hands over the items read so far.
+ *
+ * Large playlists can then be inserted progressively while they are read,
+ * if the owner of the input accepts partial subtrees. Otherwise, the items
+ * are kept in the node, to be posted at the end.
+ */
+void PlaylistPostBatch(stream_t *p_demux, input_item_node_t *p_subitems)
+{
+    if (p_subitems->i_children == 0
+     || p_subitems->i_children % PLAYLIST_BATCH_SIZE != 0
+     || p_demux->out == NULL)
+        return;
+
+    input_item_node_t *p_batch = input_item_node_Create(p_subitems->p_item);
+    if (unlikely(p_batch == NULL))
+        return;
+
+    p_batch->i_children = p_subitems->i_children;
+    p_batch->pp_children = p_subitems->pp_children;
+    p_subitems->i_children = 0;
+    p_subitems->pp_children = NULL;
+
+    if (es_out_Control(p_demux->out, ES_OUT_POST_PARTIAL_SUBNODE, p_batch))
+    {
+        p_subitems->i_children = p_batch->i_children;
+        p_subitems->pp_children = p_batch->pp_children;
+        p_batch->i_children = 0;
+        p_batch->pp_children = NULL;
+        input_item_node_Delete(p_batch);
+    }
+}
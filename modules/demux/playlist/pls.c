@@ -142,6 +142,7 @@ static int ReadDir( stream_t *p_demux, input_item_node_t *p_subitems )
                 input_item_Release( p_input );
                 free( psz_mrl_orig );
                 psz_mrl_orig = psz_mrl = NULL;
+                PlaylistPostBatch( p_demux, p_subitems );
             }
             else
             {
@@ -47,8 +47,31 @@ typedef struct vlc_tls_gnutls
     vlc_tls_t tls;
     gnutls_session_t session;
     vlc_object_t *obj;
+    struct gnutls_client *client; /**< client credentials (or NULL) */
+    char *origin; /**< session cache key (or NULL) */
+    bool started;
 } vlc_tls_gnutls_t;
 
+/** Maximum number of resumable sessions kept per client credentials */
+#define GNUTLS_SESSION_CACHE_SIZE 32
+
+struct gnutls_cached_session
+{
+    struct gnutls_cached_session *next;
+    gnutls_datum_t data;
+    char origin[];
+};
+
+/**
+ * Client-side credentials private data
+ */
+struct gnutls_client
+{
+    gnutls_certificate_credentials_t x509;
+    vlc_mutex_t lock;
+    struct gnutls_cached_session *sessions; /**< most recent first */
+};
+
 static void gnutls_Banner(vlc_object_t *obj)
 {
     msg_Dbg(obj, "using GnuTLS v%s (built with v"GNUTLS_VERSION")",
@@ -203,10 +226,86 @@ static int gnutls_Shutdown(vlc_tls_t *tls, bool duplex)
     return 0;
 }
 
+static void gnutls_SessionSave(vlc_tls_gnutls_t *priv)
+{
+    struct gnutls_client *client = priv->client;
+    gnutls_datum_t data;
+
+    /* With TLS 1.3, tickets are received after the handshake, so the
+     * session parameters are saved when the session ends. */
+    if (gnutls_session_get_data2(priv->session, &data))
+        return;
+
+    size_t len = strlen(priv->origin) + 1;
+    struct gnutls_cached_session *entry = malloc(sizeof (*entry) + len);
+    if (unlikely(entry == NULL))
+    {
+        gnutls_free(data.data);
+        return;
+    }
+
+    entry->data = data;
+    memcpy(entry->origin, priv->origin, len);
+
+    vlc_mutex_lock(&client->lock);
+    struct gnutls_cached_session **pp = &client->sessions, *old = NULL;
+    unsigned count = 0;
+
+    entry->next = client->sessions;
+    client->sessions = entry;
+
+    /* Drop the previous session for that origin, and the oldest ones */
+    while (*pp != NULL)
+    {
+        struct gnutls_cached_session *e = *pp;
+
+        if ((e != entry && !strcmp(e->origin, entry->origin))
+         || ++count > GNUTLS_SESSION_CACHE_SIZE)
+        {
+            *pp = e->next;
+            e->next = old;
+            old = e;
+        }
+        else
+            pp = &e->next;
+    }
+    vlc_mutex_unlock(&client->lock);
+
+    while (old != NULL)
+    {
+        struct gnutls_cached_session *next = old->next;
+
+        gnutls_free(old->data.data);
+        free(old);
+        old = next;
+    }
+}
+
+static void gnutls_SessionRestore(vlc_tls_gnutls_t *priv)
+{
+    struct gnutls_client *client = priv->client;
+
+    vlc_mutex_lock(&client->lock);
+    for (struct gnutls_cached_session *e = client->sessions;
+         e != NULL; e = e->next)
+        if (!strcmp(e->origin, priv->origin))
+        {
+            gnutls_session_set_data(priv->session, e->data.data,
+                                    e->data.size);
+            break;
+        }
+    vlc_mutex_unlock(&client->lock);
+}
+
 static void gnutls_Close (vlc_tls_t *tls)
 {
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
 
+    if (priv->origin != NULL)
+    {
+        gnutls_SessionSave(priv);
+        free(priv->origin);
+    }
     gnutls_deinit(priv->session);
     free(priv);
 }
@@ -297,6 +396,9 @@ static vlc_tls_gnutls_t *gnutls_SessionOpen(vlc_object_t *obj, int type,
 
     priv->session = session;
     priv->obj = obj;
+    priv->client = NULL;
+    priv->origin = NULL;
+    priv->started = false;
 
     vlc_tls_t *tls = &priv->tls;
 
@@ -379,11 +481,14 @@ static vlc_tls_t *gnutls_ClientSessionOpen(vlc_tls_client_t *crd,
                                            vlc_tls_t *sk, const char *hostname,
                                            const char *const *alpn)
 {
+    struct gnutls_client *client = crd->sys;
     vlc_tls_gnutls_t *priv = gnutls_SessionOpen(VLC_OBJECT(crd), GNUTLS_CLIENT,
-                                                crd->sys, sk, alpn);
+                                                client->x509, sk, alpn);
     if (priv == NULL)
         return NULL;
 
+    priv->client = client;
+
     gnutls_session_t session = priv->session;
 
     if (likely(hostname != NULL))
@@ -401,10 +506,23 @@ static int gnutls_ClientHandshake(vlc_tls_t *tls,
     vlc_tls_gnutls_t *priv = (vlc_tls_gnutls_t *)tls;
     vlc_object_t *obj = priv->obj;
 
+    if (!priv->started)
+    {   /* Try to resume the last session with the same server */
+        priv->started = true;
+        if (host != NULL && service != NULL
+         && asprintf(&priv->origin, "%s:%s", host, service) >= 0)
+            gnutls_SessionRestore(priv);
+        else
+            priv->origin = NULL;
+    }
+
     int val = gnutls_Handshake(tls, alp);
     if (val)
         return val;
 
+    if (gnutls_session_is_resumed(priv->session))
+        msg_Dbg(obj, " - session resumed");
+
     /* certificates chain verification */
     gnutls_session_t session = priv->session;
     unsigned status;
@@ -530,9 +648,18 @@ error:
 
 static void gnutls_ClientDestroy(vlc_tls_client_t *crd)
 {
-    gnutls_certificate_credentials_t x509 = crd->sys;
+    struct gnutls_client *client = crd->sys;
 
-    gnutls_certificate_free_credentials(x509);
+    while (client->sessions != NULL)
+    {
+        struct gnutls_cached_session *e = client->sessions;
+
+        client->sessions = e->next;
+        gnutls_free(e->data.data);
+        free(e);
+    }
+    gnutls_certificate_free_credentials(client->x509);
+    free(client);
 }
 
 static const struct vlc_tls_client_operations gnutls_ClientOps =
@@ -551,11 +678,16 @@ static int OpenClient(vlc_tls_client_t *crd)
 
     gnutls_Banner(VLC_OBJECT(crd));
 
+    struct gnutls_client *client = malloc(sizeof (*client));
+    if (unlikely(client == NULL))
+        return VLC_ENOMEM;
+
     int val = gnutls_certificate_allocate_credentials (&x509);
     if (val != 0)
     {
         msg_Err (crd, "cannot allocate credentials: %s",
                  gnutls_strerror (val));
+        free(client);
         return VLC_EGENERIC;
     }
 
@@ -585,8 +717,12 @@ static int OpenClient(vlc_tls_client_t *crd)
     gnutls_certificate_set_verify_flags (x509,
                                          GNUTLS_VERIFY_ALLOW_X509_V1_CA_CRT);
 
+    client->x509 = x509;
+    vlc_mutex_init(&client->lock);
+    client->sessions = NULL;
+
     crd->ops = &gnutls_ClientOps;
-    crd->sys = x509;
+    crd->sys = client;
     return VLC_SUCCESS;
 }
 
@@ -57,6 +57,18 @@
     "Create \"Fast Start\" files. " \
     "\"Fast Start\" files are optimized for downloads and allow the user " \
     "to start previewing the file while it is downloading.")
+#define MOOV_SPACE_TEXT N_("Space reserved for the index (kB)")
+#define MOOV_SPACE_LONGTEXT N_(\
+    "Reserve space at the start of the file for the index (\"moov\" box), " \
+    "so that \"Fast Start\" files can be finished without moving the whole " \
+    "data. If 0, the space is estimated from the expected duration. " \
+    "If the index does not fit, it is written at the end of the file " \
+    "(or the data is moved in \"Fast Start\" mode).")
+#define MOOV_DURATION_TEXT N_("Expected duration (s)")
+#define MOOV_DURATION_LONGTEXT N_(\
+    "Expected duration of the file, used to estimate the space reserved " \
+    "for the index from the sample rates of the tracks. " \
+    "If 0, no space is reserved unless set explicitly.")
 
 static int  Open   (vlc_object_t *);
 static void Close  (vlc_object_t *);
@@ -71,6 +83,10 @@ vlc_module_begin ()
 
     add_bool(SOUT_CFG_PREFIX "faststart", false,
               FASTSTART_TEXT, FASTSTART_LONGTEXT)
+    add_integer_with_range(SOUT_CFG_PREFIX "moov-space", 0, 0, 1024 * 1024,
+              MOOV_SPACE_TEXT, MOOV_SPACE_LONGTEXT)
+    add_integer_with_range(SOUT_CFG_PREFIX "moov-duration", 0, 0, 24 * 3600,
+              MOOV_DURATION_TEXT, MOOV_DURATION_LONGTEXT)
     set_capability("sout mux", 5)
     add_shortcut("mp4", "mov", "3gp")
     set_callbacks(Open, Close)
@@ -89,7 +105,7 @@ vlc_module_end ()
  * Exported prototypes
  *****************************************************************************/
 static const char *const ppsz_sout_options[] = {
-    "faststart", NULL
+    "faststart", "moov-space", "moov-duration", NULL
 };
 
 static int Control(sout_mux_t *, int, va_list);
@@ -165,6 +181,8 @@ typedef struct
 
     uint64_t i_mdat_pos;
     uint64_t i_pos;
+    uint64_t i_moov_space_pos;
+    uint32_t i_moov_space; /* reserved for the moov, 0 if none */
     vlc_tick_t  i_read_duration;
     vlc_tick_t  i_start_dts;
 
@@ -248,6 +266,48 @@ static void ReorderStreams(mp4_stream_t **pp_streams, unsigned int i_streams)
         mp4mux_track_ChangeID(pp_streams[i]->tinfo, i+1);
 }
 
+/* Upper bound of the index size for the expected duration: per sample, the
+ * size (stsz), timestamps (stts, ctts), sync flag (stss) and chunk offset
+ * (co64) entries, plus the headers and codec configurations. */
+static uint64_t EstimateMoovSize(sout_mux_t *p_mux, unsigned i_duration)
+{
+    sout_mux_sys_t *p_sys = p_mux->p_sys;
+    uint64_t i_size = 64 * 1024;
+
+    for (unsigned i = 0; i < p_sys->i_nb_streams; i++)
+    {
+        const es_format_t *p_fmt =
+            mp4mux_track_GetFmt(p_sys->pp_streams[i]->tinfo);
+        unsigned i_rate, i_entry;
+
+        switch (p_fmt->i_cat)
+        {
+            case VIDEO_ES:
+                i_rate = 30;
+                if (p_fmt->video.i_frame_rate > 0
+                 && p_fmt->video.i_frame_rate_base > 0)
+                    i_rate = 1 + p_fmt->video.i_frame_rate
+                                 / p_fmt->video.i_frame_rate_base;
+                i_entry = 4 + 8 + 8 + 4 + 8;
+                break;
+            case AUDIO_ES:
+                i_rate = 50;
+                if (p_fmt->audio.i_rate > 0 && p_fmt->audio.i_frame_length > 0)
+                    i_rate = 1 + p_fmt->audio.i_rate
+                                 / p_fmt->audio.i_frame_length;
+                i_entry = 4 + 8 + 8;
+                break;
+            default:
+                i_rate = 2;
+                i_entry = 4 + 8 + 8;
+                break;
+        }
+        i_size += 4096 + p_fmt->i_extra
+                + (uint64_t)i_rate * i_duration * i_entry;
+    }
+    return i_size;
+}
+
 static int WriteSlowStartHeader(sout_mux_t *p_mux)
 {
     sout_mux_sys_t *p_sys = p_mux->p_sys;
@@ -265,6 +325,38 @@ static int WriteSlowStartHeader(sout_mux_t *p_mux)
         box_send(p_mux, box);
     }
 
+    /* Reserve space for the moov, as a free box until it is written */
+    uint64_t i_moov_space = var_GetInteger(p_mux, SOUT_CFG_PREFIX "moov-space")
+                          * 1024;
+    if (i_moov_space == 0)
+    {
+        int64_t i_duration = var_GetInteger(p_mux,
+                                            SOUT_CFG_PREFIX "moov-duration");
+        if (i_duration > 0)
+        {
+            i_moov_space = __MIN(EstimateMoovSize(p_mux, i_duration),
+                                 1024 * 1024 * 1024);
+            msg_Dbg(p_mux, "reserving %"PRIu64" bytes for the index",
+                    i_moov_space);
+        }
+    }
+    if (i_moov_space > 0)
+    {
+        block_t *p_free = block_Alloc(i_moov_space);
+        if (!p_free)
+            return VLC_ENOMEM;
+
+        memset(p_free->p_buffer, 0, p_free->i_buffer);
+        SetDWBE(p_free->p_buffer, p_free->i_buffer);
+        memcpy(&p_free->p_buffer[4], "free", 4);
+
+        p_sys->i_moov_space_pos = p_sys->i_pos;
+        p_sys->i_moov_space = p_free->i_buffer;
+        p_sys->i_pos += p_free->i_buffer;
+        p_sys->i_mdat_pos = p_sys->i_pos;
+        sout_AccessOutWrite(p_mux->p_access, p_free);
+    }
+
     /* Now add mdat header */
     box = box_new("mdat");
     if(!box)
@@ -310,6 +402,8 @@ static int Open(vlc_object_t *p_this)
     p_sys->i_nb_streams = 0;
     p_sys->pp_streams   = NULL;
     p_sys->i_mdat_pos   = 0;
+    p_sys->i_moov_space_pos = 0;
+    p_sys->i_moov_space = 0;
     p_sys->b_header_sent = false;
 
     p_sys->i_read_duration   = 0;
@@ -377,6 +471,34 @@ static void Close(vlc_object_t *p_this)
 
     /* Check we need to create "fast start" files */
     p_sys->b_fast_start = var_GetBool(p_this, SOUT_CFG_PREFIX "faststart");
+
+    /* Write the moov in the reserved space if it fits, leaving a free box
+     * for the remaining space */
+    if (p_sys->i_moov_space > 0 && moov && moov->b)
+    {
+        size_t i_moov = bo_size(moov);
+        if (i_moov == p_sys->i_moov_space || i_moov + 8 <= p_sys->i_moov_space)
+        {
+            if (i_moov < p_sys->i_moov_space)
+            {
+                if (!bo_init(&bo, 8))
+                {
+                    bo_free(moov);
+                    goto cleanup;
+                }
+                bo_add_32be  (&bo, p_sys->i_moov_space - i_moov);
+                bo_add_fourcc(&bo, "free");
+                sout_AccessOutSeek(p_mux->p_access,
+                                   p_sys->i_moov_space_pos + i_moov);
+                sout_AccessOutWrite(p_mux->p_access, bo.b);
+            }
+            i_moov_pos = p_sys->i_moov_space_pos;
+            p_sys->b_fast_start = false;
+        }
+        else
+            msg_Warn(p_this, "index size %zu exceeds the reserved space (%"PRIu32
+                     " bytes)", i_moov, p_sys->i_moov_space);
+    }
     while (p_sys->b_fast_start && moov && moov->b)
     {
         /* Move data to the end of the file so we can fit the moov header
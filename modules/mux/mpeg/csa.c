@@ -38,6 +38,11 @@ struct csa_t
 {
     bool    use_odd;
     struct dvbcsa_key_s *keys[2];
+    struct dvbcsa_bs_key_s *bs_keys[2];
+
+    /* bitsliced batch, terminated by a NULL entry */
+    struct dvbcsa_bs_batch_s *batch;
+    unsigned batch_size;
 };
 
 /*****************************************************************************
@@ -46,17 +51,22 @@ struct csa_t
 csa_t *csa_New( void )
 {
     csa_t *csa = calloc( 1, sizeof( csa_t ) );
-    if(csa)
+    if( !csa )
+        return NULL;
+
+    csa->batch_size = dvbcsa_bs_batch_size();
+    csa->batch = vlc_alloc( csa->batch_size + 1, sizeof(*csa->batch) );
+    for( int i = 0; i < 2; i++ )
     {
-        csa->keys[0] = dvbcsa_key_alloc();
-        if(csa->keys[0])
-            csa->keys[1] = dvbcsa_key_alloc();
-        if(csa->keys[1])
-            return csa;
-        else
-            dvbcsa_key_free(csa->keys[0]);
+        csa->keys[i] = dvbcsa_key_alloc();
+        csa->bs_keys[i] = dvbcsa_bs_key_alloc();
     }
-    free(csa);
+
+    if( csa->batch && csa->keys[0] && csa->keys[1]
+     && csa->bs_keys[0] && csa->bs_keys[1] )
+        return csa;
+
+    csa_Delete( csa );
     return NULL;
 }
 
@@ -65,8 +75,14 @@ csa_t *csa_New( void )
  *****************************************************************************/
 void csa_Delete( csa_t *c )
 {
-    dvbcsa_key_free( c->keys[0] );
-    dvbcsa_key_free( c->keys[1] );
+    for( int i = 0; i < 2; i++ )
+    {
+        if( c->keys[i] )
+            dvbcsa_key_free( c->keys[i] );
+        if( c->bs_keys[i] )
+            dvbcsa_bs_key_free( c->bs_keys[i] );
+    }
+    free( c->batch );
     free( c );
 }
 
@@ -104,6 +120,7 @@ int csa_SetCW( vlc_object_t *p_caller, csa_t *c, char *psz_ck, bool set_odd )
 # endif
 
         dvbcsa_key_set( ck, c->keys[set_odd ? 1 : 0] );
+        dvbcsa_bs_key_set( ck, c->bs_keys[set_odd ? 1 : 0] );
 
         return VLC_SUCCESS;
     }
@@ -158,44 +175,76 @@ void csa_Decrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
     dvbcsa_decrypt( key, &pkt[i_hdr], i_pkt_size - i_hdr );
 }
 
-/*****************************************************************************
- * csa_Encrypt:
- *****************************************************************************/
-void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
+/* Sets the transport scrambling control and returns the header length, or 0
+ * if the payload is too short to be scrambled */
+static int csa_PrepareEncrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
 {
     int i_hdr = 4; /* hdr len */
-    int n;
 
     /* set transport scrambling control */
     pkt[3] |= 0x80;
-
-    struct dvbcsa_key_s *key;
     if( c->use_odd )
-    {
         pkt[3] |= 0x40;
-        key = c->keys[1];
-    }
-    else
-    {
-        key = c->keys[0];
-    }
 
-    /* hdr len */
-    i_hdr = 4;
     if( pkt[3]&0x20 )
     {
         /* skip adaption field */
         i_hdr += pkt[4] + 1;
     }
-    n = (i_pkt_size - i_hdr) / 8;
 
-    if( n <= 0 )
+    if( (i_pkt_size - i_hdr) / 8 <= 0 )
     {
         pkt[3] &= 0x3f;
+        return 0;
+    }
+    return i_hdr;
+}
+
+/*****************************************************************************
+ * csa_Encrypt:
+ *****************************************************************************/
+void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
+{
+    int i_hdr = csa_PrepareEncrypt( c, pkt, i_pkt_size );
+    if( i_hdr == 0 )
         return;
+
+    dvbcsa_encrypt( c->keys[c->use_odd ? 1 : 0], &pkt[i_hdr],
+                    i_pkt_size - i_hdr );
+}
+
+/*****************************************************************************
+ * csa_EncryptBatch:
+ *****************************************************************************/
+void csa_EncryptBatch( csa_t *c, uint8_t **pkts, size_t i_pkts, int i_pkt_size )
+{
+    const struct dvbcsa_bs_key_s *key = c->bs_keys[c->use_odd ? 1 : 0];
+    /* the bitsliced API requires a multiple of 8 */
+    unsigned i_maxlen = __MIN( ((i_pkt_size - 4) + 7) & ~7, 184 );
+    unsigned n = 0;
+
+    for( size_t i = 0; i < i_pkts; i++ )
+    {
+        uint8_t *pkt = pkts[i];
+        int i_hdr = csa_PrepareEncrypt( c, pkt, i_pkt_size );
+        if( i_hdr == 0 )
+            continue;
+
+        c->batch[n].data = &pkt[i_hdr];
+        c->batch[n].len = i_pkt_size - i_hdr;
+        if( ++n == c->batch_size )
+        {
+            c->batch[n].data = NULL;
+            dvbcsa_bs_encrypt( key, c->batch, i_maxlen );
+            n = 0;
+        }
     }
 
-    dvbcsa_encrypt(key, &pkt[i_hdr], i_pkt_size - i_hdr);
+    if( n > 0 )
+    {
+        c->batch[n].data = NULL;
+        dvbcsa_bs_encrypt( key, c->batch, i_maxlen );
+    }
 }
 #else
 
@@ -239,4 +288,12 @@ void csa_Encrypt( csa_t *c, uint8_t *pkt, int i_pkt_size )
     VLC_UNUSED(i_pkt_size);
 }
 
+void csa_EncryptBatch( csa_t *c, uint8_t **pkts, size_t i_pkts, int i_pkt_size )
+{
+    VLC_UNUSED(c);
+    VLC_UNUSED(pkts);
+    VLC_UNUSED(i_pkts);
+    VLC_UNUSED(i_pkt_size);
+}
+
 #endif
@@ -34,4 +34,9 @@ void   csa_UseKey( vlc_object_t *p_caller, csa_t *, bool use_odd );
 void   csa_Decrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 void   csa_Encrypt( csa_t *, uint8_t *pkt, int i_pkt_size );
 
+/* Scrambles several packets at once with the current key, using the
+ * bitsliced implementation (much faster than calling csa_Encrypt() for each
+ * packet) */
+void   csa_EncryptBatch( csa_t *, uint8_t **pkts, size_t i_pkts, int i_pkt_size );
+
 #endif /* _CSA_H */
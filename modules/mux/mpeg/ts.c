@@ -191,6 +191,7 @@ static_assert (MAX_SDT_DESC >= MAX_PMT, "MAX_SDT_DESC < MAX_PMT");
 
 #define BLOCK_FLAG_NO_KEYFRAME (1 << BLOCK_FLAG_PRIVATE_SHIFT) /* This is not a key frame for bitrate shaping */
 #define BLOCK_FLAG_FOR_PCR     (1 << (BLOCK_FLAG_PRIVATE_SHIFT+1))
+#define TS_CSA_BATCH           64 /* Maximum packets scrambled in one batch */
 
 vlc_module_begin ()
     set_description( N_("TS muxer (libdvbpsi)") )
@@ -1116,6 +1117,10 @@ static block_t *Encap_J2K( block_t *p_data, const es_format_t *p_fmt )
     }
     else
     {
+        /* The header is written over the skipped boxes */
+        p_data = vlc_frame_MakeWritable( p_data );
+        if( unlikely(!p_data) )
+            return NULL;
         p_data->p_buffer += (i_offset - 38);
         p_data->i_buffer -= (i_offset - 38);
     }
@@ -1723,6 +1728,13 @@ static int TSSchedule( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     return VLC_SUCCESS;
 }
 
+static void TSScramble( sout_mux_sys_t *p_sys, uint8_t **pp_pkts, size_t i_pkts )
+{
+    vlc_mutex_lock( &p_sys->csa_lock );
+    csa_EncryptBatch( p_sys->csa, pp_pkts, i_pkts, p_sys->i_csa_pkt_size );
+    vlc_mutex_unlock( &p_sys->csa_lock );
+}
+
 static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
                    vlc_tick_t i_pcr_length, vlc_tick_t i_pcr_dts )
 {
@@ -1739,6 +1751,9 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
     /* msg_Dbg( p_mux, "real pck=%d", i_packet_count ); */
     block_t *p_list = NULL;
     block_t **pp_last = &p_list;
+    /* scrambled packets are encrypted in batches before being written */
+    uint8_t *pp_scrambled[TS_CSA_BATCH];
+    size_t i_scrambled = 0;
     for (int i = 0; i < i_packet_count; i++ )
     {
         block_t *p_ts = BufferChainGet( p_chain_ts );
@@ -1754,9 +1769,12 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
         }
         if( p_ts->i_flags & BLOCK_FLAG_SCRAMBLED )
         {
-            vlc_mutex_lock( &p_sys->csa_lock );
-            csa_Encrypt( p_sys->csa, p_ts->p_buffer, p_sys->i_csa_pkt_size );
-            vlc_mutex_unlock( &p_sys->csa_lock );
+            pp_scrambled[i_scrambled++] = p_ts->p_buffer;
+            if( i_scrambled == ARRAY_SIZE(pp_scrambled) )
+            {
+                TSScramble( p_sys, pp_scrambled, i_scrambled );
+                i_scrambled = 0;
+            }
         }
 
         /* latency */
@@ -1764,6 +1782,9 @@ static int TSDate( sout_mux_t *p_mux, sout_buffer_chain_t *p_chain_ts,
 
         block_ChainLastAppend( &pp_last, p_ts );
     }
+    if( i_scrambled > 0 )
+        TSScramble( p_sys, pp_scrambled, i_scrambled );
+
     ssize_t written = 0;
     if ( p_list != NULL )
         written = sout_AccessOutWrite( p_mux->p_access, p_list );
@@ -140,6 +140,7 @@ typedef struct
 
 static block_t *Packetize( decoder_t *, block_t ** );
 static block_t *PacketizeAVC1( decoder_t *, block_t ** );
+static block_t *PacketizeAVC1Framed( decoder_t *, block_t ** );
 static block_t *GetCc( decoder_t *p_dec, decoder_cc_desc_t * );
 static void PacketizeFlush( decoder_t * );
 
@@ -155,9 +156,11 @@ static inline block_t *ParseNALBlockW( void *opaque, bool *pb_ts_used, block_t *
 }
 
 static block_t *OutputPicture( decoder_t *p_dec );
+static int GetPicStructFlags( const decoder_sys_t *, const h264_sequence_parameter_set_t * );
+static void ResetOutputVariables( decoder_sys_t *p_sys );
 static void ReleaseXPS( decoder_sys_t *p_sys );
 static bool PutXPS( decoder_t *p_dec, uint8_t i_nal_type, block_t *p_frag );
-static h264_slice_t * ParseSliceHeader( decoder_t *p_dec, const block_t *p_frag );
+static h264_slice_t * ParseSliceHeader( decoder_t *p_dec, const uint8_t *, size_t );
 static bool ParseSeiCallback( const hxxx_sei_data_t *, void * );
 
 
@@ -392,7 +395,10 @@ static int Open( vlc_object_t *p_this )
         }
 
         /* Set callback */
-        p_dec->pf_packetize = PacketizeAVC1;
+        if( p_dec->fmt_in->b_framed && p_sys->i_avcC_length_size == 4 )
+            p_dec->pf_packetize = PacketizeAVC1Framed;
+        else
+            p_dec->pf_packetize = PacketizeAVC1;
     }
     else
     {
@@ -422,7 +428,8 @@ static int Open( vlc_object_t *p_this )
             return VLC_EGENERIC;
         }
 
-        msg_Dbg( p_dec, "Packetizer fed with AVC, nal length size=%d",
+        msg_Dbg( p_dec, "Packetizer fed with %sAVC, nal length size=%d",
+                         p_dec->pf_packetize == PacketizeAVC1Framed ? "framed " : "",
                          p_sys->i_avcC_length_size );
     }
 
@@ -487,6 +494,153 @@ static block_t *PacketizeAVC1( decoder_t *p_dec, block_t **pp_block )
                           ParseNALBlockW, PacketizeDrain );
 }
 
+/****************************************************************************
+ * PacketizeAVC1Framed: Takes complete AVC access units with valid timestamps
+ * Converts them to annexe B in place, only parsing the parameter sets, SEI
+ * and first slice header to set the output properties
+ ****************************************************************************/
+struct framed_au
+{
+    decoder_t *p_dec;
+    const uint8_t *p_start;
+    size_t i_aud; /* size of the leading access unit delimiter */
+    bool b_sps, b_pps;
+};
+
+static void ParseFramedNAL( void *opaque, const uint8_t *p_nal, size_t i_nal )
+{
+    struct framed_au *p_ctx = opaque;
+    decoder_t *p_dec = p_ctx->p_dec;
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    if( i_nal < 5 )
+        return;
+
+    const enum h264_nal_unit_type_e i_nal_type = h264_getNALType( &p_nal[4] );
+    switch( i_nal_type )
+    {
+        case H264_NAL_SLICE:
+        case H264_NAL_SLICE_IDR:
+            if( p_sys->p_slice == NULL )
+                p_sys->p_slice = ParseSliceHeader( p_dec, p_nal, i_nal );
+            break;
+
+        case H264_NAL_AU_DELIMITER:
+            if( p_nal == p_ctx->p_start )
+                p_ctx->i_aud = i_nal;
+            break;
+
+        case H264_NAL_SPS:
+        case H264_NAL_PPS:
+        case H264_NAL_SPS_EXT:
+        {
+            if( i_nal_type == H264_NAL_SPS )
+                p_ctx->b_sps = true;
+            else if( i_nal_type == H264_NAL_PPS )
+                p_ctx->b_pps = true;
+
+            block_t *p_frag = block_Alloc( i_nal );
+            if( p_frag )
+            {
+                memcpy( p_frag->p_buffer, p_nal, i_nal );
+                PutXPS( p_dec, i_nal_type, p_frag );
+            }
+            break;
+        }
+
+        case H264_NAL_SEI:
+            /* the pic timing needs the sets of the previous slice */
+            if( p_sys->p_active_sps != NULL )
+                HxxxParse_AnnexB_SEI( p_nal, i_nal, 1 /* nal header */,
+                                      ParseSeiCallback, p_dec );
+            break;
+
+        case H264_NAL_END_OF_SEQ:
+        case H264_NAL_END_OF_STREAM:
+            p_sys->i_next_block_flags |= BLOCK_FLAG_END_OF_SEQUENCE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static block_t *PacketizeAVC1Framed( decoder_t *p_dec, block_t **pp_block )
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    /* nothing is ever buffered */
+    if( !pp_block || !*pp_block )
+        return NULL;
+
+    /* the length prefixes are overwritten */
+    block_t *p_au = vlc_frame_MakeWritable( *pp_block );
+    *pp_block = NULL;
+    if( !p_au )
+        return NULL;
+
+    struct framed_au ctx = {
+        .p_dec = p_dec,
+        .p_start = p_au->p_buffer,
+    };
+
+    if( (p_au->i_flags & BLOCK_FLAG_CORRUPTED) ||
+        !hxxx_AUToAnnexB( p_au, ParseFramedNAL, &ctx ) )
+    {
+        msg_Warn( p_dec, "Broken access unit" );
+        goto drop;
+    }
+
+    if( !p_sys->p_slice || !p_sys->p_active_sps )
+        goto drop;
+
+    const enum h264_slice_type_e i_slice_type = h264_get_slice_type( p_sys->p_slice );
+
+    /* Sets are inserted on keyframes, as in the reassembling mode */
+    if( i_slice_type == H264_SLICE_TYPE_I && !(ctx.b_sps && ctx.b_pps) )
+    {
+        block_t *p_xpsnal = GatherSets( p_sys, true, true );
+        if( p_xpsnal )
+        {
+            p_au = hxxx_AUInsertSets( p_au, ctx.i_aud, p_xpsnal );
+            if( !p_au )
+            {
+                ResetOutputVariables( p_sys );
+                cc_storage_reset( p_sys->p_ccs );
+                return NULL;
+            }
+        }
+    }
+
+    p_au->i_flags |= GetPicStructFlags( p_sys, p_sys->p_active_sps );
+    switch( i_slice_type )
+    {
+        case H264_SLICE_TYPE_P:
+            p_au->i_flags |= BLOCK_FLAG_TYPE_P;
+            break;
+        case H264_SLICE_TYPE_B:
+            p_au->i_flags |= BLOCK_FLAG_TYPE_B;
+            break;
+        case H264_SLICE_TYPE_I:
+            p_au->i_flags |= BLOCK_FLAG_TYPE_I;
+        default:
+            break;
+    }
+    p_au->i_flags |= p_sys->i_next_block_flags;
+    p_sys->i_next_block_flags = 0;
+
+    ResetOutputVariables( p_sys );
+    cc_storage_commit( p_sys->p_ccs, p_au );
+
+    return p_au;
+
+drop:
+    ResetOutputVariables( p_sys );
+    cc_storage_reset( p_sys->p_ccs );
+    block_Release( p_au );
+    return NULL;
+}
+
 /*****************************************************************************
  * GetCc:
  *****************************************************************************/
@@ -612,7 +766,8 @@ static block_t *ParseNALBlock( decoder_t *p_dec, bool *pb_ts_used, block_t *p_fr
                 p_sys->i_recoveryfnum = UINT_MAX;
             }
 
-            if( (p_newslice = ParseSliceHeader( p_dec, p_frag )) )
+            if( (p_newslice = ParseSliceHeader( p_dec, p_frag->p_buffer,
+                                                      p_frag->i_buffer )) )
             {
                 /* Only IDR carries the id, to be propagated */
                 h264_slice_copy_idr_id( p_sys->p_slice, p_newslice );
@@ -747,6 +902,32 @@ static block_t *ParseNALBlock( decoder_t *p_dec, bool *pb_ts_used, block_t *p_fr
     return p_pic;
 }
 
+static int GetPicStructFlags( const decoder_sys_t *p_sys,
+                              const h264_sequence_parameter_set_t *p_sps )
+{
+    if( h264_is_frames_only( p_sps ) || p_sys->i_pic_struct == UINT8_MAX )
+        return 0;
+
+    switch( p_sys->i_pic_struct )
+    {
+        /* Top and Bottom field slices */
+        case 1:
+        case 2:
+            return BLOCK_FLAG_SINGLE_FIELD |
+                   (h264_slice_top_field(p_sys->p_slice) ? BLOCK_FLAG_TOP_FIELD_FIRST
+                                                         : BLOCK_FLAG_BOTTOM_FIELD_FIRST);
+        /* Each of the following slices contains multiple fields */
+        case 3:
+        case 5:
+            return BLOCK_FLAG_TOP_FIELD_FIRST;
+        case 4:
+        case 6:
+            return BLOCK_FLAG_BOTTOM_FIELD_FIRST;
+        default:
+            return 0;
+    }
+}
+
 static block_t *OutputPicture( decoder_t *p_dec )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
@@ -860,34 +1041,7 @@ static block_t *OutputPicture( decoder_t *p_dec )
 
     unsigned i_num_clock_ts = h264_get_num_ts( p_sps, p_sys->p_slice, p_sys->i_pic_struct, tFOC, bFOC );
 
-    if( !h264_is_frames_only( p_sps ) && p_sys->i_pic_struct != UINT8_MAX )
-    {
-        switch( p_sys->i_pic_struct )
-        {
-        /* Top and Bottom field slices */
-        case 1:
-        case 2:
-            p_pic->i_flags |= BLOCK_FLAG_SINGLE_FIELD;
-            p_pic->i_flags |= h264_slice_top_field(p_sys->p_slice) ? BLOCK_FLAG_TOP_FIELD_FIRST
-                                                                   : BLOCK_FLAG_BOTTOM_FIELD_FIRST;
-            break;
-        /* Each of the following slices contains multiple fields */
-        case 3:
-            p_pic->i_flags |= BLOCK_FLAG_TOP_FIELD_FIRST;
-            break;
-        case 4:
-            p_pic->i_flags |= BLOCK_FLAG_BOTTOM_FIELD_FIRST;
-            break;
-        case 5:
-            p_pic->i_flags |= BLOCK_FLAG_TOP_FIELD_FIRST;
-            break;
-        case 6:
-            p_pic->i_flags |= BLOCK_FLAG_BOTTOM_FIELD_FIRST;
-            break;
-        default:
-            break;
-        }
-    }
+    p_pic->i_flags |= GetPicStructFlags( p_sys, p_sps );
 
     /* set dts/pts to current block timestamps */
     p_pic->i_dts = p_sys->i_frame_dts;
@@ -1150,13 +1304,11 @@ static void GetSPSPPS( uint8_t i_pps_id, void *priv,
         *pp_sps = p_sys->sps[h264_get_pps_sps_id(*pp_pps)].p_sps;
 }
 
-static h264_slice_t * ParseSliceHeader( decoder_t *p_dec, const block_t *p_frag )
+static h264_slice_t * ParseSliceHeader( decoder_t *p_dec,
+                                        const uint8_t *p_stripped, size_t i_stripped )
 {
     decoder_sys_t *p_sys = p_dec->p_sys;
 
-    const uint8_t *p_stripped = p_frag->p_buffer;
-    size_t i_stripped = p_frag->i_buffer;
-
     if( !hxxx_strip_AnnexB_startcode( &p_stripped, &i_stripped ) || i_stripped < 2 )
         return NULL;
 
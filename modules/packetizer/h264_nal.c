@@ -643,10 +643,7 @@ void h264_release_sps_extension( h264_sequence_parameter_set_extension_t *p_sps_
             bs_t bs; \
             struct hxxx_bsfw_ep3b_ctx_s bsctx; \
             if( b_escaped ) \
-            { \
-                hxxx_bsfw_ep3b_ctx_init( &bsctx ); \
-                bs_init_custom( &bs, p_buf, i_buf, &hxxx_bsfw_ep3b_callbacks, &bsctx );\
-            } \
+                hxxx_bsfw_ep3b_init( &bs, &bsctx, p_buf, i_buf ); \
             else bs_init( &bs, p_buf, i_buf ); \
             bs_skip( &bs, 8 ); /* Skip nal_unit_header */ \
             if( !decode( &bs, p_h264type ) ) \
@@ -109,8 +109,7 @@ h264_slice_t * h264_decode_slice( const uint8_t *p_buffer, size_t i_buffer,
     int i_slice_type;
     bs_t s;
     struct hxxx_bsfw_ep3b_ctx_s bsctx;
-    hxxx_bsfw_ep3b_ctx_init( &bsctx );
-    bs_init_custom( &s, p_buffer, i_buffer, &hxxx_bsfw_ep3b_callbacks, &bsctx );
+    hxxx_bsfw_ep3b_init_header( &s, &bsctx, p_buffer, i_buffer );
 
     /* nal unit header */
     bs_skip( &s, 1 );
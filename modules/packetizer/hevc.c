@@ -108,6 +108,7 @@ typedef struct
 
 static block_t *PacketizeAnnexB(decoder_t *, block_t **);
 static block_t *PacketizeHVC1(decoder_t *, block_t **);
+static block_t *PacketizeHVC1Framed(decoder_t *, block_t **);
 static void PacketizeFlush( decoder_t * );
 static void PacketizeReset(void *p_private, bool b_broken);
 static block_t *PacketizeParse(void *p_private, bool *pb_ts_used, block_t *);
@@ -250,8 +251,6 @@ static int Open(vlc_object_t *p_this)
     /* Check if we have hvcC as extradata */
     if(hevc_ishvcC(p_extra, i_extra))
     {
-        p_dec->pf_packetize = PacketizeHVC1;
-
         /* Clear hvcC/HVC1 extra, to be replaced with AnnexB */
         free(p_dec->fmt_out.p_extra);
         p_dec->fmt_out.i_extra = 0;
@@ -262,6 +261,11 @@ static int Open(vlc_object_t *p_this)
                                         &i_new_extra, &p_sys->i_nal_length_size);
         if(p_dec->fmt_out.p_extra)
             p_dec->fmt_out.i_extra = i_new_extra;
+
+        if(p_dec->fmt_in->b_framed && p_sys->i_nal_length_size == 4)
+            p_dec->pf_packetize = PacketizeHVC1Framed;
+        else
+            p_dec->pf_packetize = PacketizeHVC1;
     }
     else
     {
@@ -931,6 +935,194 @@ static void SetOutputBlockProperties(decoder_t *p_dec, block_t *p_output)
     p_sys->p_timing = NULL;
 }
 
+/****************************************************************************
+ * PacketizeHVC1Framed: Takes complete HEVC access units with valid timestamps
+ * Converts them to annexe B in place, only parsing the parameter sets, SEI
+ * and first slice header to set the output properties
+ ****************************************************************************/
+struct framed_au
+{
+    decoder_t *p_dec;
+    const uint8_t *p_start;
+    size_t i_aud; /* size of the leading access unit delimiter */
+    uint32_t i_flags;
+    unsigned i_xps; /* bitfield of the parameter set types seen */
+};
+
+static void ParseFramedNAL(void *opaque, const uint8_t *p_nal, size_t i_nal)
+{
+    struct framed_au *p_ctx = opaque;
+    decoder_t *p_dec = p_ctx->p_dec;
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    if(i_nal < 7 || (p_nal[4] & 0x80))
+        return;
+
+    const uint8_t i_nal_type = hevc_getNALType(&p_nal[4]);
+    if(i_nal_type < HEVC_NAL_VPS)
+    {
+        /* only the first slice of the base layer matters */
+        if(hevc_getNALLayer(&p_nal[4]) != 0 || !(p_nal[6] & 0x80))
+            return;
+
+        hevc_slice_segment_header_t *p_sli =
+                hevc_decode_slice_header(&p_nal[4], i_nal - 4, true, GetXPSSet, p_sys);
+        if(p_sli)
+        {
+            hevc_sequence_parameter_set_t *p_sps;
+            hevc_picture_parameter_set_t *p_pps;
+            hevc_video_parameter_set_t *p_vps;
+            GetXPSSet(hevc_get_slice_pps_id(p_sli), p_sys, &p_pps, &p_sps, &p_vps);
+            ActivateSets(p_dec, p_pps, p_sps, p_vps);
+        }
+
+        switch(i_nal_type)
+        {
+            case HEVC_NAL_BLA_W_LP:
+            case HEVC_NAL_BLA_W_RADL:
+            case HEVC_NAL_BLA_N_LP:
+            case HEVC_NAL_IDR_W_RADL:
+            case HEVC_NAL_IDR_N_LP:
+            case HEVC_NAL_CRA:
+                p_ctx->i_flags |= BLOCK_FLAG_TYPE_I;
+                break;
+
+            default:
+            {
+                enum hevc_slice_type_e type;
+                if(p_sli && hevc_get_slice_type(p_sli, &type))
+                {
+                    switch(type)
+                    {
+                        case HEVC_SLICE_TYPE_B:
+                            p_ctx->i_flags |= BLOCK_FLAG_TYPE_B;
+                            break;
+                        case HEVC_SLICE_TYPE_P:
+                            p_ctx->i_flags |= BLOCK_FLAG_TYPE_P;
+                            break;
+                        case HEVC_SLICE_TYPE_I:
+                            p_ctx->i_flags |= BLOCK_FLAG_TYPE_I;
+                            break;
+                    }
+                }
+                else p_ctx->i_flags |= BLOCK_FLAG_TYPE_B;
+            }
+            break;
+        }
+
+        if(p_sli)
+            hevc_rbsp_release_slice_header(p_sli);
+        return;
+    }
+
+    switch(i_nal_type)
+    {
+        case HEVC_NAL_AUD:
+            if(p_nal == p_ctx->p_start)
+                p_ctx->i_aud = i_nal;
+            break;
+
+        case HEVC_NAL_VPS:
+        case HEVC_NAL_SPS:
+        case HEVC_NAL_PPS:
+        {
+            uint8_t i_id;
+            block_t *p_nalb;
+            if(hevc_get_xps_id(&p_nal[4], i_nal - 4, &i_id) &&
+               (p_nalb = block_Alloc(i_nal)))
+            {
+                memcpy(p_nalb->p_buffer, p_nal, i_nal);
+                InsertXPS(p_dec, i_nal_type, i_id, p_nalb);
+                block_Release(p_nalb);
+            }
+            p_ctx->i_xps |= 1 << (i_nal_type - HEVC_NAL_VPS);
+            break;
+        }
+
+        case HEVC_NAL_PREF_SEI:
+        case HEVC_NAL_SUFF_SEI:
+            HxxxParse_AnnexB_SEI(p_nal, i_nal, 2 /* nal header */,
+                                 ParseSEICallback, p_dec);
+            break;
+
+        case HEVC_NAL_EOS:
+        case HEVC_NAL_EOB:
+            p_ctx->i_flags |= BLOCK_FLAG_END_OF_SEQUENCE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static block_t *PacketizeHVC1Framed(decoder_t *p_dec, block_t **pp_block)
+{
+    decoder_sys_t *p_sys = p_dec->p_sys;
+
+    /* nothing is ever buffered */
+    if(!pp_block || !*pp_block)
+        return NULL;
+
+    /* the length prefixes are overwritten */
+    block_t *p_au = vlc_frame_MakeWritable(*pp_block);
+    *pp_block = NULL;
+    if(!p_au)
+        return NULL;
+
+    struct framed_au ctx = {
+        .p_dec = p_dec,
+        .p_start = p_au->p_buffer,
+    };
+
+    if((p_au->i_flags & BLOCK_FLAG_CORRUPTED) ||
+       !hxxx_AUToAnnexB(p_au, ParseFramedNAL, &ctx))
+    {
+        msg_Warn(p_dec, "Broken access unit");
+        goto drop;
+    }
+
+    if(p_sys->sets == MISSING && XPSReady(p_sys))
+        p_sys->sets = COMPLETE;
+
+    if(p_sys->sets != MISSING && (ctx.i_flags & BLOCK_FLAG_TYPE_I))
+        p_sys->b_recovery_point = true;
+
+    if(p_sys->sets == MISSING || !p_sys->b_recovery_point)
+        goto drop;
+
+    /* Sets are inserted on the recovery point, as in the reassembling mode */
+    if(p_sys->sets != SENT)
+    {
+        const unsigned i_all = (1 << 3) - 1;
+        block_t *p_xps;
+        if(ctx.i_xps != i_all && (p_xps = GetXPSCopy(p_sys)))
+        {
+            p_au = hxxx_AUInsertSets(p_au, ctx.i_aud, p_xps);
+            if(!p_au)
+            {
+                cc_storage_reset(p_sys->p_ccs);
+                goto reset;
+            }
+        }
+        p_sys->sets = SENT;
+    }
+
+    p_au->i_flags |= ctx.i_flags;
+    cc_storage_commit(p_sys->p_ccs, p_au);
+    hevc_release_sei_pic_timing(p_sys->p_timing);
+    p_sys->p_timing = NULL;
+
+    return p_au;
+
+drop:
+    cc_storage_reset(p_sys->p_ccs);
+    block_Release(p_au);
+reset:
+    hevc_release_sei_pic_timing(p_sys->p_timing);
+    p_sys->p_timing = NULL;
+    return NULL;
+}
+
 /*****************************************************************************
  * ParseNALBlock: parses annexB type NALs
  * All p_frag blocks are required to start with 0 0 0 1 4-byte startcode
@@ -674,10 +674,7 @@ void hevc_rbsp_release_vps( hevc_video_parameter_set_t *p_vps )
             bs_t bs; \
             struct hxxx_bsfw_ep3b_ctx_s bsctx; \
             if( b_escaped ) \
-            { \
-                hxxx_bsfw_ep3b_ctx_init( &bsctx ); \
-                bs_init_custom( &bs, p_buf, i_buf, &hxxx_bsfw_ep3b_callbacks, &bsctx );\
-            } \
+                hxxx_bsfw_ep3b_init( &bs, &bsctx, p_buf, i_buf ); \
             else bs_init( &bs, p_buf, i_buf ); \
             bs_skip( &bs, 7 ); /* nal_unit_header */ \
             uint8_t i_nuh_layer_id = bs_read( &bs, 6 ); \
@@ -1216,10 +1213,7 @@ hevc_slice_segment_header_t * hevc_decode_slice_header( const uint8_t *p_buf, si
         bs_t bs;
         struct hxxx_bsfw_ep3b_ctx_s bsctx;
         if( b_escaped )
-        {
-            hxxx_bsfw_ep3b_ctx_init( &bsctx );
-            bs_init_custom( &bs, p_buf, i_buf, &hxxx_bsfw_ep3b_callbacks, &bsctx );
-        }
+            hxxx_bsfw_ep3b_init_header( &bs, &bsctx, p_buf, i_buf );
         else bs_init( &bs, p_buf, i_buf );
         bs_skip( &bs, 1 );
         p_sh->nal_type = bs_read( &bs, 6 );
@@ -1330,8 +1324,7 @@ static void hevc_dcr_params_from_vps( const uint8_t * p_buffer, size_t i_buffer,
 
     bs_t bs;
     struct hxxx_bsfw_ep3b_ctx_s bsctx;
-    hxxx_bsfw_ep3b_ctx_init( &bsctx );
-    bs_init_custom( &bs, p_buffer, i_buffer, &hxxx_bsfw_ep3b_callbacks, &bsctx );
+    hxxx_bsfw_ep3b_init( &bs, &bsctx, p_buffer, i_buffer );
 
     /* first two bytes are the NAL header, 3rd and 4th are:
         vps_video_parameter_set_id(4)
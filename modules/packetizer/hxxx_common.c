@@ -21,6 +21,8 @@
 # include "config.h"
 #endif
 
+#include <assert.h>
+
 #include <vlc_common.h>
 #include <vlc_block.h>
 #include <vlc_codec.h>
@@ -203,3 +205,59 @@ block_t *PacketizeXXC1( void *p_private, struct vlc_logger *logger,
 
     return p_ret;
 }
+
+/****************************************************************************
+ * hxxx_AUToAnnexB: Converts in place a complete access unit of 4 bytes
+ * length prefixed NALs to annexe B, calling pf_nal for each resulting NAL
+ * The access unit must be writable, see vlc_frame_MakeWritable()
+ * Returns false if the access unit is broken
+ ****************************************************************************/
+bool hxxx_AUToAnnexB( block_t *p_au, pf_annexb_nal_callback pf_nal,
+                      void *p_private )
+{
+    assert( !vlc_frame_IsShared( p_au ) );
+
+    uint8_t *p = p_au->p_buffer;
+    const uint8_t *end = &p_au->p_buffer[p_au->i_buffer];
+
+    while( end - p > 4 )
+    {
+        const uint32_t i_size = GetDWBE( p );
+        if( i_size == 0 || i_size > (size_t)(end - p) - 4 )
+            return false;
+
+        p[0] = 0x00;
+        p[1] = 0x00;
+        p[2] = 0x00;
+        p[3] = 0x01;
+
+        pf_nal( p_private, p, 4 + i_size );
+        p += 4 + i_size;
+    }
+
+    return p == end;
+}
+
+/****************************************************************************
+ * hxxx_AUInsertSets: Inserts the annexe B parameter sets chain at offset
+ * i_offset of an access unit, usually after its delimiter
+ ****************************************************************************/
+block_t *hxxx_AUInsertSets( block_t *p_au, size_t i_offset, block_t *p_sets )
+{
+    size_t i_sets;
+    block_ChainProperties( p_sets, NULL, &i_sets, NULL );
+
+    block_t *p_out = block_Alloc( p_au->i_buffer + i_sets );
+    if( p_out )
+    {
+        block_CopyProperties( p_out, p_au );
+        memcpy( p_out->p_buffer, p_au->p_buffer, i_offset );
+        block_ChainExtract( p_sets, &p_out->p_buffer[i_offset], i_sets );
+        memcpy( &p_out->p_buffer[i_offset + i_sets], &p_au->p_buffer[i_offset],
+                p_au->i_buffer - i_offset );
+    }
+
+    block_ChainRelease( p_sets );
+    block_Release( p_au );
+    return p_out;
+}
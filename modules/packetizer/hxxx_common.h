@@ -43,5 +43,10 @@ block_t *PacketizeXXC1( void *, struct vlc_logger *,
                        uint8_t, block_t **,
                        pf_annexb_nal_parse, pf_annexb_nal_drain );
 
+/* Framed access units, see es_format_t.b_framed */
+typedef void (*pf_annexb_nal_callback)(void *, const uint8_t *, size_t);
+bool hxxx_AUToAnnexB( block_t *, pf_annexb_nal_callback, void * );
+block_t *hxxx_AUInsertSets( block_t *, size_t, block_t * );
+
 #endif // HXXX_COMMON_H
 
@@ -19,6 +19,72 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
  *****************************************************************************/
 #include <vlc_bits.h>
+#include <vlc_cpu.h>
+
+#ifdef CAN_COMPILE_SSE2
+#  include <emmintrin.h>
+#endif
+
+/* Looks up the first 0x00 0x00 0x03 sequence, which can only start in
+ * 32 bits words containing a zero byte */
+static inline const uint8_t * hxxx_ep3b_Find_Bits( const uint8_t *p, const uint8_t *end )
+{
+    for( ; end - p >= 6; p += 4 )
+    {
+        uint32_t x;
+        memcpy( &x, p, sizeof(x) );
+        if( (x - 0x01010101) & (~x) & 0x80808080 )
+        {
+            for( int i = 0; i < 4; i++ )
+                if( p[i] == 0 && p[i+1] == 0 && p[i+2] == 3 )
+                    return &p[i];
+        }
+    }
+
+    for( ; end - p >= 3; p++ )
+    {
+        if( p[0] == 0 && p[1] == 0 && p[2] == 3 )
+            return p;
+    }
+
+    return NULL;
+}
+
+#ifdef CAN_COMPILE_SSE2
+__attribute__ ((__target__ ("sse2")))
+static inline const uint8_t * hxxx_ep3b_Find_SSE2( const uint8_t *p, const uint8_t *end )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i three = _mm_set1_epi8( 3 );
+
+    /* Matches the 3 bytes of the sequence at the 16 offsets at once */
+    for( ; end - p >= 18; p += 16 )
+    {
+        __m128i v0 = _mm_loadu_si128( (const __m128i *) &p[0] );
+        __m128i v1 = _mm_loadu_si128( (const __m128i *) &p[1] );
+        __m128i v2 = _mm_loadu_si128( (const __m128i *) &p[2] );
+        __m128i m = _mm_and_si128( _mm_cmpeq_epi8( v0, zero ),
+                                   _mm_cmpeq_epi8( v1, zero ) );
+        m = _mm_and_si128( m, _mm_cmpeq_epi8( v2, three ) );
+
+        unsigned match = _mm_movemask_epi8( m );
+        if( match )
+            return &p[ctz( match )];
+    }
+
+    return hxxx_ep3b_Find_Bits( p, end );
+}
+
+static inline const uint8_t * hxxx_ep3b_Find( const uint8_t *p, const uint8_t *end )
+{
+    if( vlc_CPU_SSE2() )
+        return hxxx_ep3b_Find_SSE2( p, end );
+    else
+        return hxxx_ep3b_Find_Bits( p, end );
+}
+#else
+    #define hxxx_ep3b_Find hxxx_ep3b_Find_Bits
+#endif
 
 static inline uint8_t *hxxx_ep3b_to_rbsp( uint8_t *p, uint8_t *end, unsigned *pi_prev, size_t i_count )
 {
@@ -71,12 +137,14 @@ struct hxxx_bsfw_ep3b_ctx_s
 {
     unsigned i_prev;
     size_t i_bytepos;
+    const uint8_t *p_plain_end; /* no escape is read before, or NULL */
 };
 
 static void hxxx_bsfw_ep3b_ctx_init( struct hxxx_bsfw_ep3b_ctx_s *ctx )
 {
     ctx->i_prev = 0;
     ctx->i_bytepos = 0;
+    ctx->p_plain_end = NULL;
 }
 
 static size_t hxxx_bsfw_byte_forward_ep3b( bs_t *s, size_t i_count )
@@ -92,6 +160,21 @@ static size_t hxxx_bsfw_byte_forward_ep3b( bs_t *s, size_t i_count )
     if( s->p >= s->p_end )
         return 0;
 
+    if( ctx->p_plain_end != NULL )
+    {
+        if( s->p + i_count < ctx->p_plain_end )
+        {
+            s->p += i_count;
+            ctx->i_bytepos += i_count;
+            return i_count;
+        }
+        /* Restore the zero bytes history of the escape tracking */
+        ctx->i_prev = !s->p[0];
+        if( s->p > s->p_start )
+            ctx->i_prev |= !s->p[-1] << 1;
+        ctx->p_plain_end = NULL;
+    }
+
     s->p = hxxx_ep3b_to_rbsp( s->p, s->p_end, &ctx->i_prev, i_count );
     ctx->i_bytepos += i_count;
     return i_count;
@@ -108,3 +191,37 @@ static const bs_byte_callbacks_t hxxx_bsfw_ep3b_callbacks =
     hxxx_bsfw_byte_forward_ep3b,
     hxxx_bsfw_byte_pos_ep3b,
 };
+
+/* Initializes a reader discarding the emulation prevention three bytes,
+ * or a plain one when the buffer contains none */
+static inline void hxxx_bsfw_ep3b_init( bs_t *s, struct hxxx_bsfw_ep3b_ctx_s *ctx,
+                                        const uint8_t *p_data, size_t i_data )
+{
+    if( hxxx_ep3b_Find( p_data, p_data + i_data ) == NULL )
+    {
+        bs_init( s, p_data, i_data );
+        return;
+    }
+    hxxx_bsfw_ep3b_ctx_init( ctx );
+    bs_init_custom( s, p_data, i_data, &hxxx_bsfw_ep3b_callbacks, ctx );
+}
+
+/* Escaped slices are large and only their header is read: looks up the
+ * escapes in a header-sized prefix only, reading plainly up to the first
+ * one, and discards them byte by byte after it */
+#define HXXX_EP3B_HEADER_SCAN 256
+
+static inline void hxxx_bsfw_ep3b_init_header( bs_t *s, struct hxxx_bsfw_ep3b_ctx_s *ctx,
+                                               const uint8_t *p_data, size_t i_data )
+{
+    if( i_data <= HXXX_EP3B_HEADER_SCAN )
+    {
+        hxxx_bsfw_ep3b_init( s, ctx, p_data, i_data );
+        return;
+    }
+    const uint8_t *p_ep3b = hxxx_ep3b_Find( p_data, p_data + HXXX_EP3B_HEADER_SCAN );
+    hxxx_bsfw_ep3b_ctx_init( ctx );
+    /* sequences straddling the prefix end are caught by the escape tracking */
+    ctx->p_plain_end = p_ep3b ? p_ep3b + 2 : p_data + HXXX_EP3B_HEADER_SCAN;
+    bs_init_custom( s, p_data, i_data, &hxxx_bsfw_ep3b_callbacks, ctx );
+}
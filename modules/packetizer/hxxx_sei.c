@@ -46,9 +46,8 @@ void HxxxParseSEI(const uint8_t *p_buf, size_t i_buf,
         return;
 
     struct hxxx_bsfw_ep3b_ctx_s bsctx;
-    hxxx_bsfw_ep3b_ctx_init( &bsctx );
-    bs_init_custom( &s, &p_buf[i_header], i_buf - i_header, /* skip nal unit header */
-                    &hxxx_bsfw_ep3b_callbacks, &bsctx );
+    hxxx_bsfw_ep3b_init( &s, &bsctx, &p_buf[i_header], /* skip nal unit header */
+                         i_buf - i_header );
 
 
     while( !bs_eof( &s ) && bs_aligned( &s ) && b_continue )
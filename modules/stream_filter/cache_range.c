@@ -0,0 +1,410 @@
+/*****************************************************************************
+ * cache_range.c: seek-friendly page cache stream filter
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vlc_common.h>
+#include <vlc_plugin.h>
+#include <vlc_stream.h>
+#include <vlc_list.h>
+
+/*
+ * Container demuxers typically bounce between a few regions of a file (e.g.
+ * an index at the end and the data being played). On slow seekable sources,
+ * each bounce costs a new request. This filter keeps fixed-size pages from
+ * anywhere in the file, indexed by page number and evicted in least recently
+ * used order, so that revisited regions are served from memory.
+ *
+ * Each cache miss reads ahead a number of pages. Read-ahead is tracked per
+ * region: a miss right after the last page fetched for a region doubles that
+ * region's read-ahead, any other miss starts a new region with no read-ahead.
+ */
+
+#define CACHE_PAGE_SIZE (64 << 10)
+#define CACHE_REGIONS 4
+
+struct cache_page
+{
+    uint64_t index;
+    size_t length; /* less than CACHE_PAGE_SIZE at end of stream */
+    struct cache_page *hash_next;
+    struct vlc_list lru;
+    uint8_t data[CACHE_PAGE_SIZE];
+};
+
+struct cache_region
+{
+    uint64_t next; /* page following the last one fetched */
+    unsigned readahead;
+    vlc_tick_t date;
+};
+
+typedef struct
+{
+    uint64_t offset; /* current read offset */
+    uint64_t source_offset; /* current offset in the source stream */
+    uint64_t eof_page; /* first page known to be past the end, or UINT64_MAX */
+
+    struct cache_page **hash;
+    size_t hash_mask;
+    struct vlc_list lru; /* most recently used first */
+    size_t count;
+    size_t max_count;
+
+    struct cache_region regions[CACHE_REGIONS];
+    unsigned max_readahead;
+
+    struct
+    {
+        uint64_t hits;
+        uint64_t misses;
+    } stat;
+} stream_sys_t;
+
+static struct cache_page **Bucket(stream_sys_t *sys, uint64_t index)
+{
+    return &sys->hash[(index * UINT64_C(0x9E3779B97F4A7C15) >> 32)
+                      & sys->hash_mask];
+}
+
+static struct cache_page *Lookup(stream_sys_t *sys, uint64_t index)
+{
+    for (struct cache_page *page = *Bucket(sys, index); page != NULL;
+         page = page->hash_next)
+        if (page->index == index)
+            return page;
+    return NULL;
+}
+
+static void Unlink(stream_sys_t *sys, struct cache_page *page)
+{
+    struct cache_page **pp = Bucket(sys, page->index);
+
+    while (*pp != page)
+        pp = &(*pp)->hash_next;
+    *pp = page->hash_next;
+    vlc_list_remove(&page->lru);
+    sys->count--;
+}
+
+static void Flush(stream_sys_t *sys)
+{
+    struct cache_page *page;
+
+    vlc_list_foreach(page, &sys->lru, lru)
+    {
+        Unlink(sys, page);
+        free(page);
+    }
+    assert(sys->count == 0);
+
+    for (unsigned i = 0; i < CACHE_REGIONS; i++)
+        sys->regions[i] = (struct cache_region) { UINT64_MAX, 0, VLC_TICK_0 };
+    sys->eof_page = UINT64_MAX;
+}
+
+/**
+ * Returns a page for the given index, recycling the least recently used one
+ * if the cache is full. The page is not inserted in the cache.
+ */
+static struct cache_page *NewPage(stream_sys_t *sys)
+{
+    if (sys->count >= sys->max_count)
+    {
+        struct cache_page *page =
+            vlc_list_last_entry_or_null(&sys->lru, struct cache_page, lru);
+
+        assert(page != NULL);
+        Unlink(sys, page);
+        return page;
+    }
+    return malloc(sizeof (struct cache_page));
+}
+
+static void Insert(stream_sys_t *sys, struct cache_page *page)
+{
+    struct cache_page **pp = Bucket(sys, page->index);
+
+    page->hash_next = *pp;
+    *pp = page;
+    vlc_list_prepend(&page->lru, &sys->lru);
+    sys->count++;
+}
+
+static struct cache_region *GetRegion(stream_sys_t *sys, uint64_t index)
+{
+    struct cache_region *oldest = &sys->regions[0];
+
+    for (unsigned i = 0; i < CACHE_REGIONS; i++)
+    {
+        struct cache_region *r = &sys->regions[i];
+
+        if (r->next == index)
+        {   /* Sequential access within a known region */
+            r->readahead = r->readahead ? 2 * r->readahead : 1;
+            if (r->readahead > sys->max_readahead)
+                r->readahead = sys->max_readahead;
+            r->date = vlc_tick_now();
+            return r;
+        }
+        if (r->date < oldest->date)
+            oldest = r;
+    }
+
+    oldest->readahead = 0;
+    oldest->date = vlc_tick_now();
+    return oldest;
+}
+
+/**
+ * Fetches a missing page, and some of the following missing pages.
+ */
+static struct cache_page *Fill(stream_t *s, uint64_t index)
+{
+    stream_sys_t *sys = s->p_sys;
+    struct cache_region *region = GetRegion(s->p_sys, index);
+    struct cache_page *first = NULL;
+    uint64_t end = index + 1 + region->readahead;
+
+    sys->stat.misses++;
+
+    for (uint64_t i = index; i < end && i < sys->eof_page; i++)
+    {
+        if (i > index && Lookup(sys, i) != NULL)
+            break; /* the rest of the region is already cached */
+
+        uint64_t pos = i * CACHE_PAGE_SIZE;
+
+        if (sys->source_offset != pos)
+        {
+            if (vlc_stream_Seek(s->s, pos))
+                break;
+            sys->source_offset = pos;
+        }
+
+        struct cache_page *page = NewPage(sys);
+        if (unlikely(page == NULL))
+            break;
+
+        ssize_t val = vlc_stream_Read(s->s, page->data, CACHE_PAGE_SIZE);
+        sys->source_offset += val;
+
+        if (val < CACHE_PAGE_SIZE)
+        {
+            if (!vlc_stream_Eof(s->s))
+            {   /* Interrupted: the page will be fetched again. */
+                free(page);
+                break;
+            }
+            if (val == 0)
+            {
+                free(page);
+                sys->eof_page = i;
+                break;
+            }
+            sys->eof_page = i + 1;
+        }
+
+        page->index = i;
+        page->length = val;
+        Insert(sys, page);
+        region->next = i + 1;
+        if (i == index)
+            first = page;
+    }
+    return first;
+}
+
+static ssize_t Read(stream_t *s, void *buf, size_t len)
+{
+    stream_sys_t *sys = s->p_sys;
+    uint64_t index = sys->offset / CACHE_PAGE_SIZE;
+    size_t skip = sys->offset % CACHE_PAGE_SIZE;
+
+    if (index >= sys->eof_page)
+        return 0;
+
+    struct cache_page *page = Lookup(sys, index);
+    if (page != NULL)
+    {
+        sys->stat.hits++;
+        vlc_list_remove(&page->lru);
+        vlc_list_prepend(&page->lru, &sys->lru);
+    }
+    else
+    {
+        page = Fill(s, index);
+        if (page == NULL)
+            return (index >= sys->eof_page) ? 0 : -1;
+    }
+
+    if (skip >= page->length)
+        return 0;
+
+    if (len > page->length - skip)
+        len = page->length - skip;
+    if (buf != NULL)
+        memcpy(buf, page->data + skip, len);
+    sys->offset += len;
+    return len;
+}
+
+static int Seek(stream_t *s, uint64_t offset)
+{
+    stream_sys_t *sys = s->p_sys;
+
+    /* The source is only moved when a page is missing. */
+    sys->offset = offset;
+    return VLC_SUCCESS;
+}
+
+static int Control(stream_t *s, int query, va_list args)
+{
+    stream_sys_t *sys = s->p_sys;
+
+    switch (query)
+    {
+        case STREAM_CAN_SEEK:
+        case STREAM_CAN_FASTSEEK:
+        case STREAM_CAN_PAUSE:
+        case STREAM_CAN_CONTROL_PACE:
+        case STREAM_GET_SIZE:
+        case STREAM_GET_PTS_DELAY:
+        case STREAM_GET_TITLE_INFO:
+        case STREAM_GET_TITLE:
+        case STREAM_GET_SEEKPOINT:
+        case STREAM_GET_META:
+        case STREAM_GET_CONTENT_TYPE:
+        case STREAM_GET_SIGNAL:
+        case STREAM_GET_TAGS:
+        case STREAM_GET_TYPE:
+        case STREAM_SET_PAUSE_STATE:
+        case STREAM_GET_MTIME:
+            return vlc_stream_vaControl(s->s, query, args);
+
+        case STREAM_SET_TITLE:
+        case STREAM_SET_SEEKPOINT:
+        {
+            int ret = vlc_stream_vaControl(s->s, query, args);
+            if (ret == VLC_SUCCESS)
+            {   /* The source position and contents may have changed. */
+                Flush(sys);
+                sys->offset = sys->source_offset = vlc_stream_Tell(s->s);
+            }
+            return ret;
+        }
+
+        default:
+            return VLC_EGENERIC;
+    }
+}
+
+static int Open(vlc_object_t *obj)
+{
+    stream_t *s = (stream_t *)obj;
+
+    if (!var_InheritBool(obj, "cache-range"))
+        return VLC_EGENERIC;
+
+    /* Only slow seekable sources benefit from this. PID-filtered streams
+     * would keep stale data in the cache. */
+    if (!vlc_stream_CanSeek(s->s) || vlc_stream_CanFastSeek(s->s))
+        return VLC_EGENERIC;
+    if (vlc_stream_GetPrivateIdState(s->s, 0, &(bool){false}) == VLC_SUCCESS)
+        return VLC_EGENERIC;
+
+    stream_sys_t *sys = malloc(sizeof (*sys));
+    if (unlikely(sys == NULL))
+        return VLC_ENOMEM;
+
+    size_t max_count = (var_InheritInteger(obj, "cache-range-memory") << 10)
+                       / CACHE_PAGE_SIZE;
+    if (max_count < 2)
+        max_count = 2;
+
+    /* About one page per bucket at most */
+    size_t buckets = 1;
+    while (buckets < max_count)
+        buckets <<= 1;
+
+    sys->hash = calloc(buckets, sizeof (*sys->hash));
+    if (unlikely(sys->hash == NULL))
+    {
+        free(sys);
+        return VLC_ENOMEM;
+    }
+
+    sys->hash_mask = buckets - 1;
+    sys->offset = sys->source_offset = vlc_stream_Tell(s->s);
+    vlc_list_init(&sys->lru);
+    sys->count = 0;
+    sys->max_count = max_count;
+    sys->max_readahead = var_InheritInteger(obj, "cache-range-readahead")
+                         / (CACHE_PAGE_SIZE >> 10);
+    if (sys->max_readahead >= max_count)
+        sys->max_readahead = max_count - 1;
+    sys->stat.hits = sys->stat.misses = 0;
+    Flush(sys);
+
+    msg_Dbg(s, "using %zu pages of %u KiB", max_count, CACHE_PAGE_SIZE >> 10);
+    s->p_sys = sys;
+    s->pf_read = Read;
+    s->pf_seek = Seek;
+    s->pf_control = Control;
+    return VLC_SUCCESS;
+}
+
+static void Close(vlc_object_t *obj)
+{
+    stream_t *s = (stream_t *)obj;
+    stream_sys_t *sys = s->p_sys;
+
+    msg_Dbg(s, "%"PRIu64" hits, %"PRIu64" misses", sys->stat.hits,
+            sys->stat.misses);
+    Flush(sys);
+    free(sys->hash);
+    free(sys);
+}
+
+vlc_module_begin()
+    set_subcategory(SUBCAT_INPUT_STREAM_FILTER)
+    set_capability("stream_filter", 0)
+    add_shortcut("cache_range")
+
+    set_description(N_("Byte range cache"))
+    set_callbacks(Open, Close)
+
+    add_bool("cache-range", false, N_("Range cache"),
+             N_("Keep recently read parts of slow seekable streams in memory, "
+                "instead of buffering linearly. This helps formats with "
+                "indexes or interleaved headers over network shares."))
+    add_integer("cache-range-memory", 1 << 16, N_("Range cache size"),
+                N_("Maximum memory used by the range cache (KiB)"))
+        change_integer_range(128, 1 << 22)
+    add_integer("cache-range-readahead", 1 << 12, N_("Range cache read-ahead"),
+                N_("Maximum amount read ahead of a cache miss (KiB)"))
+        change_integer_range(0, 1 << 20)
+vlc_module_end()
@@ -131,7 +131,19 @@
     "VIDEO." )
 #define POOL_TEXT N_("Picture pool size")
 #define POOL_LONGTEXT N_( "Defines how many pictures we allow to be in pool "\
-    "between decoder/encoder threads when threads > 0" )
+    "between decoder/encoder threads when threads > 0, and between the " \
+    "decoder and the filter thread." )
+#define FILTER_THREAD_TEXT N_("Filter in a separate thread")
+#define FILTER_THREAD_LONGTEXT N_( \
+    "Runs the video filters, the subpictures blending and the encoder " \
+    "input on their own thread, so that they run in parallel with the " \
+    "decoder." )
+#define RENDITIONS_TEXT N_("Additional renditions")
+#define RENDITIONS_LONGTEXT N_( \
+    "Colon-separated list of additional video outputs, as " \
+    "<width>x<height>[@<bitrate in kb/s>]. The video is decoded and " \
+    "filtered once, then scaled and encoded for each rendition, which " \
+    "is sent as a separate stream." )
 #define FORWARD_PCR_TEXT N_( "Forward PCR" )
 #define FORWARD_PCR_LONGTEXT N_( \
     "Enable PCR events forwarding to the next stream." )
@@ -186,6 +198,8 @@ vlc_module_begin ()
                  MAXHEIGHT_LONGTEXT )
     add_module_list(SOUT_CFG_PREFIX "vfilter", "video filter", NULL,
                     VFILTER_TEXT, VFILTER_LONGTEXT)
+    add_string( SOUT_CFG_PREFIX "renditions", NULL, RENDITIONS_TEXT,
+                RENDITIONS_LONGTEXT )
 
     set_section( N_("Audio"), NULL )
     add_module(SOUT_CFG_PREFIX "aenc", "audio encoder", "none",
@@ -220,6 +234,8 @@ vlc_module_begin ()
         change_integer_range( 0, 32 )
     add_integer( SOUT_CFG_PREFIX "pool-size", 10, POOL_TEXT, POOL_LONGTEXT )
         change_integer_range( 1, 1000 )
+    add_bool( SOUT_CFG_PREFIX "filter-thread", false, FILTER_THREAD_TEXT,
+              FILTER_THREAD_LONGTEXT )
     add_obsolete_bool( SOUT_CFG_PREFIX "high-priority" ) // Since 4.0.0
     add_bool( SOUT_CFG_PREFIX "forward-pcr", true, FORWARD_PCR_TEXT,
               FORWARD_PCR_LONGTEXT )
@@ -232,7 +248,7 @@ static const char *const ppsz_sout_options[] = {
     "deinterlace-module", "threads", "aenc", "acodec", "ab", "alang",
     "afilter", "samplerate", "channels", "senc", "scodec", "soverlay",
     "sfilter", "high-priority", "maxwidth", "maxheight", "pool-size",
-    "forward-pcr", NULL
+    "forward-pcr", "filter-thread", "renditions", NULL
 };
 
 /*****************************************************************************
@@ -332,6 +348,41 @@ static void SetVideoEncoderConfig( sout_stream_t *p_stream, transcode_encoder_co
     p_cfg->video.threads.pool_size = var_GetInteger( p_stream, SOUT_CFG_PREFIX "pool-size" );
 }
 
+static void SetVideoRenditions( sout_stream_t *p_stream, sout_stream_sys_t *p_sys )
+{
+    char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "renditions" );
+    if( psz_string == NULL )
+        return;
+
+    char *psz_saveptr;
+    for( char *psz_tok = strtok_r( psz_string, ":,", &psz_saveptr );
+         psz_tok != NULL; psz_tok = strtok_r( NULL, ":,", &psz_saveptr ) )
+    {
+        transcode_rendition_config_t cfg = { .i_bitrate = 0 };
+
+        if( sscanf( psz_tok, "%ux%u@%u", &cfg.i_width, &cfg.i_height,
+                    &cfg.i_bitrate ) < 2 || !cfg.i_width || !cfg.i_height )
+        {
+            msg_Warn( p_stream, "invalid rendition `%s'", psz_tok );
+            continue;
+        }
+        if( cfg.i_bitrate < 16000 )
+            cfg.i_bitrate *= 1000;
+
+        transcode_rendition_config_t *p_realloc =
+            realloc( p_sys->p_vrenditions,
+                     (p_sys->i_vrenditions + 1) * sizeof(*p_realloc) );
+        if( unlikely(p_realloc == NULL) )
+            break;
+        p_realloc[p_sys->i_vrenditions++] = cfg;
+        p_sys->p_vrenditions = p_realloc;
+
+        msg_Dbg( p_stream, "video rendition %ux%u %ukb/s", cfg.i_width,
+                 cfg.i_height, cfg.i_bitrate / 1000 );
+    }
+    free( psz_string );
+}
+
 static void SetSPUEncoderConfig( sout_stream_t *p_stream, transcode_encoder_config_t *p_cfg )
 {
     char *psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "senc" );
@@ -413,13 +464,23 @@ static int Open( vlc_object_t *p_this )
     config_ChainParse( p_stream, SOUT_CFG_PREFIX, ppsz_sout_options,
                    p_stream->p_cfg );
 
+    SetVideoRenditions( p_stream, p_sys );
+
     p_sys->pcr_forwarding_enabled =
         var_GetBool( p_stream, SOUT_CFG_PREFIX "forward-pcr" );
+    if( p_sys->pcr_forwarding_enabled && p_sys->i_vrenditions > 0 )
+    {
+        /* The PCR helpers expect one output frame per input frame */
+        msg_Warn( p_stream, "PCR forwarding is not supported with renditions, "
+                  "disabling it" );
+        p_sys->pcr_forwarding_enabled = false;
+    }
     if( p_sys->pcr_forwarding_enabled )
     {
         p_sys->pcr_sync = vlc_pcr_sync_New();
         if( unlikely(p_sys->pcr_sync == NULL) )
         {
+            free( p_sys->p_vrenditions );
             free( p_sys );
             return VLC_ENOMEM;
         }
@@ -479,6 +540,9 @@ static int Open( vlc_object_t *p_this )
         free( psz_string );
     }
 
+    p_sys->vfilters_cfg.video.b_threaded =
+        var_GetBool( p_stream, SOUT_CFG_PREFIX "filter-thread" );
+
     /* Subpictures SOURCES parameters (not related to subtitles stream) */
     psz_string = var_GetString( p_stream, SOUT_CFG_PREFIX "sfilter" );
     if( psz_string && *psz_string )
@@ -523,6 +587,8 @@ static void Close( sout_stream_t *p_stream )
 
     transcode_encoder_config_clean( &p_sys->senc_cfg );
 
+    free( p_sys->p_vrenditions );
+
     if( p_sys->pcr_sync != NULL )
         vlc_pcr_sync_Delete( p_sys->pcr_sync );
 
@@ -626,6 +692,11 @@ Add( sout_stream_t *p_stream, const es_format_t *p_fmt, const char *es_id )
     vlc_mutex_init(&id->fifo.lock);
     id->pf_transcode_downstream_add = transcode_downstream_Add;
 
+    vlc_mutex_lock( &p_sys->lock );
+    if( p_fmt->i_id > p_sys->i_last_es_id )
+        p_sys->i_last_es_id = p_fmt->i_id;
+    vlc_mutex_unlock( &p_sys->lock );
+
     /* Create decoder object */
     struct decoder_owner * p_owner = vlc_object_create( p_stream, sizeof( *p_owner ) );
     if( !p_owner )
@@ -758,7 +829,7 @@ static void Del( sout_stream_t *p_stream, void *_id )
             if( id == p_sys->id_video )
                 p_sys->id_video = NULL;
             vlc_mutex_unlock( &p_sys->lock );
-            transcode_video_clean( id );
+            transcode_video_clean( p_stream, id );
             break;
         case SPU_ES:
             dec_Delete( id->p_decoder );
@@ -19,6 +19,7 @@ typedef struct
             config_chain_t  *p_deinterlace_cfg;
             char            *psz_spu_sources;
             bool             b_reorient;
+            bool             b_threaded; /* filter in a separate thread */
         } video;
     };
 } sout_filters_config_t;
@@ -41,7 +42,17 @@ void sout_filters_config_clean( sout_filters_config_t *p_cfg )
     free( p_cfg->video.psz_spu_sources );
 }
 
+/* Additional video output, encoded at another size and bitrate */
+typedef struct
+{
+    unsigned int i_width;
+    unsigned int i_height;
+    unsigned int i_bitrate; /* 0 to keep the main one */
+} transcode_rendition_config_t;
+
 typedef struct sout_stream_id_sys_t sout_stream_id_sys_t;
+struct transcode_filter_stage;
+struct transcode_rendition;
 
 typedef struct
 {
@@ -54,6 +65,8 @@ typedef struct
     /* Video */
     transcode_encoder_config_t venc_cfg;
     sout_filters_config_t vfilters_cfg;
+    transcode_rendition_config_t *p_vrenditions;
+    size_t          i_vrenditions;
 
     /* SPU */
     transcode_encoder_config_t senc_cfg;
@@ -66,6 +79,9 @@ typedef struct
     /* Spu's video */
     sout_stream_id_sys_t *id_video;
 
+    /* Highest ES id added, the video renditions are numbered after it */
+    int             i_last_es_id;
+
     bool pcr_forwarding_enabled;
     vlc_pcr_sync_t *pcr_sync;
     bool first_pcr_sent;
@@ -134,6 +150,9 @@ struct sout_stream_id_sys_t
              spu_t           *p_spu;
              vlc_decoder_device *dec_dev;
              vlc_video_context *enc_vctx_in;
+             struct transcode_filter_stage *p_filter_stage;
+             struct transcode_rendition *p_renditions;
+             size_t          i_renditions;
          };
          struct
          {
@@ -225,7 +244,7 @@ int  transcode_audio_init   ( sout_stream_t *, const es_format_t *,
 
 /* VIDEO */
 
-void transcode_video_clean  ( sout_stream_id_sys_t * );
+void transcode_video_clean  ( sout_stream_t *, sout_stream_id_sys_t * );
 int  transcode_video_process( sout_stream_t *, sout_stream_id_sys_t *,
                                      block_t *, block_t ** );
 void transcode_video_flush  ( sout_stream_id_sys_t * );
@@ -113,12 +113,139 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
                                          vlc_video_context *src_ctx,
                                          const es_format_t *p_dst,
                                          sout_stream_id_sys_t *id );
+static void filter_stage_Wait( struct transcode_filter_stage * );
+
+/* Additional output sharing the decoded and filtered pictures of the main
+ * one, scaled and encoded on its own */
+struct transcode_rendition
+{
+    transcode_encoder_config_t cfg; /**< shallow copy of the main config */
+    transcode_encoder_t *encoder;
+    filter_chain_t  *p_conv; /**< scaler to the rendition encoder */
+    void            *downstream_id;
+    char            *psz_es_id;
+    int             i_es_id; /**< distinct from the ids of the source ES */
+    /* encoded blocks, protected by the output fifo lock */
+    block_t         *p_out;
+    block_t         **pp_out_last;
+};
+
+static int transcode_video_renditions_open( sout_stream_t *p_stream,
+                                            sout_stream_id_sys_t *id,
+                                            const es_format_t *p_src,
+                                            vlc_video_context *src_ctx )
+{
+    filter_owner_t chain_owner = {
+        .video = &transcode_filter_video_cbs,
+        .sys = id,
+    };
+
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        transcode_remove_filters( &r->p_conv );
+
+        if( r->encoder == NULL )
+        {
+            struct encoder_owner *p_enc_owner = (struct encoder_owner *)
+                sout_EncoderCreate( VLC_OBJECT(p_stream), sizeof(*p_enc_owner) );
+            if( unlikely(p_enc_owner == NULL) )
+                return VLC_EGENERIC;
+
+            r->encoder = transcode_encoder_new( &p_enc_owner->enc, p_src );
+            if( r->encoder == NULL )
+            {
+                vlc_object_delete( &p_enc_owner->enc );
+                return VLC_EGENERIC;
+            }
+
+            p_enc_owner->id = id;
+            p_enc_owner->enc.cbs = &encoder_video_transcode_cbs;
+        }
+
+        if( !transcode_encoder_opened( r->encoder ) )
+        {
+            transcode_encoder_update_format_in( r->encoder, p_src, &r->cfg );
+            transcode_encoder_video_configure( VLC_OBJECT(p_stream),
+                                               &id->p_decoder->fmt_out.video,
+                                               &r->cfg, &p_src->video,
+                                               src_ctx, r->encoder );
+            if( transcode_encoder_open( r->encoder, &r->cfg ) != VLC_SUCCESS )
+            {
+                msg_Err( p_stream, "cannot open the encoder of rendition %zu",
+                         i + 1 );
+                return VLC_EGENERIC;
+            }
+        }
+
+        const es_format_t *p_enc_fmt = transcode_encoder_format_in( r->encoder );
+        if( !video_format_IsSimilar( &p_enc_fmt->video, &p_src->video ) )
+        {
+            r->p_conv = filter_chain_NewVideo( p_stream, false, &chain_owner );
+            if( r->p_conv == NULL )
+                return VLC_EGENERIC;
+            filter_chain_Reset( r->p_conv, p_src, src_ctx, p_enc_fmt );
+            if( filter_chain_AppendConverter( r->p_conv, NULL ) != VLC_SUCCESS )
+                return VLC_EGENERIC;
+        }
+    }
+    return VLC_SUCCESS;
+}
+
+static void transcode_video_renditions_encode( sout_stream_id_sys_t *id,
+                                               picture_t *p_pic )
+{
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        picture_t *p_in = picture_Hold( p_pic );
+        if( r->p_conv != NULL )
+            p_in = filter_chain_VideoFilter( r->p_conv, p_in );
+        if( p_in == NULL )
+            continue;
+
+        block_t *p_encoded = transcode_encoder_encode( r->encoder, p_in );
+        picture_Release( p_in );
+        if( p_encoded == NULL )
+            continue;
+
+        vlc_fifo_Lock( id->output_fifo );
+        block_ChainLastAppend( &r->pp_out_last, p_encoded );
+        vlc_fifo_Unlock( id->output_fifo );
+    }
+}
+
+static void transcode_video_renditions_clean( sout_stream_t *p_stream,
+                                              sout_stream_id_sys_t *id )
+{
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        if( r->encoder != NULL )
+            transcode_encoder_delete( r->encoder );
+        transcode_remove_filters( &r->p_conv );
+        if( r->downstream_id != NULL )
+            sout_StreamIdDel( p_stream->p_next, r->downstream_id );
+        block_ChainRelease( r->p_out );
+        free( r->psz_es_id );
+    }
+    free( id->p_renditions );
+    id->p_renditions = NULL;
+    id->i_renditions = 0;
+}
 
 static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vctx )
 {
     struct decoder_owner *p_owner = dec_get_owner( p_dec );
     sout_stream_id_sys_t *id = p_owner->id;
 
+    /* The filters of the previous format might still be in use */
+    if( id->p_filter_stage != NULL )
+        filter_stage_Wait( id->p_filter_stage );
+
     vlc_mutex_lock(&id->fifo.lock);
     if( id->encoder != NULL && transcode_encoder_opened( id->encoder ) )
     {
@@ -217,6 +344,10 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
          if( filter_chain_AppendConverter( id->p_final_conv_static, NULL ) != VLC_SUCCESS )
              goto error;
     }
+
+    if( transcode_video_renditions_open( p_owner->p_stream, id,
+                                         out_fmt, enc_vctx ) != VLC_SUCCESS )
+        goto error;
     vlc_mutex_unlock(&id->fifo.lock);
 
     if( !id->downstream_id )
@@ -225,6 +356,19 @@ static int video_update_format_decoder( decoder_t *p_dec, vlc_video_context *vct
                                              id->p_decoder->fmt_in,
                                              transcode_encoder_format_out( id->encoder ),
                                              id->es_id );
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+        if( r->downstream_id )
+            continue;
+        /* Only the ES id differs from the source, the format is not owned */
+        es_format_t fmt_orig = *id->p_decoder->fmt_in;
+        fmt_orig.i_id = r->i_es_id;
+        r->downstream_id =
+            id->pf_transcode_downstream_add( p_owner->p_stream, &fmt_orig,
+                                             transcode_encoder_format_out( r->encoder ),
+                                             r->psz_es_id );
+    }
     msg_Info( p_dec, "video format update succeed" );
 
 end:
@@ -232,6 +376,8 @@ end:
 
 error:
     transcode_remove_filters( &id->p_final_conv_static );
+    for( size_t i = 0; i < id->i_renditions; ++i )
+        transcode_remove_filters( &id->p_renditions[i].p_conv );
 
     if( transcode_encoder_opened( id->encoder ) )
         transcode_encoder_close( id->encoder );
@@ -252,11 +398,8 @@ static picture_t *video_new_buffer_encoder( transcode_encoder_t *p_enc )
 static int transcode_process_picture( sout_stream_id_sys_t *id,
                                       picture_t *p_pic, block_t **out);
 
-static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+static void transcode_video_output( sout_stream_id_sys_t *id, picture_t *p_pic )
 {
-    struct decoder_owner *p_owner = dec_get_owner( p_dec );
-    sout_stream_id_sys_t *id = p_owner->id;
-
     block_t *p_block = NULL;
     int ret = transcode_process_picture( id, p_pic, &p_block );
 
@@ -276,6 +419,126 @@ static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
     vlc_fifo_Unlock( id->output_fifo );
 }
 
+/* Filtering stage, processing the decoded pictures on its own thread, in
+ * decoding order */
+struct transcode_filter_stage
+{
+    sout_stream_id_sys_t *id;
+    vlc_thread_t    thread;
+    vlc_mutex_t     lock;
+    vlc_cond_t      wait;
+    vlc_cond_t      idle;
+    vlc_sem_t       has_room;
+    picture_fifo_t *pics;
+    bool            b_busy; /* pictures are queued or being processed */
+    bool            b_abort;
+};
+
+static void *FilterThread( void *data )
+{
+    vlc_thread_set_name("vlc-transcode");
+
+    struct transcode_filter_stage *p_stage = data;
+
+    vlc_mutex_lock( &p_stage->lock );
+    for( ;; )
+    {
+        picture_t *p_pic = picture_fifo_Pop( p_stage->pics );
+        if( p_pic == NULL )
+        {
+            p_stage->b_busy = false;
+            vlc_cond_broadcast( &p_stage->idle );
+            if( p_stage->b_abort )
+                break;
+            vlc_cond_wait( &p_stage->wait, &p_stage->lock );
+            continue;
+        }
+        vlc_mutex_unlock( &p_stage->lock );
+        vlc_sem_post( &p_stage->has_room );
+
+        transcode_video_output( p_stage->id, p_pic );
+
+        vlc_mutex_lock( &p_stage->lock );
+    }
+    vlc_mutex_unlock( &p_stage->lock );
+
+    return NULL;
+}
+
+static struct transcode_filter_stage *
+filter_stage_New( sout_stream_id_sys_t *id, unsigned i_queue_size )
+{
+    struct transcode_filter_stage *p_stage = malloc( sizeof(*p_stage) );
+    if( unlikely(p_stage == NULL) )
+        return NULL;
+
+    p_stage->pics = picture_fifo_New();
+    if( unlikely(p_stage->pics == NULL) )
+    {
+        free( p_stage );
+        return NULL;
+    }
+
+    p_stage->id = id;
+    vlc_mutex_init( &p_stage->lock );
+    vlc_cond_init( &p_stage->wait );
+    vlc_cond_init( &p_stage->idle );
+    vlc_sem_init( &p_stage->has_room, i_queue_size );
+    p_stage->b_busy = false;
+    p_stage->b_abort = false;
+
+    if( vlc_clone( &p_stage->thread, FilterThread, p_stage ) )
+    {
+        picture_fifo_Delete( p_stage->pics );
+        free( p_stage );
+        return NULL;
+    }
+    return p_stage;
+}
+
+static void filter_stage_Queue( struct transcode_filter_stage *p_stage,
+                                picture_t *p_pic )
+{
+    vlc_sem_wait( &p_stage->has_room );
+    vlc_mutex_lock( &p_stage->lock );
+    picture_fifo_Push( p_stage->pics, p_pic );
+    p_stage->b_busy = true;
+    vlc_cond_signal( &p_stage->wait );
+    vlc_mutex_unlock( &p_stage->lock );
+}
+
+/* Waits until all the queued pictures are processed */
+static void filter_stage_Wait( struct transcode_filter_stage *p_stage )
+{
+    vlc_mutex_lock( &p_stage->lock );
+    while( p_stage->b_busy )
+        vlc_cond_wait( &p_stage->idle, &p_stage->lock );
+    vlc_mutex_unlock( &p_stage->lock );
+}
+
+static void filter_stage_Delete( struct transcode_filter_stage *p_stage )
+{
+    vlc_mutex_lock( &p_stage->lock );
+    p_stage->b_abort = true;
+    vlc_cond_signal( &p_stage->wait );
+    vlc_mutex_unlock( &p_stage->lock );
+    vlc_join( p_stage->thread, NULL );
+
+    picture_fifo_Delete( p_stage->pics );
+    free( p_stage );
+}
+
+static void decoder_queue_video( decoder_t *p_dec, picture_t *p_pic )
+{
+    struct decoder_owner *p_owner = dec_get_owner( p_dec );
+    sout_stream_id_sys_t *id = p_owner->id;
+
+    if( id->p_filter_stage != NULL )
+        filter_stage_Queue( id->p_filter_stage, p_pic );
+    else
+        transcode_video_output( id, p_pic );
+}
+
 int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
                           sout_stream_id_sys_t *id )
 {
@@ -307,11 +570,70 @@ int transcode_video_init( sout_stream_t *p_stream, const es_format_t *p_fmt,
     id->p_decoder->pf_decode = NULL;
     id->p_decoder->pf_get_cc = NULL;
 
+    sout_stream_sys_t *p_sys = p_stream->p_sys;
+    id->i_renditions = 0;
+    id->p_renditions = NULL;
+    if( p_sys->i_vrenditions > 0 )
+    {
+        id->p_renditions = calloc( p_sys->i_vrenditions,
+                                   sizeof(*id->p_renditions) );
+        if( unlikely(id->p_renditions == NULL) )
+        {
+            es_format_Clean( &id->decoder_out );
+            block_FifoRelease( id->output_fifo );
+            return VLC_ENOMEM;
+        }
+        id->i_renditions = p_sys->i_vrenditions;
+    }
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+        const transcode_rendition_config_t *p_rcfg = &p_sys->p_vrenditions[i];
+
+        r->cfg = *id->p_enccfg;
+        r->cfg.video.f_scale = 0.f;
+        r->cfg.video.i_width = p_rcfg->i_width;
+        r->cfg.video.i_height = p_rcfg->i_height;
+        r->cfg.video.i_maxwidth = r->cfg.video.i_maxheight = 0;
+        if( p_rcfg->i_bitrate > 0 )
+            r->cfg.video.i_bitrate = p_rcfg->i_bitrate;
+        r->pp_out_last = &r->p_out;
+        if( id->es_id != NULL &&
+            asprintf( &r->psz_es_id, "%s/%zu", id->es_id, i + 1 ) < 0 )
+            r->psz_es_id = NULL;
+        vlc_mutex_lock( &p_sys->lock );
+        r->i_es_id = ++p_sys->i_last_es_id;
+        vlc_mutex_unlock( &p_sys->lock );
+    }
+
+    id->p_filter_stage = NULL;
+    if( id->p_filterscfg->video.b_threaded )
+    {
+        /* The filter thread blends the subpictures: the spu must exist
+         * before it starts, as it is never assigned afterwards */
+        id->p_spu = spu_Create( p_stream, NULL );
+        id->p_filter_stage =
+            filter_stage_New( id, id->p_enccfg->video.threads.pool_size );
+        if( id->p_filter_stage == NULL )
+            msg_Warn( p_stream, "cannot create the filter thread" );
+    }
+
     decoder_LoadModule( id->p_decoder, false, true );
 
     if( !id->p_decoder->p_module )
     {
         msg_Err( p_stream, "cannot find video decoder" );
+        if( id->p_filter_stage != NULL )
+        {
+            filter_stage_Delete( id->p_filter_stage );
+            id->p_filter_stage = NULL;
+        }
+        if( id->p_spu )
+        {
+            spu_Destroy( id->p_spu );
+            id->p_spu = NULL;
+        }
+        transcode_video_renditions_clean( p_stream, id );
         es_format_Clean( &id->decoder_out );
         return VLC_EGENERIC;
     }
@@ -395,16 +717,29 @@ static int transcode_video_filters_init( sout_stream_t *p_stream,
 
 void transcode_video_flush( sout_stream_id_sys_t *id )
 {
+    /* The pictures already output by the decoder are encoded, as without
+     * the filter thread, since the output fifo is not flushed */
+    if ( id->p_filter_stage != NULL )
+        filter_stage_Wait( id->p_filter_stage );
     if ( id->p_f_chain != NULL )
         filter_chain_VideoFlush( id->p_f_chain );
     if ( id->p_uf_chain != NULL )
         filter_chain_VideoFlush( id->p_uf_chain );
     if ( id->p_final_conv_static != NULL )
         filter_chain_VideoFlush( id->p_final_conv_static );
+    for( size_t i = 0; i < id->i_renditions; ++i )
+        if( id->p_renditions[i].p_conv != NULL )
+            filter_chain_VideoFlush( id->p_renditions[i].p_conv );
 }
 
-void transcode_video_clean( sout_stream_id_sys_t *id )
+void transcode_video_clean( sout_stream_t *p_stream, sout_stream_id_sys_t *id )
 {
+    /* Process the last pictures before closing the encoder */
+    if ( id->p_filter_stage != NULL )
+        filter_stage_Delete( id->p_filter_stage );
+
+    transcode_video_renditions_clean( p_stream, id );
+
     /* Close encoder, but only if one was opened. */
     if ( id->encoder )
         transcode_encoder_delete( id->encoder );
@@ -428,7 +763,8 @@ void transcode_video_clean( sout_stream_id_sys_t *id )
 void transcode_video_push_spu( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
                                subpicture_t *p_subpicture )
 {
-    if( !id->p_spu )
+    /* Created beforehand when the filter thread may be reading it */
+    if( !id->p_spu && id->p_filter_stage == NULL )
         id->p_spu = spu_Create( p_stream, NULL );
     if( !id->p_spu )
         subpicture_Delete( p_subpicture );
@@ -527,14 +863,16 @@ static int transcode_process_picture( sout_stream_id_sys_t *id,
         for( ;; p_in = NULL /* drain second time */ )
         {
             /* Run user specified filter chain */
-            filter_chain_t * secondary_chains[] = { id->p_uf_chain,
-                                                    id->p_final_conv_static };
-            for( size_t i=0; i<ARRAY_SIZE(secondary_chains); i++ )
-            {
-                if( !secondary_chains[i] )
-                    continue;
-                p_in = filter_chain_VideoFilter( secondary_chains[i], p_in );
-            }
+            if( id->p_uf_chain )
+                p_in = filter_chain_VideoFilter( id->p_uf_chain, p_in );
+
+            /* The renditions share the filtered pictures, without the
+             * overlays and the conversion of the main output */
+            if( p_in && id->i_renditions > 0 )
+                transcode_video_renditions_encode( id, p_in );
+
+            if( id->p_final_conv_static )
+                p_in = filter_chain_VideoFilter( id->p_final_conv_static, p_in );
 
             if( !p_in )
                 break;
@@ -573,6 +911,11 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
     if( id->encoder == NULL )
         return VLC_SUCCESS;
 
+    /* The filter thread must be done before draining the encoder or
+     * tagging the end of the sequence */
+    if( ( in == NULL || b_eos ) && id->p_filter_stage != NULL )
+        filter_stage_Wait( id->p_filter_stage );
+
     vlc_fifo_Lock( id->output_fifo );
     if( unlikely( !id->b_error && in == NULL ) && transcode_encoder_opened( id->encoder ) )
     {
@@ -588,10 +931,49 @@ int transcode_video_process( sout_stream_t *p_stream, sout_stream_id_sys_t *id,
         vlc_frame_t *pendings = vlc_fifo_DequeueAllUnlocked( id->output_fifo );
         block_ChainAppend(out, pendings);
     }
+
+    block_t *rendition_out[id->i_renditions ? id->i_renditions : 1];
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        rendition_out[i] = r->p_out;
+        r->p_out = NULL;
+        r->pp_out_last = &r->p_out;
+        if( r->encoder == NULL || !transcode_encoder_opened( r->encoder ) )
+            continue;
+
+        block_ChainAppend( &rendition_out[i],
+                           transcode_encoder_get_output_async( r->encoder ) );
+        if( unlikely( !has_error && in == NULL ) &&
+            transcode_encoder_drain( r->encoder, &rendition_out[i] ) != VLC_SUCCESS )
+            msg_Warn( p_stream, "Draining rendition %zu failed", i + 1 );
+    }
     vlc_fifo_Unlock( id->output_fifo );
 
     if( b_eos )
         tag_last_block_with_flag( out, BLOCK_FLAG_END_OF_SEQUENCE );
 
+    for( size_t i = 0; i < id->i_renditions; ++i )
+    {
+        struct transcode_rendition *r = &id->p_renditions[i];
+
+        if( has_error || r->downstream_id == NULL )
+        {
+            block_ChainRelease( rendition_out[i] );
+            continue;
+        }
+        if( b_eos )
+            tag_last_block_with_flag( &rendition_out[i], BLOCK_FLAG_END_OF_SEQUENCE );
+
+        for( block_t *it = rendition_out[i]; it != NULL; )
+        {
+            block_t *next = it->p_next;
+            it->p_next = NULL;
+            sout_StreamIdSend( p_stream->p_next, r->downstream_id, it );
+            it = next;
+        }
+    }
+
     return has_error ? VLC_EGENERIC : VLC_SUCCESS;
 }
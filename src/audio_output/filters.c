@@ -362,6 +362,9 @@ static void aout_FiltersPipelineChangeViewpoint(const struct aout_filter *tab,
 
 #define AOUT_MAX_FILTERS 10
 
+/* Number of frames per plane of the shared in-place filtering buffer */
+#define AOUT_GRAPH_FRAMES 256
+
 struct aout_filters
 {
     filter_t *rate_filter; /**< The filter adjusting samples count
@@ -373,8 +376,155 @@ struct aout_filters
     unsigned count; /**< Number of filters */
     struct aout_filter tab[AOUT_MAX_FILTERS]; /**< Configured user filters
         (e.g. equalization) and their conversions */
+
+    unsigned graph_run[AOUT_MAX_FILTERS]; /**< Number of successive filters
+        processed in place from each one (0 if not processed in place) */
+    float **graph_planes; /**< Shared planar buffer (or NULL) */
 };
 
+static bool aout_filter_IsPlanar(const filter_t *filter)
+{
+    return filter->ops->filter_audio_planar != NULL
+        && filter->fmt_in.audio.i_format == VLC_CODEC_FL32
+        && AOUT_FMTS_IDENTICAL(&filter->fmt_in.audio, &filter->fmt_out.audio);
+}
+
+/**
+ * Finds the runs of successive filters that can process samples in place,
+ * and allocates the shared planar buffer for them.
+ */
+static void aout_FiltersGraphInit(vlc_object_t *obj,
+                                  aout_filters_t *restrict filters)
+{
+    unsigned channels = 0, runs = 0;
+
+    for (unsigned i = 0; i < filters->count; i++)
+        filters->graph_run[i] = 0;
+    filters->graph_planes = NULL;
+
+    if (!var_InheritBool(obj, "audio-filter-graph"))
+        return;
+
+    for (unsigned i = 0; i < filters->count;)
+    {
+        unsigned n = 0;
+
+        while (i + n < filters->count
+            && aout_filter_IsPlanar(filters->tab[i + n].f))
+            n++;
+
+        /* A lone filter is faster on the interleaved samples */
+        if (n < 2)
+        {
+            i++;
+            continue;
+        }
+
+        const unsigned run_channels = filters->tab[i].f->fmt_in.audio.i_channels;
+        if (run_channels > channels)
+            channels = run_channels;
+        filters->graph_run[i] = n;
+        runs++;
+        i += n;
+    }
+
+    if (runs == 0)
+        return;
+
+    float **planes = malloc(channels * (sizeof (*planes)
+                                    + AOUT_GRAPH_FRAMES * sizeof (**planes)));
+    if (unlikely(planes == NULL))
+    {
+        for (unsigned i = 0; i < filters->count; i++)
+            filters->graph_run[i] = 0;
+        return;
+    }
+
+    float *buf = (float *)(planes + channels);
+    for (unsigned c = 0; c < channels; c++)
+        planes[c] = buf + c * AOUT_GRAPH_FRAMES;
+    filters->graph_planes = planes;
+    msg_Dbg(obj, "%u run(s) of filters processed in place", runs);
+}
+
+/**
+ * Runs successive filters in place on a block, one chunk of the shared
+ * planar buffer at a time.
+ */
+static void aout_FiltersGraphProcess(const aout_filters_t *filters,
+                                     const struct aout_filter *tab,
+                                     unsigned count, block_t *block)
+{
+    float *const *planes = filters->graph_planes;
+    const unsigned channels = tab[0].f->fmt_in.audio.i_channels;
+    float *samples = (float *)block->p_buffer;
+    size_t remaining = block->i_nb_samples;
+
+    if (channels == 1)
+    {   /* Already planar */
+        for (unsigned i = 0; i < count; i++)
+            tab[i].f->ops->filter_audio_planar(tab[i].f, &samples, remaining);
+        return;
+    }
+
+    while (remaining > 0)
+    {
+        const size_t frames = remaining < AOUT_GRAPH_FRAMES
+                            ? remaining : AOUT_GRAPH_FRAMES;
+
+        for (unsigned c = 0; c < channels; c++)
+        {
+            float *restrict plane = planes[c];
+            const float *restrict in = samples + c;
+
+            for (size_t i = 0; i < frames; i++)
+                plane[i] = in[i * channels];
+        }
+
+        for (unsigned i = 0; i < count; i++)
+            tab[i].f->ops->filter_audio_planar(tab[i].f, planes, frames);
+
+        for (unsigned c = 0; c < channels; c++)
+        {
+            const float *restrict plane = planes[c];
+            float *restrict out = samples + c;
+
+            for (size_t i = 0; i < frames; i++)
+                out[i * channels] = plane[i];
+        }
+
+        samples += frames * channels;
+        remaining -= frames;
+    }
+}
+
+/**
+ * Filters an audio buffer through the user filters.
+ */
+static block_t *aout_FiltersGraphPlay(const aout_filters_t *filters,
+                                      block_t *block)
+{
+    if (filters->graph_planes == NULL)
+        return aout_FiltersPipelinePlay(filters->tab, filters->count, block);
+
+    for (unsigned i = 0; (i < filters->count) && (block != NULL);)
+    {
+        const unsigned n = filters->graph_run[i];
+
+        if (n > 0)
+        {
+            aout_FiltersGraphProcess(filters, &filters->tab[i], n, block);
+            i += n;
+        }
+        else
+        {
+            block = aout_FiltersPipelinePlay(&filters->tab[i], 1, block);
+            i++;
+        }
+    }
+    return block;
+}
+
 /** Callback for visualization selection */
 static int VisualizationCallback (vlc_object_t *obj, const char *var,
                                   vlc_value_t oldval, vlc_value_t newval,
@@ -556,6 +706,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
     filters->resampling = 0;
     filters->count = 0;
     filters->clock_source = clock;
+    filters->graph_planes = NULL;
 
     /* Prepare format structure */
     aout_FormatPrint (obj, "input", infmt);
@@ -630,6 +781,27 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
 
     assert(input_format.channel_type == AUDIO_CHANNEL_TYPE_BITMAP);
 
+    char *str = var_InheritString (obj, "audio-filter");
+    char *visual = var_InheritString(obj, "audio-visual");
+    const bool has_visual = visual != NULL && strcasecmp(visual, "none");
+
+    if (input_format.i_format != VLC_CODEC_FL32
+     && var_InheritBool (obj, "audio-filter-graph")
+     && ((str != NULL && *str) || has_visual
+      || var_InheritBool (obj, "audio-time-stretch")))
+    {
+        /* Convert once at the head of the chain, so that filters accepting
+         * any format do not process integers between float ones. */
+        audio_sample_format_t float_format = input_format;
+
+        float_format.i_format = VLC_CODEC_FL32;
+        aout_FormatPrepare (&float_format);
+        if (aout_FiltersPipelineCreate (obj, filters->tab, &filters->count,
+                                        AOUT_MAX_FILTERS, &input_format,
+                                        &float_format) == 0)
+            input_format = float_format;
+    }
+
     /* parse user filter lists */
     if (var_InheritBool (obj, "audio-time-stretch"))
     {
@@ -643,7 +815,6 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
                           cfg->remap);
 
     /* Now add user filters */
-    char *str = var_InheritString (obj, "audio-filter");
     if (str != NULL)
     {
         char *p = str, *name;
@@ -655,8 +826,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
         free (str);
     }
 
-    char *visual = var_InheritString(obj, "audio-visual");
-    if (visual != NULL && strcasecmp(visual, "none"))
+    if (has_visual)
         AppendFilter(obj, "visualization", visual, filters,
                      &input_format, &output_format, NULL);
     free(visual);
@@ -684,6 +854,7 @@ aout_filters_t *aout_FiltersNewWithClock(vlc_object_t *obj, vlc_clock_t *clock,
     if (filters->rate_filter == NULL)
         filters->rate_filter = filters->resampler.f;
 
+    aout_FiltersGraphInit(obj, filters);
     return filters;
 
 error:
@@ -764,6 +935,7 @@ void aout_FiltersDelete (vlc_object_t *obj, aout_filters_t *filters)
         aout_FiltersPipelineDestroy(&filters->resampler, 1);
     aout_FiltersPipelineDestroy (filters->tab, filters->count);
     var_DelCallback(obj, "visual", VisualizationCallback, NULL);
+    free (filters->graph_planes);
     free (filters);
 }
 
@@ -800,7 +972,7 @@ block_t *aout_FiltersPlay(aout_filters_t *filters, block_t *block, float rate)
         rate_filter->fmt_in.audio.i_rate = lroundf(nominal_rate * rate);
     }
 
-    block = aout_FiltersPipelinePlay (filters->tab, filters->count, block);
+    block = aout_FiltersGraphPlay (filters, block);
     if (filters->resampler.f != NULL)
     {   /* NOTE: the resampler needs to run even if resampling is 0.
          * The decoder and output rates can still be different. */
@@ -324,7 +324,7 @@ stream_t *stream_AccessNew(vlc_object_t *parent, input_thread_t *input,
         s->pf_control = AStreamControl;
         s->p_sys = access;
 
-        s = stream_FilterChainNew(s, "prefetch,cache");
+        s = stream_FilterChainNew(s, "cache_range,prefetch,cache");
     }
     else
         s = access;
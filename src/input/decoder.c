@@ -205,6 +205,13 @@ struct vlc_input_decoder_t
 
     bool error;
 
+    /* Thumbnailing */
+    bool thumbnailing;
+    bool keyframe_only; /**< Skip non-reference frames */
+
+    /* Scrubbing: favour decoding speed over quality, drop audio */
+    bool scrubbing;
+
     /* Waiting */
     bool b_waiting;
     bool b_first;
@@ -985,6 +992,16 @@ static float ModuleThread_GetDisplayRate( decoder_t *p_dec )
     return rate;
 }
 
+static bool ModuleThread_IsScrubbing( decoder_t *p_dec )
+{
+    vlc_input_decoder_t *p_owner = dec_get_owner( p_dec );
+
+    vlc_fifo_Lock(p_owner->p_fifo);
+    bool scrubbing = p_owner->scrubbing;
+    vlc_fifo_Unlock(p_owner->p_fifo);
+    return scrubbing;
+}
+
 /*****************************************************************************
  * Public functions
  *****************************************************************************/
@@ -1608,6 +1625,25 @@ static void DecoderThread_DecodeBlock( vlc_input_decoder_t *p_owner, vlc_frame_t
     decoder_t *p_dec = &p_owner->dec;
     struct vlc_tracer *tracer = vlc_object_get_tracer( &p_dec->obj );
 
+    if( frame != NULL && p_owner->thumbnailing )
+    {
+        /* Nothing is decoded once the thumbnail is ready (until the next
+         * seek), and in fast mode, non-reference frames are skipped. */
+        if( !p_owner->b_first
+         || ( p_owner->keyframe_only && (frame->i_flags & BLOCK_FLAG_TYPE_B) ) )
+        {
+            block_Release( frame );
+            return;
+        }
+    }
+
+    /* Audio is not heard while scrubbing, do not spend time decoding it */
+    if( frame != NULL && p_owner->scrubbing && p_dec->fmt_in->i_cat == AUDIO_ES )
+    {
+        block_Release( frame );
+        return;
+    }
+
     vlc_fifo_Unlock(p_owner->p_fifo);
 
     if ( tracer != NULL && frame != NULL )
@@ -1887,6 +1923,7 @@ static const struct decoder_owner_callbacks dec_video_cbs =
         .queue_cc = ModuleThread_QueueCc,
         .get_display_date = ModuleThread_GetDisplayDate,
         .get_display_rate = ModuleThread_GetDisplayRate,
+        .is_scrubbing = ModuleThread_IsScrubbing,
     },
     .get_attachments = InputThread_GetInputAttachments,
 };
@@ -1945,6 +1982,9 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     p_owner->i_preroll_end = PREROLL_NONE;
     p_owner->p_resource = cfg->resource;
     p_owner->hw_dec = cfg->hw_dec;
+    p_owner->thumbnailing = false;
+    p_owner->keyframe_only = cfg->keyframe_only;
+    p_owner->scrubbing = false;
     p_owner->cbs = cfg->cbs;
     p_owner->cbs_userdata = cfg->cbs_data;
     p_owner->p_aout = NULL;
@@ -2021,7 +2061,10 @@ CreateDecoder( vlc_object_t *p_parent, const struct vlc_input_decoder_cfg *cfg )
     {
         case VIDEO_ES:
             if( cfg->input_type == INPUT_TYPE_THUMBNAILING )
+            {
                 p_dec->cbs = &dec_thumbnailer_cbs;
+                p_owner->thumbnailing = true;
+            }
             else
                 p_dec->cbs = &dec_video_cbs;
             break;
@@ -2636,6 +2679,13 @@ void vlc_input_decoder_ChangeRate( vlc_input_decoder_t *owner, float rate )
     vlc_fifo_Unlock( owner->p_fifo );
 }
 
+void vlc_input_decoder_SetScrubbing( vlc_input_decoder_t *owner, bool scrubbing )
+{
+    vlc_fifo_Lock( owner->p_fifo );
+    owner->scrubbing = scrubbing;
+    vlc_fifo_Unlock( owner->p_fifo );
+}
+
 void vlc_input_decoder_ChangeDelay( vlc_input_decoder_t *owner, vlc_tick_t delay )
 {
     vlc_fifo_Lock( owner->p_fifo );
@@ -2683,6 +2733,9 @@ void vlc_input_decoder_Wait( vlc_input_decoder_t *p_owner )
          * owner */
         if( p_owner->paused )
             break;
+        /* Audio blocks are dropped undecoded while scrubbing */
+        if( p_owner->scrubbing && p_owner->dec.fmt_in->i_cat == AUDIO_ES )
+            break;
         if( p_owner->b_idle && vlc_fifo_IsEmpty( p_owner->p_fifo ) )
         {
             msg_Err( &p_owner->dec, "buffer deadlock prevented" );
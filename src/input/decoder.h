@@ -61,6 +61,7 @@ struct vlc_input_decoder_cfg
     sout_stream_t *sout;
     enum input_type input_type;
     bool hw_dec;
+    bool keyframe_only; /**< thumbnailing only: skip non-reference frames */
     unsigned cc_decoder;
     const struct vlc_input_decoder_callbacks *cbs;
     void *cbs_data;
@@ -86,6 +87,17 @@ void vlc_input_decoder_ChangePause( vlc_input_decoder_t *, bool b_paused, vlc_ti
  */
 void vlc_input_decoder_ChangeRate( vlc_input_decoder_t *dec, float rate );
 
+/**
+ * Changes the decoder scrubbing state.
+ *
+ * While scrubbing, video decoders are asked to favour speed over quality
+ * (cf. decoder_IsScrubbing()) and audio blocks are dropped without being
+ * decoded.
+ * \param dec decoder
+ * \param scrubbing true to enable the scrubbing mode
+ */
+void vlc_input_decoder_SetScrubbing( vlc_input_decoder_t *dec, bool scrubbing );
+
 /**
  * This function makes the decoder start waiting for a valid data block from its fifo.
  */
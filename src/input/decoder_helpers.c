@@ -193,6 +193,77 @@ int decoder_UpdateVideoOutput( decoder_t *dec, vlc_video_context *vctx_out )
     return dec->cbs->video.format_update( dec, vctx_out );
 }
 
+/* Threads held by the decoders of the process */
+static struct
+{
+    vlc_mutex_t lock;
+    unsigned used;
+    unsigned holders;
+    uint64_t pixels; /* sum of the holders picture sizes */
+} thread_budget = { VLC_STATIC_MUTEX, 0, 0, 0 };
+
+/* Pictures smaller than this do not benefit from one more thread */
+#define PIXELS_PER_THREAD (320 * 240)
+
+static uint64_t GetThreadWeight( const decoder_t *dec )
+{
+    const video_format_t *fmt = &dec->fmt_in->video;
+    if( dec->fmt_in->i_cat == VIDEO_ES && fmt->i_width && fmt->i_height )
+        return (uint64_t)fmt->i_width * fmt->i_height;
+    return 1920 * 1080; /* unknown yet */
+}
+
+unsigned decoder_AcquireThreads( decoder_t *dec, unsigned wanted,
+                                 decoder_threads_t *res )
+{
+    int64_t budget = var_InheritInteger( dec, "dec-threads" );
+    if( budget <= 0 )
+        budget = vlc_GetCPUCount();
+
+    const uint64_t pixels = GetThreadWeight( dec );
+    const uint64_t useful = (pixels + PIXELS_PER_THREAD - 1) / PIXELS_PER_THREAD;
+    if( wanted > useful )
+        wanted = useful;
+
+    vlc_mutex_lock( &thread_budget.lock );
+    /* Take what is left, but no less than the share of the budget
+     * matching the picture size, compared to the other decoders */
+    unsigned left = budget > thread_budget.used ? budget - thread_budget.used : 0;
+    unsigned share = budget * pixels / (thread_budget.pixels + pixels);
+    unsigned threads = __MIN( wanted, __MAX( left, share ) );
+    if( threads == 0 )
+        threads = 1;
+    thread_budget.used += threads;
+    thread_budget.holders++;
+    thread_budget.pixels += pixels;
+    unsigned used = thread_budget.used;
+    vlc_mutex_unlock( &thread_budget.lock );
+
+    msg_Dbg( dec, "using %u decoding thread(s), %u/%"PRId64" in use",
+             threads, used, budget );
+    /* The format can change until the release: keep what was accounted */
+    res->count = threads;
+    res->weight = pixels;
+    return threads;
+}
+
+void decoder_ReleaseThreads( decoder_threads_t *res )
+{
+    if( res->count == 0 )
+        return;
+
+    vlc_mutex_lock( &thread_budget.lock );
+    assert( thread_budget.holders > 0 && thread_budget.used >= res->count );
+    assert( thread_budget.pixels >= res->weight );
+    thread_budget.used -= res->count;
+    thread_budget.holders--;
+    thread_budget.pixels -= res->weight;
+    vlc_mutex_unlock( &thread_budget.lock );
+
+    res->count = 0;
+    res->weight = 0;
+}
+
 picture_t *decoder_NewPicture( decoder_t *dec )
 {
     vlc_assert( dec->fmt_in->i_cat == VIDEO_ES && dec->cbs != NULL );
@@ -218,6 +218,7 @@ typedef struct
     vlc_tick_t  i_pts_jitter;
     int         i_cr_average;
     float       rate;
+    bool        b_scrubbing;
 
     /* */
     bool        b_paused;
@@ -942,6 +943,19 @@ static void EsOutChangeRate(es_out_sys_t *p_sys, float rate)
             vlc_input_decoder_ChangeRate( es->p_dec, rate );
 }
 
+static void EsOutChangeScrubbing(es_out_sys_t *p_sys, bool b_scrubbing)
+{
+    es_out_id_t *es;
+
+    if( p_sys->b_scrubbing == b_scrubbing )
+        return;
+    p_sys->b_scrubbing = b_scrubbing;
+
+    foreach_es_then_es_slaves(es)
+        if( es->p_dec != NULL )
+            vlc_input_decoder_SetScrubbing( es->p_dec, b_scrubbing );
+}
+
 static void EsOutChangePosition(es_out_sys_t *p_sys, bool b_flush,
                                 es_out_id_t *p_next_frame_es)
 {
@@ -2370,6 +2384,7 @@ static void EsOutCreateDecoder(es_out_sys_t *p_sys, es_out_id_t *p_es)
         .sout = priv->p_sout,
         .input_type = p_sys->input_type,
         .hw_dec = priv->hw_dec,
+        .keyframe_only = priv->thumbnail_keyframe_only,
         .cc_decoder = p_sys->cc_decoder,
         .cbs = &decoder_cbs,
         .cbs_data = p_es,
@@ -2387,6 +2402,9 @@ static void EsOutCreateDecoder(es_out_sys_t *p_sys, es_out_id_t *p_es)
     {
         vlc_input_decoder_ChangeRate( dec, p_sys->rate );
 
+        if( p_sys->b_scrubbing )
+            vlc_input_decoder_SetScrubbing( dec, true );
+
         if( unlikely( p_sys->b_paused ) ) /* Could happen during next-frame */
             vlc_input_decoder_ChangePause( dec, true, p_sys->i_pause_date );
 
@@ -3665,6 +3683,15 @@ static int EsOutVaControlLocked(es_out_sys_t *p_sys, input_source_t *source,
         return VLC_SUCCESS;
     }
 
+    case ES_OUT_POST_PARTIAL_SUBNODE:
+    {
+        /* Only accepted if the owner of the input handles it */
+        input_thread_t *input = p_sys->p_input;
+        input_item_node_t *node = va_arg(args, input_item_node_t *);
+        return input_SendEventPartialParsing(input, node) ? VLC_SUCCESS
+                                                          : VLC_EGENERIC;
+    }
+
     case ES_OUT_VOUT_SET_MOUSE_EVENT:
     {
         es_out_id_t *p_es = va_arg( args, es_out_id_t * );
@@ -3928,6 +3955,12 @@ static int EsOutVaPrivControlLocked(es_out_sys_t *p_sys, input_source_t *source,
     case ES_OUT_PRIV_SET_FRAME_NEXT:
         EsOutFrameNext(p_sys);
         return VLC_SUCCESS;
+    case ES_OUT_PRIV_SET_SCRUBBING:
+    {
+        const bool b_scrubbing = (bool)va_arg( args, int );
+        EsOutChangeScrubbing(p_sys, b_scrubbing);
+        return VLC_SUCCESS;
+    }
     case ES_OUT_PRIV_SET_TIMES:
     {
         double f_position = va_arg( args, double );
@@ -4146,6 +4179,7 @@ input_EsOutNew(input_thread_t *p_input, input_source_t *main_source, float rate,
     p_sys->i_pause_date = -1;
 
     p_sys->rate = rate;
+    p_sys->b_scrubbing = false;
 
     p_sys->b_buffering = true;
     p_sys->b_draining = false;
@@ -85,6 +85,9 @@ enum es_out_query_private_e
     /* Set next frame */
     ES_OUT_PRIV_SET_FRAME_NEXT,                     /*                          res=can fail */
 
+    /* Set scrubbing state */
+    ES_OUT_PRIV_SET_SCRUBBING,                      /* arg1=bool                res=cannot fail */
+
     /* Set position/time/length */
     ES_OUT_PRIV_SET_TIMES,                          /* arg1=double f_position arg2=vlc_tick_t i_time arg3=vlc_tick_t i_normal_time arg4=vlc_tick_t i_length arg5 int b_live res=cannot fail */
 
@@ -101,7 +104,10 @@ enum es_out_query_private_e
     ES_OUT_PRIV_SET_VBI_PAGE,                       /* arg1=unsigned res=can fail */
 
     /* Set VBI/Teletext menu transparent */
-    ES_OUT_PRIV_SET_VBI_TRANSPARENCY                /* arg1=bool res=can fail */
+    ES_OUT_PRIV_SET_VBI_TRANSPARENCY,               /* arg1=bool res=can fail */
+
+    /* Seek within the timeshift buffer */
+    ES_OUT_PRIV_SET_TIMESHIFT_TIME                  /* arg1=vlc_tick_t res=can fail */
 };
 
 struct vlc_input_es_out;
@@ -268,6 +274,13 @@ es_out_SetFrameNext(struct vlc_input_es_out *out )
     return es_out_PrivControl(out, ES_OUT_PRIV_SET_FRAME_NEXT);
 }
 
+static inline void
+es_out_SetScrubbing(struct vlc_input_es_out *out, bool scrubbing)
+{
+    int i_ret = es_out_PrivControl(out, ES_OUT_PRIV_SET_SCRUBBING, scrubbing);
+    assert( !i_ret );
+}
+
 static inline void
 es_out_SetTimes(struct vlc_input_es_out *out, double f_position,
                 vlc_tick_t i_time, vlc_tick_t i_normal_time,
@@ -319,6 +332,12 @@ es_out_SetVbiTransparency(struct vlc_input_es_out *out, vlc_es_id_t *id,
                               enabled);
 }
 
+static inline int
+es_out_SetTimeshiftTime(struct vlc_input_es_out *out, vlc_tick_t i_time)
+{
+    return es_out_PrivControl(out, ES_OUT_PRIV_SET_TIMESHIFT_TIME, i_time);
+}
+
 struct vlc_input_es_out *
 input_EsOutNew(input_thread_t *, input_source_t *main_source, float rate,
                enum input_type input_type);
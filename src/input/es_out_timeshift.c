@@ -95,7 +95,7 @@ typedef struct attribute_packed
     es_out_id_t *p_es;
     union{
         block_t *p_block;
-        int     i_offset;  /* We do not use file > INT_MAX */
+        uint64_t i_offset; /* Position of the block in the storage */
     };
 } ts_cmd_send_t;
 
@@ -191,25 +191,54 @@ static_assert(offsetof(ts_cmd_t, header) == offsetof(ts_cmd_send_t, header), "in
 static_assert(offsetof(ts_cmd_t, header) == offsetof(ts_cmd_control_t, header), "invalid packing");
 static_assert(offsetof(ts_cmd_t, header) == offsetof(ts_cmd_privcontrol_t, header), "invalid packing");
 
+typedef struct attribute_packed
+{
+    uint32_t   i_buffer;
+    uint32_t   i_flags;
+    uint32_t   i_nb_samples;
+    vlc_tick_t i_pts;
+    vlc_tick_t i_dts;
+    vlc_tick_t i_length;
+} ts_block_header_t;
+
+typedef struct
+{
+    uint64_t   i_cmd;    /* Sequence number of the C_SEND command */
+    uint64_t   i_offset; /* Position of the block in the storage */
+    vlc_tick_t i_date;
+    vlc_tick_t i_time;   /* Stream time reported before the block */
+} ts_index_t;
+
+/* The block data is written to a temporary file used as a ring buffer, and
+ * the commands are kept in memory. Positions and command sequence numbers
+ * only ever increase, they are wrapped when accessing the buffers. */
 typedef struct ts_storage_t ts_storage_t;
 struct ts_storage_t
 {
-    ts_storage_t *p_next;
-
     /* */
 #ifdef _WIN32
     char    *psz_file;  /* Filename */
 #endif
-    size_t  i_file_max; /* Max size in bytes */
-    int64_t i_file_size;/* Current size in bytes */
-    FILE    *p_filew;   /* FILE handle for data writing */
-    FILE    *p_filer;   /* FILE handle for data reading */
-
-    /* */
-    uint8_t *p_cmd_r;
-    uint8_t *p_cmd_w;
-    uint8_t *p_cmd_buf;
-    size_t   i_cmd_buf;
+    int      fd;
+    uint64_t i_data_max; /* Size of the ring buffer in bytes */
+    uint64_t i_data_r;   /* Position of the oldest unread block */
+    uint64_t i_data_w;   /* Position of the next block to write */
+
+    /* Circular buffer of commands */
+    ts_cmd_t *p_cmd;
+    size_t   i_cmd_alloc;
+    uint64_t i_cmd_r;
+    uint64_t i_cmd_w;
+
+    /* Circular buffer of the unread keyframes, sorted by position */
+    ts_index_t *p_index;
+    size_t   i_index_alloc;
+    uint64_t i_index_r;
+    uint64_t i_index_w;
+
+    /* Last stream times reported by the read and written commands */
+    vlc_tick_t i_time_r;
+    vlc_tick_t i_time_w;
 };
 
 typedef struct
@@ -241,11 +270,13 @@ typedef struct
     vlc_tick_t     i_buffering_delay;
 
     /* */
-    ts_storage_t   *p_storage_r;
-    ts_storage_t   *p_storage_w;
+    ts_storage_t   *p_storage;
 
     vlc_tick_t     i_cmd_delay;
 
+    /* The clock must be reset before the next command (after a seek) */
+    bool           b_reset_pcr;
+
 } ts_thread_t;
 
 struct es_out_id_t
@@ -259,7 +290,7 @@ struct es_out_timeshift
     struct vlc_input_es_out *p_out;
 
     /* Configuration */
-    int64_t        i_tmp_size_max;    /* Maximal temporary file size in byte */
+    int64_t        i_tmp_size_max;    /* Maximal timeshift buffer size in bytes */
     char           *psz_tmp_path;     /* Path for temporary files */
 
     /* Lock for all following fields */
@@ -294,16 +325,16 @@ static bool         TsHasCmd( ts_thread_t * );
 static bool         TsIsUnused( ts_thread_t * );
 static int          TsChangePause( ts_thread_t *, bool b_source_paused, bool b_paused, vlc_tick_t i_date );
 static int          TsChangeRate( ts_thread_t *, float src_rate, float rate );
+static int          TsSeek( ts_thread_t *, vlc_tick_t i_time );
 
 static void         *TsRun( void * );
 
-static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_tmp_size_max );
+static ts_storage_t *TsStorageNew( const char *psz_path, int64_t i_size_max );
 static void         TsStorageDelete( ts_storage_t * );
-static void         TsStoragePack( ts_storage_t *p_storage );
-static bool         TsStorageIsFull( ts_storage_t *, const ts_cmd_t *p_cmd );
 static bool         TsStorageIsEmpty( ts_storage_t * );
-static void         TsStoragePushCmd( ts_storage_t *, const ts_cmd_t *p_cmd, bool b_flush );
+static int          TsStoragePushCmd( ts_storage_t *, const ts_cmd_t *p_cmd, vlc_tick_t *pi_evicted );
 static void         TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush );
+static int          TsStorageSeek( ts_storage_t *, vlc_tick_t i_time, vlc_tick_t *pi_skipped );
 
 static void CmdClean( ts_cmd_t * );
 
@@ -720,6 +751,7 @@ static int ControlLocked( es_out_t *p_out, input_source_t *in, int i_query,
     }
 
     case ES_OUT_POST_SUBNODE:
+    case ES_OUT_POST_PARTIAL_SUBNODE:
         return es_out_in_vaControl( p_sys->p_out, in, i_query, args );
 
     default:
@@ -800,6 +832,14 @@ static int PrivControlLocked(struct vlc_input_es_out *p_tsout,
     }
     case ES_OUT_PRIV_GET_GROUP_FORCED:
         return es_out_in_vaPrivControl( p_sys->p_out, in, i_query, args );
+    case ES_OUT_PRIV_SET_TIMESHIFT_TIME:
+    {
+        const vlc_tick_t i_time = va_arg( args, vlc_tick_t );
+
+        if( !p_sys->b_delayed )
+            return VLC_EGENERIC;
+        return TsSeek( p_sys->p_ts, i_time );
+    }
     /* Invalid queries for this es_out level */
     case ES_OUT_PRIV_SET_ES:
     case ES_OUT_PRIV_UNSET_ES:
@@ -811,6 +851,7 @@ static int PrivControlLocked(struct vlc_input_es_out *p_tsout,
     case ES_OUT_PRIV_SET_ES_DELAY:
     case ES_OUT_PRIV_SET_DELAY:
     case ES_OUT_PRIV_SET_RECORD_STATE:
+    case ES_OUT_PRIV_SET_SCRUBBING:
     case ES_OUT_PRIV_SET_VBI_PAGE:
     case ES_OUT_PRIV_SET_VBI_TRANSPARENCY:
     default: vlc_assert_unreachable();
@@ -877,13 +918,10 @@ input_EsOutTimeshiftNew(input_thread_t *p_input,
     TAB_INIT( p_sys->i_es, p_sys->pp_es );
 
     /* */
-    const int i_tmp_size_max = var_CreateGetInteger( p_input, "input-timeshift-granularity" );
-    if( i_tmp_size_max < 0 )
-        p_sys->i_tmp_size_max = 50*1024*1024;
-    else
-        p_sys->i_tmp_size_max = __MAX( i_tmp_size_max, 1*1024*1024 );
-    msg_Dbg( p_input, "using timeshift granularity of %d MiB",
-             (int)p_sys->i_tmp_size_max/(1024*1024) );
+    const int64_t i_tmp_size_max = var_InheritInteger( p_input, "input-timeshift-size" );
+    p_sys->i_tmp_size_max = __MAX( i_tmp_size_max, 1 ) * 1024 * 1024;
+    msg_Dbg( p_input, "using timeshift buffer of %"PRId64" MiB",
+             p_sys->i_tmp_size_max/(1024*1024) );
 
     p_sys->psz_tmp_path = var_InheritString( p_input, "input-timeshift-path" );
 #if defined (_WIN32)
@@ -979,8 +1017,8 @@ static int TsStart(struct es_out_timeshift *p_sys)
     p_ts->i_rate_delay = 0;
     p_ts->i_buffering_delay = 0;
     p_ts->i_cmd_delay = 0;
-    p_ts->p_storage_r = NULL;
-    p_ts->p_storage_w = NULL;
+    p_ts->b_reset_pcr = false;
+    p_ts->p_storage = NULL;
 
     p_sys->b_delayed = true;
     if( vlc_clone( &p_ts->thread, TsRun, p_ts ) )
@@ -1025,9 +1063,8 @@ static void TsStop( ts_thread_t *p_ts )
 
         CmdClean( &cmd );
     }
-    assert( !p_ts->p_storage_r || !p_ts->p_storage_r->p_next );
-    if( p_ts->p_storage_r )
-        TsStorageDelete( p_ts->p_storage_r );
+    if( p_ts->p_storage )
+        TsStorageDelete( p_ts->p_storage );
     vlc_mutex_unlock( &p_ts->lock );
 
     TsDestroy( p_ts );
@@ -1036,32 +1073,30 @@ static void TsPushCmd( ts_thread_t *p_ts, ts_cmd_t *p_cmd )
 {
     vlc_mutex_lock( &p_ts->lock );
 
-    if( !p_ts->p_storage_w || TsStorageIsFull( p_ts->p_storage_w, p_cmd ) )
+    if( !p_ts->p_storage )
     {
-        ts_storage_t *p_storage = TsStorageNew( p_ts->psz_tmp_path, p_ts->i_tmp_size_max );
+        p_ts->p_storage = TsStorageNew( p_ts->psz_tmp_path, p_ts->i_tmp_size_max );
 
-        if( !p_storage )
+        if( !p_ts->p_storage )
         {
             CmdClean( p_cmd );
             vlc_mutex_unlock( &p_ts->lock );
             /* TODO warn the user (but only once) */
             return;
         }
-
-        if( !p_ts->p_storage_w )
-        {
-            p_ts->p_storage_r = p_ts->p_storage_w = p_storage;
-        }
-        else
-        {
-            TsStoragePack( p_ts->p_storage_w );
-            p_ts->p_storage_w->p_next = p_storage;
-            p_ts->p_storage_w = p_storage;
-        }
     }
 
     /* TODO return error and warn the user (but only once) */
-    TsStoragePushCmd( p_ts->p_storage_w, p_cmd, p_ts->p_storage_r == p_ts->p_storage_w );
+    vlc_tick_t i_evicted;
+    TsStoragePushCmd( p_ts->p_storage, p_cmd, &i_evicted );
+    if( i_evicted > 0 )
+    {
+        /* The oldest data was dropped, play the next keyframe as if it
+         * directly followed the last played command */
+        msg_Dbg( p_ts->p_input, "timeshift buffer full, dropped %"PRId64" ms",
+                 MS_FROM_VLC_TICK(i_evicted) );
+        p_ts->i_cmd_delay -= i_evicted;
+    }
 
     vlc_cond_signal( &p_ts->wait );
 
@@ -1071,20 +1106,10 @@ static int TsPopCmdLocked( ts_thread_t *p_ts, ts_cmd_t *p_cmd, bool b_flush )
 {
     vlc_mutex_assert( &p_ts->lock );
 
-    if( TsStorageIsEmpty( p_ts->p_storage_r ) )
+    if( TsStorageIsEmpty( p_ts->p_storage ) )
         return VLC_EGENERIC;
 
-    TsStoragePopCmd( p_ts->p_storage_r, p_cmd, b_flush );
-
-    while( TsStorageIsEmpty( p_ts->p_storage_r ) )
-    {
-        ts_storage_t *p_next = p_ts->p_storage_r->p_next;
-        if( !p_next )
-            break;
-
-        TsStorageDelete( p_ts->p_storage_r );
-        p_ts->p_storage_r = p_next;
-    }
+    TsStoragePopCmd( p_ts->p_storage, p_cmd, b_flush );
 
     return VLC_SUCCESS;
 }
@@ -1093,7 +1118,7 @@ static bool TsHasCmd( ts_thread_t *p_ts )
     bool b_cmd;
 
     vlc_mutex_lock( &p_ts->lock );
-    b_cmd = !TsStorageIsEmpty( p_ts->p_storage_r );
+    b_cmd = !TsStorageIsEmpty( p_ts->p_storage );
     vlc_mutex_unlock( &p_ts->lock );
 
     return b_cmd;
@@ -1105,7 +1130,7 @@ static bool TsIsUnused( ts_thread_t *p_ts )
     vlc_mutex_lock( &p_ts->lock );
     b_unused = !p_ts->b_paused &&
                p_ts->rate == p_ts->rate_source &&
-               TsStorageIsEmpty( p_ts->p_storage_r );
+               TsStorageIsEmpty( p_ts->p_storage );
     vlc_mutex_unlock( &p_ts->lock );
 
     return b_unused;
@@ -1160,6 +1185,30 @@ static int TsChangeRate( ts_thread_t *p_ts, float src_rate, float rate )
     return i_ret;
 }
 
+static int TsSeek( ts_thread_t *p_ts, vlc_tick_t i_time )
+{
+    int i_ret = VLC_EGENERIC;
+
+    vlc_mutex_lock( &p_ts->lock );
+    vlc_tick_t i_skipped;
+    if( p_ts->p_storage )
+        i_ret = TsStorageSeek( p_ts->p_storage, i_time, &i_skipped );
+    if( !i_ret )
+    {
+        msg_Dbg( p_ts->p_input, "timeshift seek, skipped %"PRId64" ms",
+                 MS_FROM_VLC_TICK(i_skipped) );
+
+        /* Play the keyframe as if it directly followed the last played
+         * command */
+        p_ts->i_cmd_delay -= i_skipped;
+        p_ts->b_reset_pcr = true;
+        vlc_cond_signal( &p_ts->wait );
+    }
+    vlc_mutex_unlock( &p_ts->lock );
+
+    return i_ret;
+}
+
 static void *TsRun( void *p_data )
 {
     vlc_thread_set_name("vlc-timeshift");
@@ -1228,6 +1277,9 @@ static void *TsRun( void *p_data )
         }
         i_deadline = cmd.header.i_date + p_ts->i_cmd_delay + p_ts->i_rate_delay + p_ts->i_buffering_delay;
 
+        const bool b_reset_pcr = p_ts->b_reset_pcr;
+        p_ts->b_reset_pcr = false;
+
         vlc_mutex_unlock( &p_ts->lock );
 
         /* Regulate the speed of command processing to the same one than
@@ -1238,6 +1290,10 @@ static void *TsRun( void *p_data )
             return NULL;
         }
 
+        /* Flush the data decoded before the seek */
+        if( b_reset_pcr )
+            es_out_Control( &p_ts->p_out->out, ES_OUT_RESET_PCR );
+
         /* Execute the command  */
         switch( cmd.header.i_type )
         {
@@ -1273,82 +1329,60 @@ static void *TsRun( void *p_data )
 /*****************************************************************************
  *
  *****************************************************************************/
-#define MAX_COMMAND_SIZE sizeof(ts_cmd_t)
-#define TS_STORAGE_COMMAND_PREALLOC 30000
+#define TS_STORAGE_COMMAND_PREALLOC 1024 /* power of 2 */
+#define TS_STORAGE_INDEX_PREALLOC 64 /* power of 2 */
 
-static const size_t TsStorageSizeofCommand[] =
-{
-    [C_ADD] = sizeof(ts_cmd_add_t),
-    [C_SEND] = sizeof(ts_cmd_send_t),
-    [C_DEL] = sizeof(ts_cmd_del_t),
-    [C_CONTROL] = sizeof(ts_cmd_control_t),
-    [C_PRIVCONTROL] = sizeof(ts_cmd_privcontrol_t)
-};
-
-static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_tmp_size_max )
+static ts_storage_t *TsStorageNew( const char *psz_tmp_path, int64_t i_size_max )
 {
     ts_storage_t *p_storage = malloc( sizeof (*p_storage) );
     if( unlikely(p_storage == NULL) )
         return NULL;
 
     char *psz_file;
-    int fd = GetTmpFile( &psz_file, psz_tmp_path );
-    if( fd == -1 )
+    p_storage->fd = GetTmpFile( &psz_file, psz_tmp_path );
+    if( p_storage->fd == -1 )
     {
         free( p_storage );
         return NULL;
     }
 
-    p_storage->p_filew = fdopen( fd, "w+b" );
-    if( p_storage->p_filew == NULL )
-    {
-        vlc_close( fd );
-        vlc_unlink( psz_file );
-        goto error;
-    }
-
-    p_storage->p_filer = vlc_fopen( psz_file, "rb" );
-    if( p_storage->p_filer == NULL )
-    {
-        fclose( p_storage->p_filew );
-        vlc_unlink( psz_file );
-        goto error;
-    }
-
 #ifndef _WIN32
     vlc_unlink( psz_file );
     free( psz_file );
 #else
     p_storage->psz_file = psz_file;
 #endif
-    p_storage->p_next = NULL;
 
     /* */
-    p_storage->i_file_max = i_tmp_size_max;
-    p_storage->i_file_size = 0;
+    p_storage->i_data_max = i_size_max;
+    p_storage->i_data_r = 0;
+    p_storage->i_data_w = 0;
 
     /* */
-    p_storage->p_cmd_buf = vlc_alloc( TS_STORAGE_COMMAND_PREALLOC, MAX_COMMAND_SIZE );
-    p_storage->i_cmd_buf = TS_STORAGE_COMMAND_PREALLOC * MAX_COMMAND_SIZE;
-    p_storage->p_cmd_w = p_storage->p_cmd_buf;
-    p_storage->p_cmd_r = p_storage->p_cmd_buf;
-    //fprintf( stderr, "\nSTORAGE name=%s size=%d KiB\n", p_storage->psz_file, p_storage->i_cmd_max * sizeof(*p_storage->p_cmd) /1024 );
+    p_storage->p_cmd = vlc_alloc( TS_STORAGE_COMMAND_PREALLOC, sizeof(*p_storage->p_cmd) );
+    p_storage->i_cmd_alloc = TS_STORAGE_COMMAND_PREALLOC;
+    p_storage->i_cmd_r = 0;
+    p_storage->i_cmd_w = 0;
+
+    p_storage->p_index = vlc_alloc( TS_STORAGE_INDEX_PREALLOC, sizeof(*p_storage->p_index) );
+    p_storage->i_index_alloc = TS_STORAGE_INDEX_PREALLOC;
+    p_storage->i_index_r = 0;
+    p_storage->i_index_w = 0;
+
+    p_storage->i_time_r = VLC_TICK_INVALID;
+    p_storage->i_time_w = VLC_TICK_INVALID;
 
-    if( !p_storage->p_cmd_buf )
+    if( !p_storage->p_cmd || !p_storage->p_index )
     {
         TsStorageDelete( p_storage );
         return NULL;
     }
     return p_storage;
-error:
-    free( psz_file );
-    free( p_storage );
-    return NULL;
 }
 
 static void TsStorageDelete( ts_storage_t *p_storage )
 {
-    while( p_storage->p_cmd_r < p_storage->p_cmd_w )
+    while( !TsStorageIsEmpty( p_storage ) )
     {
         ts_cmd_t cmd;
 
@@ -1356,10 +1390,10 @@ static void TsStorageDelete( ts_storage_t *p_storage )
 
         CmdClean( &cmd );
     }
-    free( p_storage->p_cmd_buf );
+    free( p_storage->p_cmd );
+    free( p_storage->p_index );
 
-    fclose( p_storage->p_filer );
-    fclose( p_storage->p_filew );
+    vlc_close( p_storage->fd );
 #ifdef _WIN32
     vlc_unlink( p_storage->psz_file );
     free( p_storage->psz_file );
@@ -1367,113 +1401,382 @@ static void TsStorageDelete( ts_storage_t *p_storage )
     free( p_storage );
 }
 
-static void TsStoragePack( ts_storage_t *p_storage )
+static bool TsStorageIsEmpty( ts_storage_t *p_storage )
 {
-    /* Try to release a bit of memory */
-    if( (size_t)(p_storage->p_cmd_w - p_storage->p_cmd_buf) == p_storage->i_cmd_buf )
-        return;
+    return !p_storage || p_storage->i_cmd_r >= p_storage->i_cmd_w;
+}
 
-    size_t i_realloc = p_storage->p_cmd_w - p_storage->p_cmd_buf;
-    uint8_t *p_realloc = realloc( p_storage->p_cmd_buf, i_realloc );
-    if( p_realloc )
-    {
-        p_storage->p_cmd_r = p_realloc + (p_storage->p_cmd_r - p_storage->p_cmd_buf);
-        p_storage->p_cmd_w = p_realloc + i_realloc;
-        p_storage->i_cmd_buf = i_realloc;
-        p_storage->p_cmd_buf = p_realloc;
-    }
+static ts_cmd_t *TsStorageCmdAt( ts_storage_t *p_storage, uint64_t i_cmd )
+{
+    return &p_storage->p_cmd[i_cmd & (p_storage->i_cmd_alloc - 1)];
 }
 
-static bool TsStorageIsFull( ts_storage_t *p_storage, const ts_cmd_t *p_cmd )
+static ts_index_t *TsStorageIndexAt( ts_storage_t *p_storage, uint64_t i_index )
 {
-    if( p_cmd && p_cmd->header.i_type == C_SEND && p_storage->p_cmd_w )
+    return &p_storage->p_index[i_index & (p_storage->i_index_alloc - 1)];
+}
+
+/* Doubles the size of a circular buffer, keeping the entries at the same
+ * sequence numbers */
+static void *TsStorageGrow( void *p_buf, size_t *pi_alloc, size_t i_entry,
+                            uint64_t i_first, uint64_t i_last )
+{
+    const size_t i_alloc = *pi_alloc;
+    uint8_t *p_new = vlc_alloc( 2 * i_alloc, i_entry );
+    if( !p_new )
+        return NULL;
+
+    for( uint64_t i = i_first; i < i_last; i++ )
+        memcpy( &p_new[(i & (2 * i_alloc - 1)) * i_entry],
+                &((uint8_t *)p_buf)[(i & (i_alloc - 1)) * i_entry], i_entry );
+
+    free( p_buf );
+    *pi_alloc = 2 * i_alloc;
+    return p_new;
+}
+
+static int TsStorageWrite( ts_storage_t *p_storage, uint64_t i_offset,
+                           const void *p_data, size_t i_size )
+{
+    const uint8_t *p = p_data;
+
+    while( i_size > 0 )
     {
-        size_t i_size = sizeof(*p_cmd->send.p_block) + p_cmd->send.p_block->i_buffer;
+        const uint64_t i_pos = i_offset % p_storage->i_data_max;
+        const size_t i_chunk = __MIN( i_size, p_storage->i_data_max - i_pos );
 
-        if( p_storage->i_file_size + i_size >= p_storage->i_file_max )
-            return true;
+        if( lseek( p_storage->fd, i_pos, SEEK_SET ) == (off_t)-1
+         || vlc_write( p_storage->fd, p, i_chunk ) != (ssize_t)i_chunk )
+            return VLC_EGENERIC;
+
+        p += i_chunk;
+        i_offset += i_chunk;
+        i_size -= i_chunk;
     }
-    return (size_t)(p_storage->p_cmd_w - p_storage->p_cmd_buf) > p_storage->i_cmd_buf - MAX_COMMAND_SIZE;
+    return VLC_SUCCESS;
 }
 
-static bool TsStorageIsEmpty( ts_storage_t *p_storage )
+static int TsStorageRead( ts_storage_t *p_storage, uint64_t i_offset,
+                          void *p_data, size_t i_size )
 {
-    return !p_storage || p_storage->p_cmd_r >= p_storage->p_cmd_w;
+    uint8_t *p = p_data;
+
+    while( i_size > 0 )
+    {
+        const uint64_t i_pos = i_offset % p_storage->i_data_max;
+        const size_t i_chunk = __MIN( i_size, p_storage->i_data_max - i_pos );
+
+        if( lseek( p_storage->fd, i_pos, SEEK_SET ) == (off_t)-1
+         || read( p_storage->fd, p, i_chunk ) != (ssize_t)i_chunk )
+            return VLC_EGENERIC;
+
+        p += i_chunk;
+        i_offset += i_chunk;
+        i_size -= i_chunk;
+    }
+    return VLC_SUCCESS;
 }
 
-static void TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd, bool b_flush )
+/* Returns the first keyframe whose data starts at or after i_offset */
+static uint64_t TsStorageIndexFind( ts_storage_t *p_storage, uint64_t i_offset )
 {
-    assert( !TsStorageIsFull( p_storage, p_cmd ) );
-    ts_cmd_t cmd;
-    memcpy(&cmd, p_cmd, TsStorageSizeofCommand[p_cmd->header.i_type]);
+    uint64_t i_low = p_storage->i_index_r;
+    uint64_t i_high = p_storage->i_index_w;
 
-    if( cmd.header.i_type == C_SEND )
+    while( i_low < i_high )
     {
-        block_t *p_block = cmd.send.p_block;
+        const uint64_t i_mid = i_low + (i_high - i_low) / 2;
 
-        cmd.send.p_block = NULL;
-        cmd.send.i_offset = ftell( p_storage->p_filew );
+        if( TsStorageIndexAt( p_storage, i_mid )->i_offset < i_offset )
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    return i_low;
+}
 
-        if( fwrite( p_block, sizeof(*p_block), 1, p_storage->p_filew ) != 1 )
+/* Commands of the skipped data that are superseded by a later command of the
+ * same kind, when scanning backward */
+typedef struct
+{
+    bool   b_pcr;
+    bool   b_times;
+    bool   b_jitter;
+    bool   b_epg_time;
+    size_t i_group_pcr;
+    int    pi_group_pcr[8];
+} ts_skip_t;
+
+static bool TsSkipIsSuperseded( ts_skip_t *p_skip, const ts_cmd_t *p_cmd )
+{
+    bool *pb_seen;
+
+    if( p_cmd->header.i_type == C_CONTROL )
+    {
+        switch( p_cmd->control.i_query )
         {
-            block_Release( p_block );
-            return;
+        case ES_OUT_SET_PCR:
+            pb_seen = &p_skip->b_pcr;
+            break;
+        case ES_OUT_SET_EPG_TIME:
+            pb_seen = &p_skip->b_epg_time;
+            break;
+        case ES_OUT_SET_GROUP_PCR:
+        {
+            const int i_group = p_cmd->control.u.int_i64.i_int;
+            for( size_t i = 0; i < p_skip->i_group_pcr; i++ )
+                if( p_skip->pi_group_pcr[i] == i_group )
+                    return true;
+            if( p_skip->i_group_pcr < ARRAY_SIZE(p_skip->pi_group_pcr) )
+                p_skip->pi_group_pcr[p_skip->i_group_pcr++] = i_group;
+            return false;
+        }
+        default:
+            return false;
         }
-        p_storage->i_file_size += sizeof(*p_block);
-        if( p_block->i_buffer > 0 )
+    }
+    else if( p_cmd->header.i_type == C_PRIVCONTROL )
+    {
+        switch( p_cmd->privcontrol.i_query )
         {
-            if( fwrite( p_block->p_buffer, p_block->i_buffer, 1, p_storage->p_filew ) != 1 )
-            {
-                block_Release( p_block );
-                return;
-            }
+        case ES_OUT_PRIV_SET_TIMES:
+            pb_seen = &p_skip->b_times;
+            break;
+        case ES_OUT_PRIV_SET_JITTER:
+            pb_seen = &p_skip->b_jitter;
+            break;
+        default:
+            return false;
         }
-        p_storage->i_file_size += p_block->i_buffer;
+    }
+    else
+        return false;
+
+    const bool b_superseded = *pb_seen;
+    *pb_seen = true;
+    return b_superseded;
+}
+
+/* Drops the block data of the commands before i_cmd. The other commands are
+ * kept as they change the state of the ES output, except the clock and times
+ * updates superseded by later ones, so that they do not pile up. Returns the
+ * date of the first dropped block, if any. */
+static vlc_tick_t TsStorageSkip( ts_storage_t *p_storage, uint64_t i_cmd,
+                                 uint64_t i_data )
+{
+    vlc_tick_t i_first = VLC_TICK_INVALID;
+    ts_skip_t skip = { .i_group_pcr = 0 };
+    uint64_t i_kept = i_cmd;
+
+    /* Keep the remaining commands in order, just before i_cmd */
+    for( uint64_t i = i_cmd; i-- > p_storage->i_cmd_r; )
+    {
+        ts_cmd_t *p_cmd = TsStorageCmdAt( p_storage, i );
+
+        if( p_cmd->header.i_type == C_SEND )
+            i_first = p_cmd->header.i_date; /* its data is dropped */
+        else if( TsSkipIsSuperseded( &skip, p_cmd ) )
+            CmdClean( p_cmd );
+        else if( --i_kept != i )
+            *TsStorageCmdAt( p_storage, i_kept ) = *p_cmd;
+    }
+    p_storage->i_cmd_r = i_kept;
+
+    while( p_storage->i_index_r < p_storage->i_index_w
+        && TsStorageIndexAt( p_storage, p_storage->i_index_r )->i_cmd < i_cmd )
+        p_storage->i_index_r++;
+
+    p_storage->i_data_r = i_data;
+    return i_first;
+}
+
+/* Makes room for i_size bytes of block data by dropping the oldest data up to
+ * the next keyframe. Returns the duration that was dropped. */
+static vlc_tick_t TsStorageEvict( ts_storage_t *p_storage, size_t i_size,
+                                  vlc_tick_t i_date )
+{
+    const uint64_t i_min = p_storage->i_data_w + i_size - p_storage->i_data_max;
+    if( p_storage->i_data_w + i_size <= p_storage->i_data_max
+     || p_storage->i_data_r >= i_min )
+        return 0;
+
+    /* Find the first command that is still playable after the eviction */
+    uint64_t i_cmd = p_storage->i_cmd_w;
+    uint64_t i_data = p_storage->i_data_w;
+
+    const uint64_t i_index = TsStorageIndexFind( p_storage, i_min );
+    if( i_index < p_storage->i_index_w )
+    {
+        const ts_index_t *p_index = TsStorageIndexAt( p_storage, i_index );
+        i_cmd = p_index->i_cmd;
+        i_data = p_index->i_offset;
+        i_date = p_index->i_date;
+    }
+
+    const vlc_tick_t i_first = TsStorageSkip( p_storage, i_cmd, i_data );
+
+    if( i_first == VLC_TICK_INVALID || i_date <= i_first )
+        return 0;
+    return i_date - i_first;
+}
+
+/* Drops the unread data up to the first keyframe at or after i_time, in
+ * O(log n). Returns the duration that was skipped. */
+static int TsStorageSeek( ts_storage_t *p_storage, vlc_tick_t i_time,
+                          vlc_tick_t *pi_skipped )
+{
+    /* The data before the read position is already dropped */
+    if( i_time == VLC_TICK_INVALID || i_time < p_storage->i_time_r )
+        return VLC_EGENERIC;
+
+    uint64_t i_low = p_storage->i_index_r;
+    uint64_t i_high = p_storage->i_index_w;
+
+    while( i_low < i_high )
+    {
+        const uint64_t i_mid = i_low + (i_high - i_low) / 2;
+
+        if( TsStorageIndexAt( p_storage, i_mid )->i_time < i_time )
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    if( i_low == p_storage->i_index_w )
+        return VLC_EGENERIC; /* not buffered yet */
+
+    const ts_index_t index = *TsStorageIndexAt( p_storage, i_low );
+    const vlc_tick_t i_first = TsStorageSkip( p_storage, index.i_cmd,
+                                              index.i_offset );
+
+    *pi_skipped = i_first != VLC_TICK_INVALID && index.i_date > i_first
+                ? index.i_date - i_first : 0;
+    p_storage->i_time_r = index.i_time;
+    return VLC_SUCCESS;
+}
+
+static int TsStoragePushCmd( ts_storage_t *p_storage, const ts_cmd_t *p_cmd,
+                             vlc_tick_t *pi_evicted )
+{
+    ts_cmd_t cmd = *p_cmd;
+
+    *pi_evicted = 0;
+
+    if( p_storage->i_cmd_w - p_storage->i_cmd_r == p_storage->i_cmd_alloc )
+    {
+        ts_cmd_t *p_realloc = TsStorageGrow( p_storage->p_cmd,
+                                             &p_storage->i_cmd_alloc,
+                                             sizeof(*p_storage->p_cmd),
+                                             p_storage->i_cmd_r,
+                                             p_storage->i_cmd_w );
+        if( !p_realloc )
+            goto error;
+        p_storage->p_cmd = p_realloc;
+    }
+
+    if( cmd.header.i_type == C_SEND )
+    {
+        block_t *p_block = cmd.send.p_block;
+        const ts_block_header_t hdr = {
+            .i_buffer = p_block->i_buffer,
+            .i_flags = p_block->i_flags,
+            .i_nb_samples = p_block->i_nb_samples,
+            .i_pts = p_block->i_pts,
+            .i_dts = p_block->i_dts,
+            .i_length = p_block->i_length,
+        };
+        const size_t i_size = sizeof(hdr) + p_block->i_buffer;
+
+        if( i_size > p_storage->i_data_max )
+            goto error;
+
+        *pi_evicted = TsStorageEvict( p_storage, i_size, cmd.header.i_date );
+
+        const bool b_keyframe = p_block->i_flags & BLOCK_FLAG_TYPE_I;
+        if( b_keyframe
+         && p_storage->i_index_w - p_storage->i_index_r == p_storage->i_index_alloc )
+        {
+            ts_index_t *p_realloc = TsStorageGrow( p_storage->p_index,
+                                                   &p_storage->i_index_alloc,
+                                                   sizeof(*p_storage->p_index),
+                                                   p_storage->i_index_r,
+                                                   p_storage->i_index_w );
+            if( !p_realloc )
+                goto error;
+            p_storage->p_index = p_realloc;
+        }
+
+        if( TsStorageWrite( p_storage, p_storage->i_data_w, &hdr, sizeof(hdr) )
+         || TsStorageWrite( p_storage, p_storage->i_data_w + sizeof(hdr),
+                            p_block->p_buffer, p_block->i_buffer ) )
+            goto error;
         block_Release( p_block );
 
-        if( b_flush )
-            fflush( p_storage->p_filew );
+        cmd.send.i_offset = p_storage->i_data_w;
+        p_storage->i_data_w += i_size;
+
+        if( b_keyframe )
+        {
+            ts_index_t *p_index = TsStorageIndexAt( p_storage, p_storage->i_index_w++ );
+            p_index->i_cmd = p_storage->i_cmd_w;
+            p_index->i_offset = cmd.send.i_offset;
+            p_index->i_date = cmd.header.i_date;
+            p_index->i_time = p_storage->i_time_w;
+        }
     }
-    size_t i_cmdsize = TsStorageSizeofCommand[ cmd.header.i_type ];
-    memcpy( p_storage->p_cmd_w, &cmd, i_cmdsize );
-    p_storage->p_cmd_w += i_cmdsize;
+    else if( cmd.header.i_type == C_PRIVCONTROL
+          && cmd.privcontrol.i_query == ES_OUT_PRIV_SET_TIMES )
+        p_storage->i_time_w = cmd.privcontrol.u.times.i_time;
+
+    *TsStorageCmdAt( p_storage, p_storage->i_cmd_w++ ) = cmd;
+    return VLC_SUCCESS;
+
+error:
+    CmdClean( &cmd );
+    return VLC_EGENERIC;
 }
 
 static void TsStoragePopCmd( ts_storage_t *p_storage, ts_cmd_t *p_cmd, bool b_flush )
 {
     assert( !TsStorageIsEmpty( p_storage ) );
 
-    p_cmd->header.i_type = p_storage->p_cmd_r[0];
-    size_t i_cmdsize = TsStorageSizeofCommand[ p_cmd->header.i_type ];
-    memcpy(p_cmd, p_storage->p_cmd_r, i_cmdsize);
-    p_storage->p_cmd_r += i_cmdsize;
+    *p_cmd = *TsStorageCmdAt( p_storage, p_storage->i_cmd_r++ );
 
     if( p_cmd->header.i_type == C_SEND )
     {
-        block_t block;
+        const uint64_t i_offset = p_cmd->send.i_offset;
+        ts_block_header_t hdr;
+        block_t *p_block = NULL;
 
-        if( !b_flush &&
-            !fseek( p_storage->p_filer, p_cmd->send.i_offset, SEEK_SET ) &&
-            fread( &block, sizeof(block), 1, p_storage->p_filer ) == 1 )
+        if( !TsStorageRead( p_storage, i_offset, &hdr, sizeof(hdr) ) )
         {
-            block_t *p_block = block_Alloc( block.i_buffer );
-            if( p_block )
+            if( !b_flush )
             {
-                p_block->i_dts      = block.i_dts;
-                p_block->i_pts      = block.i_pts;
-                p_block->i_flags    = block.i_flags;
-                p_block->i_length   = block.i_length;
-                p_block->i_nb_samples = block.i_nb_samples;
-                p_block->i_buffer = fread( p_block->p_buffer, 1, block.i_buffer, p_storage->p_filer );
+                p_block = block_Alloc( hdr.i_buffer );
+                if( p_block )
+                {
+                    p_block->i_dts      = hdr.i_dts;
+                    p_block->i_pts      = hdr.i_pts;
+                    p_block->i_flags    = hdr.i_flags;
+                    p_block->i_length   = hdr.i_length;
+                    p_block->i_nb_samples = hdr.i_nb_samples;
+                    if( TsStorageRead( p_storage, i_offset + sizeof(hdr),
+                                       p_block->p_buffer, hdr.i_buffer ) )
+                    {
+                        block_Release( p_block );
+                        p_block = NULL;
+                    }
+                }
             }
-            p_cmd->send.p_block = p_block;
-        }
-        else
-        {
-            //perror( "TsStoragePopCmd" );
-            p_cmd->send.p_block = block_Alloc( 1 );
+            p_storage->i_data_r = i_offset + sizeof(hdr) + hdr.i_buffer;
         }
+        p_cmd->send.p_block = p_block;
     }
+    else if( p_cmd->header.i_type == C_PRIVCONTROL
+          && p_cmd->privcontrol.i_query == ES_OUT_PRIV_SET_TIMES )
+        p_storage->i_time_r = p_cmd->privcontrol.u.times.i_time;
+
+    /* Forget about the read keyframes */
+    TsStorageSkip( p_storage, p_storage->i_cmd_r, p_storage->i_data_r );
 }
 
 /*****************************************************************************
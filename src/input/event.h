@@ -264,6 +264,15 @@ static inline bool input_SendEventParsing(input_thread_t *p_input,
     });
 }
 
+static inline bool input_SendEventPartialParsing(input_thread_t *p_input,
+                                                 input_item_node_t *p_root)
+{
+    return input_SendEvent(p_input, &(struct vlc_input_event) {
+        .type = INPUT_EVENT_PARTIAL_SUBITEMS,
+        .subitems = p_root,
+    });
+}
+
 static inline void input_SendEventVbiPage(input_thread_t *p_input, unsigned page)
 {
     input_SendEvent(p_input, &(struct vlc_input_event) {
@@ -268,6 +268,8 @@ input_thread_t * input_Create( vlc_object_t *p_parent, input_item_t *p_item,
     priv->cbs_data = cfg->cbs_data;
     priv->type = cfg->type;
     priv->preparse_subitems = cfg->preparsing.subitems;
+    priv->thumbnail_keyframe_only = cfg->type == INPUT_TYPE_THUMBNAILING
+                                 && cfg->thumbnailing.keyframe_only;
     priv->i_start = 0;
     priv->i_stop  = 0;
     priv->i_title_offset = input_priv(p_input)->i_seekpoint_offset = 0;
@@ -276,6 +278,7 @@ input_thread_t * input_Create( vlc_object_t *p_parent, input_item_t *p_item,
     priv->is_stopped = false;
     priv->b_recording = false;
     priv->rate = 1.f;
+    atomic_init( &priv->scrubbing, false );
     TAB_INIT( priv->i_attachment, priv->attachment );
     priv->p_sout   = NULL;
     priv->b_out_pace_control = priv->type == INPUT_TYPE_THUMBNAILING;
@@ -725,9 +728,12 @@ static void MainLoop( input_thread_t *p_input, bool b_interactive )
             vlc_tick_t i_deadline = i_wakeup;
 
             /* Postpone seeking until ES buffering is complete or at most
-             * 125 ms. */
+             * 125 ms. While scrubbing, a new seek supersedes the one being
+             * buffered. */
             bool b_postpone = es_out_GetBuffering( input_priv(p_input)->p_es_out )
-                            && !input_priv(p_input)->master->b_eof;
+                            && !input_priv(p_input)->master->b_eof
+                            && !atomic_load_explicit( &input_priv(p_input)->scrubbing,
+                                                      memory_order_relaxed );
             if( b_postpone )
             {
                 vlc_tick_t now = vlc_tick_now();
@@ -1503,6 +1509,26 @@ static size_t ControlGetReducedIndexLocked( input_thread_t *p_input,
     if( sys->i_control == 0 )
         return 0;
 
+    if( ( c->i_type == INPUT_CONTROL_SET_TIME ||
+          c->i_type == INPUT_CONTROL_SET_POSITION ) &&
+        atomic_load_explicit( &sys->scrubbing, memory_order_relaxed ) )
+    {
+        /* While scrubbing, only the latest seek request matters: drop the
+         * pending ones, wherever they are in the queue. */
+        size_t i_kept = 0;
+        for( size_t i = 0; i < sys->i_control; ++i )
+        {
+            input_control_t *pending = &sys->control[i];
+            if( pending->i_type == INPUT_CONTROL_SET_TIME ||
+                pending->i_type == INPUT_CONTROL_SET_POSITION )
+                ControlRelease( pending->i_type, &pending->param );
+            else
+                sys->control[i_kept++] = *pending;
+        }
+        sys->i_control = i_kept;
+        return i_kept;
+    }
+
     input_control_t *prev_control = &sys->control[sys->i_control - 1];
     const int i_lt = prev_control->i_type;
     const int i_ct = c->i_type;
@@ -1652,6 +1678,7 @@ static bool ControlTypeIsEarly(int type)
         /* \warning Make sure the control implementation is not referencing the
          * demux before adding it here. */
         case INPUT_CONTROL_SET_PROGRAM:
+        case INPUT_CONTROL_SET_SCRUBBING:
         case INPUT_CONTROL_SET_CATEGORY_DELAY:
         case INPUT_CONTROL_SET_ES_CAT_IDS:
             return true;
@@ -1879,6 +1906,14 @@ void input_SetEsCatIds(input_thread_t *input, enum es_format_category_e cat,
     input_ControlPush(input, INPUT_CONTROL_SET_ES_CAT_IDS, &param);
 }
 
+void input_SetScrubbing(input_thread_t *input, bool scrubbing)
+{
+    atomic_store_explicit(&input_priv(input)->scrubbing, scrubbing,
+                          memory_order_relaxed);
+    input_ControlPushHelper(input, INPUT_CONTROL_SET_SCRUBBING,
+                            &(vlc_value_t) { .b_bool = scrubbing });
+}
+
 static void ControlSetEsList(input_thread_t *input,
                              enum es_format_category_e cat,
                              vlc_es_id_t **ids)
@@ -1996,6 +2031,20 @@ static bool Control( input_thread_t *p_input,
                 break;
             }
 
+            /* Seek within the timeshift buffer if the stream cannot seek */
+            bool b_can_seek;
+            if( demux_Control( priv->master->p_demux, DEMUX_CAN_SEEK,
+                               &b_can_seek ) )
+                b_can_seek = false;
+            if( !b_can_seek
+             && es_out_SetTimeshiftTime( priv->p_es_out,
+                                         priv->i_start + param.time.i_val )
+                    == VLC_SUCCESS )
+            {
+                b_force_update = true;
+                break;
+            }
+
             /* Reset the decoders states and clock sync (before calling the demuxer */
             es_out_Control(&priv->p_es_out->out, ES_OUT_RESET_PCR);
 
@@ -2122,6 +2171,10 @@ static bool Control( input_thread_t *p_input,
             break;
         }
 
+        case INPUT_CONTROL_SET_SCRUBBING:
+            es_out_SetScrubbing( priv->p_es_out_display, param.val.b_bool );
+            break;
+
         case INPUT_CONTROL_SET_PROGRAM:
             /* No need to force update, es_out does it if needed */
             es_out_Control(&priv->p_es_out->out,
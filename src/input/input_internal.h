@@ -133,6 +133,7 @@ typedef enum input_event_type_e
 
     /* (pre-)parsing events */
     INPUT_EVENT_SUBITEMS,
+    INPUT_EVENT_PARTIAL_SUBITEMS,
 
     /* vbi_page has changed */
     INPUT_EVENT_VBI_PAGE,
@@ -315,7 +316,7 @@ struct vlc_input_event
         float cache;
         /* INPUT_EVENT_VOUT */
         struct vlc_input_event_vout vout;
-        /* INPUT_EVENT_SUBITEMS */
+        /* INPUT_EVENT_SUBITEMS, INPUT_EVENT_PARTIAL_SUBITEMS */
         input_item_node_t *subitems;
         /* INPUT_EVENT_VBI_PAGE */
         unsigned vbi_page;
@@ -355,6 +356,10 @@ struct vlc_input_thread_cfg
     struct {
         bool subitems;
     } preparsing;
+    struct {
+        /** Decode only reference frames, and nothing past the thumbnail */
+        bool keyframe_only;
+    } thumbnailing;
     bool interact;
 };
 /**
@@ -465,6 +470,7 @@ typedef struct input_thread_private_t
     enum input_type type;
     bool hw_dec;
     bool preparse_subitems;
+    bool thumbnail_keyframe_only;
 
     /* Current state */
     int         i_state;
@@ -472,6 +478,7 @@ typedef struct input_thread_private_t
     bool        is_stopped;
     bool        b_recording;
     float       rate;
+    atomic_bool scrubbing;
 
     /* Playtime configuration and state */
     vlc_tick_t  i_start;    /* :start-time,0 by default */
@@ -540,6 +547,8 @@ enum input_control_e
 
     INPUT_CONTROL_SET_RATE,
 
+    INPUT_CONTROL_SET_SCRUBBING,
+
     INPUT_CONTROL_SET_POSITION,
 
     INPUT_CONTROL_SET_TIME,
@@ -659,6 +668,16 @@ int input_SetEsCatDelay(input_thread_t *input, enum es_format_category_e cat,
 void input_SetEsCatIds(input_thread_t *, enum es_format_category_e cat,
                        const char *str_ids);
 
+/**
+ * Set the scrubbing state
+ *
+ * While scrubbing, decoders favour speed over quality, audio is not decoded
+ * and a new seek request replaces the pending ones instead of waiting for
+ * the previous seek to complete.
+ * This function can be called before start or while started.
+ */
+void input_SetScrubbing(input_thread_t *, bool scrubbing);
+
 bool input_Stopped( input_thread_t * );
 
 int input_GetAttachments(input_thread_t *input, input_attachment_t ***attachments);
@@ -48,6 +48,23 @@ struct input_item_opaque
 
 static enum input_item_type_e GuessType( const input_item_t *p_item, bool *p_net );
 
+/* Invalidate the snapshot after a change of the name, URI or duration.
+ * Meta changes are tracked by the meta revision. */
+static void input_item_Modified( input_item_t *item )
+{
+    vlc_mutex_assert( &item->lock );
+    atomic_fetch_add_explicit( &item_owner(item)->revision, 1,
+                               memory_order_relaxed );
+}
+
+unsigned input_item_GetRevision( input_item_t *item )
+{
+    /* both counters only grow: their sum changes whenever any of them does */
+    return atomic_load_explicit( &item_owner(item)->revision,
+                                 memory_order_relaxed )
+         + vlc_meta_GetRevision( item->p_meta );
+}
+
 void input_item_SetPreparsed( input_item_t *p_i )
 {
     vlc_mutex_lock( &p_i->lock );
@@ -202,6 +219,16 @@ const char *input_item_GetMetaLocked(input_item_t *item,
 
 char *input_item_GetMeta( input_item_t *p_i, vlc_meta_type_t meta_type )
 {
+    const struct input_item_meta_snapshot *snap =
+        input_item_AcquireMetaSnapshot( p_i );
+    if( likely(snap != NULL) )
+    {
+        const char *value = snap->meta[meta_type];
+        char *psz = value ? strdup( value ) : NULL;
+        input_item_ReleaseMetaSnapshot( p_i, snap );
+        return psz;
+    }
+
     vlc_mutex_lock( &p_i->lock );
     const char *value = input_item_GetMetaLocked( p_i, meta_type );
     char *psz = value ? strdup( value ) : NULL;
@@ -237,6 +264,19 @@ unsigned input_item_GetMetaExtraNames( input_item_t *p_i, char ***pppsz_names )
 char *input_item_GetTitleFbName( input_item_t *p_item )
 {
     char *psz_ret;
+    const struct input_item_meta_snapshot *snap =
+        input_item_AcquireMetaSnapshot( p_item );
+    if( likely(snap != NULL) )
+    {
+        const char *psz_title = snap->meta[vlc_meta_Title];
+        if( !EMPTY_STR( psz_title ) )
+            psz_ret = strdup( psz_title );
+        else
+            psz_ret = snap->name ? strdup( snap->name ) : NULL;
+        input_item_ReleaseMetaSnapshot( p_item, snap );
+        return psz_ret;
+    }
+
     vlc_mutex_lock( &p_item->lock );
 
     const char *psz_title = vlc_meta_Get( p_item->p_meta, vlc_meta_Title );
@@ -251,6 +291,15 @@ char *input_item_GetTitleFbName( input_item_t *p_item )
 
 char *input_item_GetName( input_item_t *p_item )
 {
+    const struct input_item_meta_snapshot *snap =
+        input_item_AcquireMetaSnapshot( p_item );
+    if( likely(snap != NULL) )
+    {
+        char *psz_name = snap->name ? strdup( snap->name ) : NULL;
+        input_item_ReleaseMetaSnapshot( p_item, snap );
+        return psz_name;
+    }
+
     vlc_mutex_lock( &p_item->lock );
 
     char *psz_name = p_item->psz_name ? strdup( p_item->psz_name ) : NULL;
@@ -264,12 +313,22 @@ void input_item_SetName( input_item_t *p_item, const char *psz_name )
 
     free( p_item->psz_name );
     p_item->psz_name = strdup( psz_name );
+    input_item_Modified( p_item );
 
     vlc_mutex_unlock( &p_item->lock );
 }
 
 char *input_item_GetURI( input_item_t *p_i )
 {
+    const struct input_item_meta_snapshot *snap =
+        input_item_AcquireMetaSnapshot( p_i );
+    if( likely(snap != NULL) )
+    {
+        char *psz_s = snap->uri ? strdup( snap->uri ) : NULL;
+        input_item_ReleaseMetaSnapshot( p_i, snap );
+        return psz_s;
+    }
+
     vlc_mutex_lock( &p_i->lock );
 
     char *psz_s = p_i->psz_uri ? strdup( p_i->psz_uri ) : NULL;
@@ -343,16 +402,27 @@ void input_item_SetURI( input_item_t *p_i, const char *psz_uri )
             p_i->psz_name=NULL; /* recover from undefined value */
     }
 
+    input_item_Modified( p_i );
     vlc_mutex_unlock( &p_i->lock );
 }
 
 vlc_tick_t input_item_GetDuration( input_item_t *p_i )
 {
-    vlc_mutex_lock( &p_i->lock );
-
-    vlc_tick_t i_duration = p_i->i_duration;
+    vlc_tick_t i_duration;
+    const struct input_item_meta_snapshot *snap =
+        input_item_AcquireMetaSnapshot( p_i );
+    if( likely(snap != NULL) )
+    {
+        i_duration = snap->duration;
+        input_item_ReleaseMetaSnapshot( p_i, snap );
+    }
+    else
+    {
+        vlc_mutex_lock( &p_i->lock );
+        i_duration = p_i->i_duration;
+        vlc_mutex_unlock( &p_i->lock );
+    }
 
-    vlc_mutex_unlock( &p_i->lock );
     if (i_duration == INPUT_DURATION_INDEFINITE)
         i_duration = 0;
     else if (i_duration == INPUT_DURATION_UNSET)
@@ -364,7 +434,10 @@ void input_item_SetDuration( input_item_t *p_i, vlc_tick_t i_duration )
 {
     vlc_mutex_lock( &p_i->lock );
     if( p_i->i_duration != i_duration )
+    {
         p_i->i_duration = i_duration;
+        input_item_Modified( p_i );
+    }
     vlc_mutex_unlock( &p_i->lock );
 }
 
@@ -398,6 +471,173 @@ bool input_item_IsArtFetched( input_item_t *p_item )
     return b_fetched;
 }
 
+struct input_item_snapshot
+{
+    struct input_item_meta_snapshot pub;
+    unsigned revision;
+    unsigned meta_revision;
+    atomic_uint refs;
+    struct input_item_snapshot *next; /* next retired snapshot */
+    char strings[];
+};
+
+static struct input_item_snapshot *input_item_snapshot_New( input_item_t *item )
+{
+    vlc_mutex_assert( &item->lock );
+
+    const char *meta[VLC_META_TYPE_COUNT];
+    size_t size = 0;
+
+    if( item->psz_name )
+        size += strlen( item->psz_name ) + 1;
+    if( item->psz_uri )
+        size += strlen( item->psz_uri ) + 1;
+    for( int i = 0; i < VLC_META_TYPE_COUNT; i++ )
+    {
+        meta[i] = vlc_meta_Get( item->p_meta, i );
+        if( meta[i] )
+            size += strlen( meta[i] ) + 1;
+    }
+
+    struct input_item_snapshot *snap = malloc( sizeof(*snap) + size );
+    if( unlikely(snap == NULL) )
+        return NULL;
+
+    snap->revision = atomic_load_explicit( &item_owner(item)->revision,
+                                           memory_order_relaxed );
+    snap->meta_revision = vlc_meta_GetRevision( item->p_meta );
+    atomic_init( &snap->refs, 0 );
+    snap->next = NULL;
+
+    char *p = snap->strings;
+#define SNAPSHOT_COPY(dst, src) \
+    do { \
+        if( src ) \
+        { \
+            size_t len = strlen( src ) + 1; \
+            memcpy( p, src, len ); \
+            dst = p; \
+            p += len; \
+        } \
+        else \
+            dst = NULL; \
+    } while( 0 )
+
+    SNAPSHOT_COPY( snap->pub.name, item->psz_name );
+    SNAPSHOT_COPY( snap->pub.uri, item->psz_uri );
+    for( int i = 0; i < VLC_META_TYPE_COUNT; i++ )
+        SNAPSHOT_COPY( snap->pub.meta[i], meta[i] );
+#undef SNAPSHOT_COPY
+    snap->pub.duration = item->i_duration;
+
+    return snap;
+}
+
+static bool input_item_snapshot_IsCurrent( input_item_t *item,
+                                           const struct input_item_snapshot *snap )
+{
+    return snap->revision == atomic_load_explicit( &item_owner(item)->revision,
+                                                   memory_order_relaxed )
+        && snap->meta_revision == vlc_meta_GetRevision( item->p_meta );
+}
+
+static void input_item_snapshot_DeleteList( struct input_item_snapshot *snap )
+{
+    while( snap != NULL )
+    {
+        struct input_item_snapshot *next = snap->next;
+        free( snap );
+        snap = next;
+    }
+}
+
+/* Free the replaced snapshots that are no longer referenced. Readers count
+ * themselves while they take a reference: those coming after the check can
+ * only reference the current snapshot. */
+static void input_item_snapshot_Reclaim( input_item_t *item )
+{
+    input_item_owner_t *owner = item_owner(item);
+
+    vlc_mutex_assert( &item->lock );
+    if( atomic_load( &owner->readers ) != 0 )
+        return;
+
+    struct input_item_snapshot **pp = &owner->retired;
+    while( *pp != NULL )
+    {
+        struct input_item_snapshot *snap = *pp;
+
+        if( atomic_load( &snap->refs ) == 0 )
+        {
+            *pp = snap->next;
+            free( snap );
+        }
+        else
+            pp = &snap->next;
+    }
+}
+
+const struct input_item_meta_snapshot *
+input_item_AcquireMetaSnapshot( input_item_t *item )
+{
+    input_item_owner_t *owner = item_owner(item);
+
+    atomic_fetch_add( &owner->readers, 1 );
+
+    struct input_item_snapshot *snap = atomic_load( &owner->snapshot );
+    if( likely(snap != NULL) && input_item_snapshot_IsCurrent( item, snap ) )
+    {
+        atomic_fetch_add( &snap->refs, 1 );
+        atomic_fetch_sub( &owner->readers, 1 );
+        return &snap->pub;
+    }
+    atomic_fetch_sub( &owner->readers, 1 );
+
+    /* The item changed since the last snapshot: publish a new one. The old
+     * one may still be referenced, so it is only retired. */
+    vlc_mutex_lock( &item->lock );
+    snap = atomic_load_explicit( &owner->snapshot, memory_order_relaxed );
+    if( snap == NULL || !input_item_snapshot_IsCurrent( item, snap ) )
+    {
+        struct input_item_snapshot *fresh = input_item_snapshot_New( item );
+        if( unlikely(fresh == NULL) )
+        {
+            vlc_mutex_unlock( &item->lock );
+            return NULL;
+        }
+
+        atomic_store( &owner->snapshot, fresh );
+        if( snap != NULL )
+        {
+            snap->next = owner->retired;
+            owner->retired = snap;
+            input_item_snapshot_Reclaim( item );
+        }
+        snap = fresh;
+    }
+    atomic_fetch_add( &snap->refs, 1 );
+    vlc_mutex_unlock( &item->lock );
+
+    return &snap->pub;
+}
+
+void input_item_ReleaseMetaSnapshot( input_item_t *item,
+                                     const struct input_item_meta_snapshot *pub )
+{
+    input_item_owner_t *owner = item_owner(item);
+    struct input_item_snapshot *snap =
+        container_of( pub, struct input_item_snapshot, pub );
+
+    if( atomic_fetch_sub( &snap->refs, 1 ) != 1
+     || atomic_load( &owner->snapshot ) == snap )
+        return;
+
+    /* Last reference to a replaced snapshot */
+    vlc_mutex_lock( &item->lock );
+    input_item_snapshot_Reclaim( item );
+    vlc_mutex_unlock( &item->lock );
+}
+
 input_item_t *input_item_Hold( input_item_t *p_item )
 {
     input_item_owner_t *owner = item_owner(p_item);
@@ -413,6 +653,11 @@ void input_item_Release( input_item_t *p_item )
     if( !vlc_atomic_rc_dec( &owner->rc ) )
         return;
 
+    /* no readers are left without a reference to the item */
+    input_item_snapshot_DeleteList( atomic_load_explicit( &owner->snapshot,
+                                                          memory_order_relaxed ) );
+    input_item_snapshot_DeleteList( owner->retired );
+
     free( p_item->psz_name );
     free( p_item->psz_uri );
     free( p_item->p_stats );
@@ -979,6 +1224,10 @@ input_item_NewExt( const char *psz_uri, const char *psz_name,
         return NULL;
 
     vlc_atomic_rc_init( &owner->rc );
+    atomic_init( &owner->snapshot, NULL );
+    atomic_init( &owner->revision, 0 );
+    atomic_init( &owner->readers, 0 );
+    owner->retired = NULL;
 
     input_item_t *p_input = &owner->item;
 
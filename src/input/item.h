@@ -29,10 +29,21 @@
 void input_item_UpdateTracksInfo( input_item_t *item, const es_format_t *fmt,
                                   const char *es_id, bool stable );
 
+struct input_item_snapshot;
+
 typedef struct input_item_owner
 {
     input_item_t item;
     vlc_atomic_rc_t rc;
+
+    /* current metadata snapshot */
+    struct input_item_snapshot *_Atomic snapshot;
+    /* incremented on name, URI and duration changes */
+    atomic_uint revision;
+    /* readers taking a reference to the current snapshot */
+    atomic_uint readers;
+    /* replaced snapshots, freed (under the item lock) once unreferenced */
+    struct input_item_snapshot *retired;
 } input_item_owner_t;
 
 # define item_owner(item) ((struct input_item_owner *)(item))
@@ -31,6 +31,7 @@
 #include <vlc_url.h>
 #include <vlc_arrays.h>
 #include <vlc_modules.h>
+#include <vlc_atomic.h>
 
 #include "input_internal.h"
 #include "../preparser/art.h"
@@ -49,6 +50,8 @@ struct vlc_meta_t
     vlc_dictionary_t extra_tags;
 
     int i_status;
+
+    atomic_uint revision;
 };
 
 const char *vlc_meta_TypeToString(vlc_meta_type_t meta_type)
@@ -111,6 +114,7 @@ vlc_meta_t *vlc_meta_New( void )
         m->meta[i].priority = VLC_META_PRIORITY_BASIC;
     }
     m->i_status = 0;
+    atomic_init( &m->revision, 0 );
     vlc_dictionary_init( &m->extra_tags, 0 );
     return m;
 }
@@ -150,8 +154,14 @@ void vlc_meta_Delete( vlc_meta_t *m )
  * FIXME - Why don't we merge those two?
  */
 
+static void vlc_meta_Modified( vlc_meta_t *m )
+{
+    atomic_fetch_add_explicit( &m->revision, 1, memory_order_relaxed );
+}
+
 void vlc_meta_SetWithPriority( vlc_meta_t *p_meta, vlc_meta_type_t meta_type, const char *psz_val, vlc_meta_priority_t priority )
 {
+    vlc_meta_Modified( p_meta );
     free( p_meta->meta[meta_type].value );
     assert( psz_val == NULL || IsUTF8( psz_val ) );
     p_meta->meta[meta_type].value = psz_val ? strdup( psz_val ) : NULL;
@@ -166,6 +176,7 @@ const char *vlc_meta_Get( const vlc_meta_t *p_meta, vlc_meta_type_t meta_type )
 void vlc_meta_SetExtraWithPriority( vlc_meta_t *m, const char *psz_name, const char *psz_value, vlc_meta_priority_t priority )
 {
     assert( psz_name );
+    vlc_meta_Modified( m );
     struct vlc_meta_value *old_meta_value = vlc_dictionary_value_for_key( &m->extra_tags, psz_name );
     if( old_meta_value != kVLCDictionaryNotFound )
         vlc_dictionary_remove_value_for_key( &m->extra_tags, psz_name,
@@ -192,6 +203,11 @@ char** vlc_meta_CopyExtraNames( const vlc_meta_t *m )
     return vlc_dictionary_all_keys(&m->extra_tags);
 }
 
+unsigned vlc_meta_GetRevision( const vlc_meta_t *m )
+{
+    return atomic_load_explicit( &m->revision, memory_order_relaxed );
+}
+
 /**
  * vlc_meta status (see vlc_meta_status_e)
  */
@@ -214,6 +230,8 @@ void vlc_meta_Merge( vlc_meta_t *dst, const vlc_meta_t *src )
     if( !dst || !src )
         return;
 
+    vlc_meta_Modified( dst );
+
     for( int i = 0; i < VLC_META_TYPE_COUNT; i++ )
     {
         /* overwrite metadata only when priority of src is 
@@ -78,6 +78,14 @@ input_item_parser_InputEvent(input_thread_t *input,
             else
                 input_item_node_Delete(event->subitems);
             break;
+        case INPUT_EVENT_PARTIAL_SUBITEMS:
+            if (parser->cbs->on_partial_subtree_added)
+                parser->cbs->on_partial_subtree_added(input_GetItem(input),
+                                                      event->subitems,
+                                                      parser->userdata);
+            else
+                handled = false;
+            break;
         case INPUT_EVENT_ATTACHMENTS:
             if (parser->cbs->on_attachments_added != NULL)
                 parser->cbs->on_attachments_added(input_GetItem(input),
@@ -124,6 +124,13 @@ void vlc_input_decoder_ChangeRate(
     (void)owner; (void)rate;
 }
 
+void vlc_input_decoder_SetScrubbing(
+    vlc_input_decoder_t *owner,
+    bool scrubbing)
+{
+    (void)owner; (void)scrubbing;
+}
+
 void vlc_input_decoder_StartWait(vlc_input_decoder_t *owner)
 {
     (void)owner;
@@ -224,6 +224,12 @@ static const char *const ppsz_mix_mode_texts[] = {
     "This adds audio post processing filters, to modify " \
     "the sound rendering." )
 
+#define AUDIO_FILTER_GRAPH_TEXT N_("Process audio filters in place")
+#define AUDIO_FILTER_GRAPH_LONGTEXT N_( \
+    "Successive audio filters supporting it process the samples in place " \
+    "on a shared planar buffer, without format conversions in between. " \
+    "Only a few filters support it so far (gain, karaoke, stereo widening).")
+
 #define AUDIO_VISUAL_TEXT N_("Audio visualizations")
 #define AUDIO_VISUAL_LONGTEXT N_( \
     "This adds visualization modules (spectrum analyzer, etc.).")
@@ -783,10 +789,11 @@ static const char* const ppsz_restore_playback_desc[] = {
 #define INPUT_TIMESHIFT_PATH_LONGTEXT N_( \
     "Directory used to store the timeshift temporary files." )
 
-#define INPUT_TIMESHIFT_GRANULARITY_TEXT N_("Timeshift granularity")
-#define INPUT_TIMESHIFT_GRANULARITY_LONGTEXT N_( \
-    "This is the maximum size in bytes of the temporary files " \
-    "that will be used to store the timeshifted streams." )
+#define INPUT_TIMESHIFT_SIZE_TEXT N_("Timeshift buffer size (MiB)")
+#define INPUT_TIMESHIFT_SIZE_LONGTEXT N_( \
+    "This is the maximum size of the temporary file " \
+    "that will be used to store the timeshifted streams. When it is " \
+    "full, the oldest data is dropped up to the next keyframe." )
 
 #define INPUT_TITLE_FORMAT_TEXT N_( "Change title according to current media" )
 #define INPUT_TITLE_FORMAT_LONGTEXT N_( "This option allows you to set the title according to what's being played<br>"  \
@@ -1019,6 +1026,12 @@ static const char* const ppsz_restore_playback_desc[] = {
     "VLC will fallback automatically to software decoders in case of " \
     "hardware decoder failure." )
 
+#define DEC_THREADS_TEXT N_("Decoder threads budget")
+#define DEC_THREADS_LONGTEXT N_( \
+    "Maximum number of threads shared by all the software decoders, " \
+    "divided according to the picture sizes. Decoders opened when the " \
+    "budget is used up get a smaller share. 0 means the number of CPU cores." )
+
 #define DEC_DEV_TEXT N_("Preferred decoder hardware device")
 #define DEC_DEV_LONGTEXT N_("This allows hardware decoding when available.")
 
@@ -1644,6 +1657,8 @@ vlc_module_begin ()
                    AUDIO_BITEXACT_LONGTEXT )
     add_module_list("audio-filter", "audio filter", NULL,
                     AUDIO_FILTER_TEXT, AUDIO_FILTER_LONGTEXT)
+    add_bool( "audio-filter-graph", false, AUDIO_FILTER_GRAPH_TEXT,
+              AUDIO_FILTER_GRAPH_LONGTEXT )
     set_subcategory( SUBCAT_AUDIO_VISUAL )
     add_module("audio-visual", "visualization", "none",
                AUDIO_VISUAL_TEXT, AUDIO_VISUAL_LONGTEXT)
@@ -2014,8 +2029,10 @@ vlc_module_begin ()
 
     add_directory("input-timeshift-path", NULL,
                   INPUT_TIMESHIFT_PATH_TEXT, INPUT_TIMESHIFT_PATH_LONGTEXT)
-    add_integer( "input-timeshift-granularity", -1, INPUT_TIMESHIFT_GRANULARITY_TEXT,
-                 INPUT_TIMESHIFT_GRANULARITY_LONGTEXT )
+    add_obsolete_integer( "input-timeshift-granularity" ) /* since 4.0.0 */
+    add_integer_with_range( "input-timeshift-size", 1024, 1, 1024 * 1024,
+                            INPUT_TIMESHIFT_SIZE_TEXT,
+                            INPUT_TIMESHIFT_SIZE_LONGTEXT )
 
     add_string( "input-title-format", "$Z", INPUT_TITLE_FORMAT_TEXT, INPUT_TITLE_FORMAT_LONGTEXT )
 
@@ -2035,6 +2052,8 @@ vlc_module_begin ()
 
     add_string( "codec", "any", CODEC_TEXT, CODEC_LONGTEXT )
     add_bool( "hw-dec", true, HW_DEC_TEXT, HW_DEC_LONGTEXT )
+    add_integer_with_range( "dec-threads", 0, 0, 1024,
+                            DEC_THREADS_TEXT, DEC_THREADS_LONGTEXT )
     add_obsolete_string( "encoder" ) /* since 4.0.0 */
     add_module("dec-dev", "decoder device", "any", DEC_DEV_TEXT, DEC_DEV_LONGTEXT)
 
@@ -96,6 +96,7 @@ libvlc_int_t * libvlc_InternalCreate( void )
     priv->main_playlist = NULL;
     priv->p_vlm = NULL;
     priv->media_source_provider = NULL;
+    vlc_list_init(&priv->cleanups);
 
     vlc_ExitInit( &priv->exit );
 
@@ -331,6 +332,46 @@ error:
     return i_ret;
 }
 
+/* Handler registered with libvlc_AddCleanup() */
+struct libvlc_cleanup
+{
+    void (*cb)(void *);
+    void *opaque;
+    struct vlc_list node;
+};
+
+/* Registers a handler run by libvlc_InternalCleanup(), see vlc_interface.h */
+int libvlc_AddCleanup(libvlc_int_t *libvlc, void (*cb)(void *), void *opaque)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    struct libvlc_cleanup *cleanup = malloc(sizeof (*cleanup));
+
+    if (unlikely(cleanup == NULL))
+        return -ENOMEM;
+
+    cleanup->cb = cb;
+    cleanup->opaque = opaque;
+
+    vlc_mutex_lock(&priv->lock);
+    vlc_list_prepend(&cleanup->node, &priv->cleanups);
+    vlc_mutex_unlock(&priv->lock);
+    return 0;
+}
+
+static void libvlc_RunCleanups(libvlc_int_t *libvlc)
+{
+    libvlc_priv_t *priv = libvlc_priv(libvlc);
+    struct libvlc_cleanup *cleanup;
+
+    /* Last registered first */
+    vlc_list_foreach(cleanup, &priv->cleanups, node)
+    {
+        vlc_list_remove(&cleanup->node);
+        cleanup->cb(cleanup->opaque);
+        free(cleanup);
+    }
+}
+
 /**
  * Cleanup a libvlc instance. The instance is not completely deallocated
  * \param p_libvlc the instance to clean
@@ -372,6 +413,8 @@ void libvlc_InternalCleanup( libvlc_int_t *p_libvlc )
     if( priv->media_source_provider )
         vlc_media_source_provider_Delete( priv->media_source_provider );
 
+    libvlc_RunCleanups( p_libvlc );
+
     libvlc_InternalDialogClean( p_libvlc );
     libvlc_InternalKeystoreClean( p_libvlc );
     libvlc_InternalActionsClean( p_libvlc );
@@ -187,6 +187,7 @@ typedef struct libvlc_priv_t
     vlc_actions_t *actions; ///< Hotkeys handler
     struct vlc_medialibrary_t *p_media_library; ///< Media library instance
     struct vlc_tracer *tracer; ///< Tracer callbacks
+    struct vlc_list cleanups; ///< Handlers registered by libvlc_AddCleanup()
 
     /* Exit callback */
     vlc_exit_t       exit;
@@ -166,6 +166,65 @@ void vlc_frame_Release(vlc_frame_t *frame)
     frame->cbs->free(frame);
 }
 
+/* Shared payload of frames created by vlc_frame_MakeShareable() and
+ * vlc_frame_Share() */
+struct vlc_frame_payload
+{
+    vlc_atomic_rc_t rc;
+    vlc_frame_t *origin; /**< frame owning the buffer */
+};
+
+struct vlc_frame_ref
+{
+    vlc_frame_t frame;
+    struct vlc_frame_payload *payload;
+};
+
+static void vlc_frame_ref_Release(vlc_frame_t *frame)
+{
+    struct vlc_frame_ref *ref = container_of(frame, struct vlc_frame_ref,
+                                             frame);
+    struct vlc_frame_payload *payload = ref->payload;
+
+    if (vlc_atomic_rc_dec(&payload->rc))
+    {
+        vlc_frame_Release(payload->origin);
+        free(payload);
+    }
+    free(ref);
+}
+
+static const struct vlc_frame_callbacks vlc_frame_ref_cbs =
+{
+    vlc_frame_ref_Release,
+};
+
+static vlc_frame_t *vlc_frame_ref_New(const vlc_frame_t *frame,
+                                      struct vlc_frame_payload *payload)
+{
+    struct vlc_frame_ref *ref = malloc(sizeof (*ref));
+    if (unlikely(ref == NULL))
+        return NULL;
+
+    vlc_frame_Init(&ref->frame, &vlc_frame_ref_cbs, frame->p_start,
+                   frame->i_size);
+    ref->frame.p_buffer = frame->p_buffer;
+    ref->frame.i_buffer = frame->i_buffer;
+    vlc_frame_CopyProperties(&ref->frame, frame);
+    ref->payload = payload;
+    return &ref->frame;
+}
+
+bool vlc_frame_IsShared(const vlc_frame_t *frame)
+{
+    if (frame->cbs != &vlc_frame_ref_cbs)
+        return false;
+
+    const struct vlc_frame_ref *ref =
+        container_of(frame, const struct vlc_frame_ref, frame);
+    return vlc_atomic_rc_get(&ref->payload->rc) > 1;
+}
+
 static vlc_frame_t *vlc_frame_ReallocDup( vlc_frame_t *frame, ssize_t i_prebody, size_t requested )
 {
     vlc_frame_t *p_rea = vlc_frame_Alloc( requested );
@@ -216,6 +275,11 @@ vlc_frame_t *vlc_frame_TryRealloc (vlc_frame_t *frame, ssize_t i_prebody, size_t
 
     size_t requested = i_prebody + i_body;
 
+    /* The spare space of a shared buffer cannot be written to */
+    if( ( i_prebody > 0 || i_body > frame->i_buffer )
+     && vlc_frame_IsShared( frame ) )
+        return vlc_frame_ReallocDup( frame, i_prebody, requested );
+
     if( frame->i_buffer == 0 )
     {   /* Corner case: nothing to preserve */
         if( requested <= frame->i_size )
@@ -265,6 +329,54 @@ vlc_frame_t *vlc_frame_Realloc (vlc_frame_t *frame, ssize_t prebody, size_t body
     return rea;
 }
 
+vlc_frame_t *vlc_frame_MakeShareable(vlc_frame_t *frame)
+{
+    if (frame->cbs == &vlc_frame_ref_cbs)
+        return frame;
+
+    struct vlc_frame_payload *payload = malloc(sizeof (*payload));
+    if (unlikely(payload == NULL))
+        return frame;
+
+    vlc_frame_t *ref = vlc_frame_ref_New(frame, payload);
+    if (unlikely(ref == NULL))
+    {
+        free(payload);
+        return frame;
+    }
+
+    vlc_atomic_rc_init(&payload->rc);
+    payload->origin = frame;
+    ref->p_next = frame->p_next;
+    frame->p_next = NULL;
+    return ref;
+}
+
+vlc_frame_t *vlc_frame_Share(const vlc_frame_t *frame)
+{
+    if (frame->cbs != &vlc_frame_ref_cbs)
+        return vlc_frame_Duplicate(frame);
+
+    const struct vlc_frame_ref *ref =
+        container_of(frame, const struct vlc_frame_ref, frame);
+    vlc_frame_t *dup = vlc_frame_ref_New(frame, ref->payload);
+    if (likely(dup != NULL))
+        vlc_atomic_rc_inc(&ref->payload->rc);
+    return dup;
+}
+
+vlc_frame_t *vlc_frame_MakeWritable(vlc_frame_t *frame)
+{
+    if (!vlc_frame_IsShared(frame))
+        return frame;
+
+    vlc_frame_t *dup = vlc_frame_Duplicate(frame);
+    if (likely(dup != NULL))
+        dup->p_next = frame->p_next;
+    vlc_frame_Release(frame);
+    return dup;
+}
+
 static void vlc_frame_heap_Release (vlc_frame_t *frame)
 {
     free (frame->p_start);
@@ -1187,6 +1187,9 @@ vlc_player_input_New(vlc_player_t *player, input_item_t *item)
     }
     vlc_player_input_RestoreMlStates(input, false);
 
+    if (player->scrubbing)
+        input_SetScrubbing(input->thread, true);
+
     if (player->video_string_ids)
         vlc_player_input_SelectTracksByStringIds(input, VIDEO_ES,
                                                  player->video_string_ids);
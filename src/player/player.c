@@ -1371,6 +1371,29 @@ vlc_player_DecrementRate(vlc_player_t *player)
     vlc_player_ChangeRateOffset(player, false);
 }
 
+void
+vlc_player_SetScrubbing(vlc_player_t *player, bool scrubbing)
+{
+    vlc_player_assert_locked(player);
+
+    if (player->scrubbing == scrubbing)
+        return;
+
+    /* Saved across inputs */
+    player->scrubbing = scrubbing;
+
+    struct vlc_player_input *input = vlc_player_get_input_locked(player);
+    if (input)
+        input_SetScrubbing(input->thread, scrubbing);
+}
+
+bool
+vlc_player_IsScrubbing(vlc_player_t *player)
+{
+    vlc_player_assert_locked(player);
+    return player->scrubbing;
+}
+
 vlc_tick_t
 vlc_player_GetLength(vlc_player_t *player)
 {
@@ -2005,6 +2028,7 @@ vlc_player_New(vlc_object_t *parent, enum vlc_player_lock_type lock_type)
     player->start_paused = false;
     player->pause_on_cork = false;
     player->corked = false;
+    player->scrubbing = false;
     player->renderer = NULL;
     player->media = NULL;
     player->input = NULL;
@@ -249,6 +249,8 @@ struct vlc_player_t
     bool pause_on_cork;
     bool corked;
 
+    bool scrubbing;
+
     struct vlc_list listeners;
     struct vlc_list metadata_listeners;
     struct vlc_list aout_listeners;
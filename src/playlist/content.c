@@ -29,14 +29,22 @@
 #include "notify.h"
 #include "playlist.h"
 #include "preparse.h"
+#include "sort.h"
 
 void
 vlc_playlist_ClearItems(vlc_playlist_t *playlist)
 {
-    vlc_playlist_item_t *item;
-    vlc_vector_foreach(item, &playlist->items)
-        vlc_playlist_item_Release(item);
-    vlc_vector_clear(&playlist->items);
+    size_t size = item_seq_Size(&playlist->items);
+    for (size_t i = 0; i < size;)
+    {
+        size_t count = size - i;
+        vlc_playlist_item_t **run = item_seq_Run(&playlist->items, i, &count);
+        for (size_t j = 0; j < count; ++j)
+            vlc_playlist_item_Release(run[j]);
+        i += count;
+    }
+    item_seq_Clear(&playlist->items);
+    item_index_Clear(&playlist->item_index);
 }
 
 static void
@@ -52,18 +60,19 @@ vlc_playlist_ItemsReset(vlc_playlist_t *playlist)
     playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
     playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
 
-    vlc_playlist_Notify(playlist, on_items_reset, playlist->items.data,
-                   playlist->items.size);
+    /* only called once the playlist is empty */
+    assert(item_seq_Size(&playlist->items) == 0);
+    vlc_playlist_Notify(playlist, on_items_reset, NULL, 0);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 }
 
 static void
-vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count,
+vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index,
+                           vlc_playlist_item_t *items[], size_t count,
                            bool subitems)
 {
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
-        randomizer_Add(&playlist->randomizer,
-                       &playlist->items.data[index], count);
+        randomizer_Add(&playlist->randomizer, items, count);
 
     struct vlc_playlist_state state;
     vlc_playlist_state_Save(playlist, &state);
@@ -73,13 +82,12 @@ vlc_playlist_ItemsInserted(vlc_playlist_t *playlist, size_t index, size_t count,
     playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
     playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
 
-    vlc_playlist_item_t **items = &playlist->items.data[index];
     vlc_playlist_Notify(playlist, on_items_added, index, items, count);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 
-    for (size_t i = index; i < index + count; ++i)
+    for (size_t i = 0; i < count; ++i)
     {
-        vlc_playlist_item_t *item = playlist->items.data[i];
+        vlc_playlist_item_t *item = items[i];
         item->preparser_req = vlc_playlist_AutoPreparse(playlist, item->media,
                                                         subitems);
     }
@@ -127,8 +135,16 @@ static void
 vlc_playlist_ItemsRemoving(vlc_playlist_t *playlist, size_t index, size_t count)
 {
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
-        randomizer_Remove(&playlist->randomizer,
-                          &playlist->items.data[index], count);
+    {
+        for (size_t i = index; i < index + count;)
+        {
+            size_t n = index + count - i;
+            vlc_playlist_item_t **run =
+                item_seq_Run(&playlist->items, i, &n);
+            randomizer_Remove(&playlist->randomizer, run, n);
+            i += n;
+        }
+    }
 }
 
 /* return whether the current media has changed */
@@ -143,7 +159,7 @@ vlc_playlist_ItemsRemoved(vlc_playlist_t *playlist, size_t index, size_t count)
         size_t current = (size_t) playlist->current;
         if (current >= index && current < index + count) {
             /* current item has been removed */
-            if (index + count < playlist->items.size) {
+            if (index + count < item_seq_Size(&playlist->items)) {
                 /* select the first item after the removed block */
                 playlist->current = index;
             } else {
@@ -173,26 +189,52 @@ vlc_playlist_ItemReplaced(vlc_playlist_t *playlist, size_t index)
     playlist->has_prev = vlc_playlist_ComputeHasPrev(playlist);
     playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
 
-    vlc_playlist_Notify(playlist, on_items_updated, index,
-                        &playlist->items.data[index], 1);
+    vlc_playlist_item_t *item = item_seq_Get(&playlist->items, index);
+    vlc_playlist_Notify(playlist, on_items_updated, index, &item, 1);
     vlc_playlist_state_NotifyChanges(playlist, &state);
 
-    vlc_playlist_AutoPreparse(playlist, playlist->items.data[index]->media,
-                              false);
+    vlc_playlist_AutoPreparse(playlist, item->media, false);
 }
 
 size_t
 vlc_playlist_Count(vlc_playlist_t *playlist)
 {
     vlc_playlist_AssertLocked(playlist);
-    return playlist->items.size;
+    return item_seq_Size(&playlist->items);
 }
 
 vlc_playlist_item_t *
 vlc_playlist_Get(vlc_playlist_t *playlist, size_t index)
 {
     vlc_playlist_AssertLocked(playlist);
-    return playlist->items.data[index];
+    return item_seq_Get(&playlist->items, index);
+}
+
+static ssize_t
+vlc_playlist_FindIndex(vlc_playlist_t *playlist,
+                       const vlc_playlist_item_t *item)
+{
+    struct item_seq *items = &playlist->items;
+    size_t *valid = &playlist->item_index.valid;
+
+    /* the positions below valid are up to date, so if the cached position
+     * is wrong, the item is either further or not in the playlist anymore */
+    if (item->index < *valid && item_seq_Get(items, item->index) == item)
+        return item->index;
+
+    /* renumber the following items until the requested one is found */
+    while (*valid < item_seq_Size(items))
+    {
+        size_t count = item_seq_Size(items) - *valid;
+        vlc_playlist_item_t **run = item_seq_Run(items, *valid, &count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            run[i]->index = (*valid)++;
+            if (run[i] == item)
+                return item->index;
+        }
+    }
+    return -1;
 }
 
 ssize_t
@@ -200,9 +242,7 @@ vlc_playlist_IndexOf(vlc_playlist_t *playlist, const vlc_playlist_item_t *item)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    ssize_t index;
-    vlc_vector_index_of(&playlist->items, item, &index);
-    return index;
+    return vlc_playlist_FindIndex(playlist, item);
 }
 
 ssize_t
@@ -210,11 +250,19 @@ vlc_playlist_IndexOfMedia(vlc_playlist_t *playlist, const input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->media == media)
-            return i;
-    return -1;
+    /* the same media may have been inserted several times, return the first
+     * occurrence */
+    ssize_t first = -1;
+    size_t cursor = 0;
+    vlc_playlist_item_t *item;
+    while ((item = item_index_NextMedia(&playlist->item_index, media, &cursor)))
+    {
+        ssize_t index = vlc_playlist_FindIndex(playlist, item);
+        assert(index != -1);
+        if (first == -1 || index < first)
+            first = index;
+    }
+    return first;
 }
 
 ssize_t
@@ -222,11 +270,8 @@ vlc_playlist_IndexOfId(vlc_playlist_t *playlist, uint64_t id)
 {
     vlc_playlist_AssertLocked(playlist);
 
-    playlist_item_vector_t *items = &playlist->items;
-    for (size_t i = 0; i < items->size; ++i)
-        if (items->data[i]->id == id)
-            return i;
-    return -1;
+    vlc_playlist_item_t *item = item_index_FindId(&playlist->item_index, id);
+    return item ? vlc_playlist_FindIndex(playlist, item) : -1;
 }
 
 void
@@ -256,39 +301,69 @@ vlc_playlist_MediaToItems(vlc_playlist_t *playlist, input_item_t *const media[],
         items[i] = vlc_playlist_item_New(media[i], id);
         if (unlikely(!items[i]))
             break;
+        if (unlikely(!item_index_Add(&playlist->item_index, items[i])))
+        {
+            vlc_playlist_item_Release(items[i]);
+            break;
+        }
     }
     if (i < count)
     {
         /* allocation failure, release partial items */
         while (i)
-            vlc_playlist_item_Release(items[--i]);
+        {
+            item_index_Remove(&playlist->item_index, items[--i]);
+            vlc_playlist_item_Release(items[i]);
+        }
         return VLC_ENOMEM;
     }
     return VLC_SUCCESS;
 }
 
+static int
+vlc_playlist_InsertItems(vlc_playlist_t *playlist, size_t index,
+                         input_item_t *const media[], size_t count,
+                         bool subitems)
+{
+    vlc_playlist_item_t **items = vlc_alloc(count, sizeof(*items));
+    if (unlikely(!items))
+        return VLC_ENOMEM;
+
+    int ret = vlc_playlist_MediaToItems(playlist, media, count, items);
+    if (ret != VLC_SUCCESS)
+    {
+        free(items);
+        return ret;
+    }
+
+    if (!item_seq_Insert(&playlist->items, index, items, count))
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            item_index_Remove(&playlist->item_index, items[i]);
+            vlc_playlist_item_Release(items[i]);
+        }
+        free(items);
+        return VLC_ENOMEM;
+    }
+    item_index_Invalidate(&playlist->item_index, index);
+
+    vlc_playlist_ItemsInserted(playlist, index, items, count, subitems);
+    free(items);
+    return VLC_SUCCESS;
+}
+
 int
 vlc_playlist_Insert(vlc_playlist_t *playlist, size_t index,
                     input_item_t *const media[], size_t count)
 {
     vlc_playlist_AssertLocked(playlist);
-    assert(index <= playlist->items.size);
-
-    /* make space in the vector */
-    if (!vlc_vector_insert_hole(&playlist->items, index, count))
-        return VLC_ENOMEM;
+    assert(index <= item_seq_Size(&playlist->items));
 
-    /* create playlist items in place */
-    int ret = vlc_playlist_MediaToItems(playlist, media, count,
-                                        &playlist->items.data[index]);
+    int ret = vlc_playlist_InsertItems(playlist, index, media, count, true);
     if (ret != VLC_SUCCESS)
-    {
-        /* we were optimistic, it failed, restore the vector state */
-        vlc_vector_remove_slice(&playlist->items, index, count);
         return ret;
-    }
 
-    vlc_playlist_ItemsInserted(playlist, index, count, true);
     vlc_playlist_UpdateNextMedia(playlist);
 
     return VLC_SUCCESS;
@@ -299,10 +374,13 @@ vlc_playlist_Move(vlc_playlist_t *playlist, size_t index, size_t count,
                   size_t target)
 {
     vlc_playlist_AssertLocked(playlist);
-    assert(index + count <= playlist->items.size);
-    assert(target + count <= playlist->items.size);
+    assert(index + count <= item_seq_Size(&playlist->items));
+    assert(target + count <= item_seq_Size(&playlist->items));
 
-    vlc_vector_move_slice(&playlist->items, index, count, target);
+    item_seq_Move(&playlist->items, index, count, target);
+    item_index_Invalidate(&playlist->item_index,
+                          index < target ? index : target);
+    vlc_playlist_ForgetSortOrder(playlist);
 
     vlc_playlist_ItemsMoved(playlist, index, count, target);
     vlc_playlist_UpdateNextMedia(playlist);
@@ -312,20 +390,28 @@ void
 vlc_playlist_Remove(vlc_playlist_t *playlist, size_t index, size_t count)
 {
     vlc_playlist_AssertLocked(playlist);
-    assert(index < playlist->items.size);
+    assert(index < item_seq_Size(&playlist->items));
 
     vlc_playlist_ItemsRemoving(playlist, index, count);
 
-    for (size_t i = 0; i < count; ++i) {
-        vlc_playlist_item_t *item = playlist->items.data[index + i];
-        if (playlist->parser != NULL
-                && item->preparser_req != NULL)
-            vlc_preparser_Cancel(playlist->parser, item->preparser_req);
+    for (size_t i = index; i < index + count;) {
+        size_t n = index + count - i;
+        vlc_playlist_item_t **run = item_seq_Run(&playlist->items, i, &n);
+        for (size_t j = 0; j < n; ++j)
+        {
+            vlc_playlist_item_t *item = run[j];
+            if (playlist->parser != NULL
+                    && item->preparser_req != NULL)
+                vlc_preparser_Cancel(playlist->parser, item->preparser_req);
 
-        vlc_playlist_item_Release(item);
+            item_index_Remove(&playlist->item_index, item);
+            vlc_playlist_item_Release(item);
+        }
+        i += n;
     }
 
-    vlc_vector_remove_slice(&playlist->items, index, count);
+    item_seq_Remove(&playlist->items, index, count);
+    item_index_Invalidate(&playlist->item_index, index);
 
     bool current_media_changed = vlc_playlist_ItemsRemoved(playlist, index,
                                                            count);
@@ -340,26 +426,34 @@ vlc_playlist_Replace(vlc_playlist_t *playlist, size_t index,
                      input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
-    assert(index < playlist->items.size);
+    assert(index < item_seq_Size(&playlist->items));
 
     uint64_t id = playlist->idgen++;
     vlc_playlist_item_t *item = vlc_playlist_item_New(media, id);
     if (!item)
         return VLC_ENOMEM;
 
+    if (!item_index_Add(&playlist->item_index, item))
+    {
+        vlc_playlist_item_Release(item);
+        return VLC_ENOMEM;
+    }
+
+    vlc_playlist_item_t *old = item_seq_Get(&playlist->items, index);
+
     if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
     {
-        randomizer_Remove(&playlist->randomizer,
-                          &playlist->items.data[index], 1);
+        randomizer_Remove(&playlist->randomizer, &old, 1);
         randomizer_Add(&playlist->randomizer, &item, 1);
     }
 
-    vlc_playlist_item_t *old = playlist->items.data[index];
     if (playlist->parser != NULL
             && old->preparser_req != NULL)
         vlc_preparser_Cancel(playlist->parser, old->preparser_req);
+    item_index_Remove(&playlist->item_index, old);
     vlc_playlist_item_Release(old);
-    playlist->items.data[index] = item;
+    *item_seq_Ref(&playlist->items, index) = item;
+    item->index = index;
 
     vlc_playlist_ItemReplaced(playlist, index);
     return VLC_SUCCESS;
@@ -370,7 +464,7 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
                     input_item_t *const media[], size_t count)
 {
     vlc_playlist_AssertLocked(playlist);
-    assert(index < playlist->items.size);
+    assert(index < item_seq_Size(&playlist->items));
 
     if (count == 0)
         vlc_playlist_RemoveOne(playlist, index);
@@ -382,20 +476,10 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
 
         if (count > 1)
         {
-            /* make space in the vector */
-            if (!vlc_vector_insert_hole(&playlist->items, index + 1, count - 1))
-                return VLC_ENOMEM;
-
-            /* create playlist items in place */
-            ret = vlc_playlist_MediaToItems(playlist, &media[1], count - 1,
-                                            &playlist->items.data[index + 1]);
+            ret = vlc_playlist_InsertItems(playlist, index + 1, &media[1],
+                                           count - 1, false);
             if (ret != VLC_SUCCESS)
-            {
-                /* we were optimistic, it failed, restore the vector state */
-                vlc_vector_remove_slice(&playlist->items, index + 1, count - 1);
                 return ret;
-            }
-            vlc_playlist_ItemsInserted(playlist, index + 1, count - 1, false);
         }
 
         if ((ssize_t) index == playlist->current)
@@ -406,3 +490,24 @@ vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
 
     return VLC_SUCCESS;
 }
+
+int
+vlc_playlist_ExpandPartially(vlc_playlist_t *playlist, size_t index,
+                             input_item_t *const media[], size_t count)
+{
+    vlc_playlist_AssertLocked(playlist);
+    assert(index < item_seq_Size(&playlist->items));
+
+    if (count == 0)
+        return VLC_SUCCESS;
+
+    int ret = vlc_playlist_InsertItems(playlist, index, media, count, false);
+    if (ret != VLC_SUCCESS)
+        return ret;
+
+    vlc_playlist_item_t *item = item_seq_Get(&playlist->items, index + count);
+    item->partially_expanded += count;
+
+    vlc_playlist_UpdateNextMedia(playlist);
+    return VLC_SUCCESS;
+}
@@ -33,4 +33,9 @@ int
 vlc_playlist_Expand(vlc_playlist_t *playlist, size_t index,
                     input_item_t *const media[], size_t count);
 
+/* insert the first part of the expansion of an item, before the item */
+int
+vlc_playlist_ExpandPartially(vlc_playlist_t *playlist, size_t index,
+                             input_item_t *const media[], size_t count);
+
 #endif
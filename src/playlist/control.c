@@ -36,9 +36,15 @@ vlc_playlist_PlaybackOrderChanged(vlc_playlist_t *playlist)
     {
         /* randomizer is expected to be empty at this point */
         assert(randomizer_Count(&playlist->randomizer) == 0);
-        if (playlist->items.size)
-            randomizer_Add(&playlist->randomizer, playlist->items.data,
-                           playlist->items.size);
+        size_t size = item_seq_Size(&playlist->items);
+        for (size_t i = 0; i < size;)
+        {
+            size_t count = size - i;
+            vlc_playlist_item_t **run = item_seq_Run(&playlist->items, i,
+                                                     &count);
+            randomizer_Add(&playlist->randomizer, run, count);
+            i += count;
+        }
 
         bool loop = playlist->repeat == VLC_PLAYLIST_PLAYBACK_REPEAT_ALL;
         randomizer_SetLoop(&playlist->randomizer, loop);
@@ -155,7 +161,7 @@ vlc_playlist_SetCurrentMedia(vlc_playlist_t *playlist, ssize_t index)
     vlc_playlist_AssertLocked(playlist);
 
     input_item_t *media = index != -1
-                        ? playlist->items.data[index]->media
+                        ? item_seq_Get(&playlist->items, index)->media
                         : NULL;
     return vlc_player_SetCurrentMedia(playlist->player, media);
 }
@@ -167,7 +173,7 @@ vlc_playlist_NormalOrderHasPrev(vlc_playlist_t *playlist)
         return false;
 
     if (playlist->repeat == VLC_PLAYLIST_PLAYBACK_REPEAT_ALL)
-        return playlist->items.size > 0;
+        return item_seq_Size(&playlist->items) > 0;
 
     return playlist->current > 0;
 }
@@ -182,7 +188,7 @@ vlc_playlist_NormalOrderGetPrevIndex(vlc_playlist_t *playlist)
             return playlist->current - 1;
         case VLC_PLAYLIST_PLAYBACK_REPEAT_ALL:
             if (playlist->current == 0)
-                return playlist->items.size - 1;
+                return item_seq_Size(&playlist->items) - 1;
             return playlist->current - 1;
         default:
             vlc_assert_unreachable();
@@ -193,10 +199,10 @@ static inline bool
 vlc_playlist_NormalOrderHasNext(vlc_playlist_t *playlist)
 {
     if (playlist->repeat == VLC_PLAYLIST_PLAYBACK_REPEAT_ALL)
-        return playlist->items.size > 0;
+        return item_seq_Size(&playlist->items) > 0;
 
-    /* also works if current == -1 or playlist->items.size == 0 */
-    return playlist->current < (ssize_t) playlist->items.size - 1;
+    /* also works if current == -1 or the playlist is empty */
+    return playlist->current < (ssize_t) item_seq_Size(&playlist->items) - 1;
 }
 
 static inline size_t
@@ -206,11 +212,12 @@ vlc_playlist_NormalOrderGetNextIndex(vlc_playlist_t *playlist)
     {
         case VLC_PLAYLIST_PLAYBACK_REPEAT_NONE:
         case VLC_PLAYLIST_PLAYBACK_REPEAT_CURRENT:
-            assert(playlist->current < (ssize_t) playlist->items.size - 1);
+            assert(playlist->current
+                    < (ssize_t) item_seq_Size(&playlist->items) - 1);
             return playlist->current + 1;
         case VLC_PLAYLIST_PLAYBACK_REPEAT_ALL:
-            assert(playlist->items.size != 0);
-            return (playlist->current + 1) % playlist->items.size;
+            assert(item_seq_Size(&playlist->items) != 0);
+            return (playlist->current + 1) % item_seq_Size(&playlist->items);
         default:
             vlc_assert_unreachable();
     }
@@ -236,7 +243,7 @@ static inline bool
 vlc_playlist_RandomOrderHasNext(vlc_playlist_t *playlist)
 {
     if (playlist->repeat == VLC_PLAYLIST_PLAYBACK_REPEAT_ALL)
-        return playlist->items.size > 0;
+        return item_seq_Size(&playlist->items) > 0;
     return randomizer_HasNext(&playlist->randomizer);
 }
 
@@ -363,7 +370,7 @@ vlc_playlist_Prev(vlc_playlist_t *playlist)
     {
         /* mark the item as selected in the randomizer */
         vlc_playlist_item_t *selected = randomizer_Prev(&playlist->randomizer);
-        assert(selected == playlist->items.data[index]);
+        assert(selected == item_seq_Get(&playlist->items, index));
         VLC_UNUSED(selected);
     }
 
@@ -389,7 +396,7 @@ vlc_playlist_Next(vlc_playlist_t *playlist)
     {
         /* mark the item as selected in the randomizer */
         vlc_playlist_item_t *selected = randomizer_Next(&playlist->randomizer);
-        assert(selected == playlist->items.data[index]);
+        assert(selected == item_seq_Get(&playlist->items, index));
         VLC_UNUSED(selected);
     }
 
@@ -402,7 +409,7 @@ int
 vlc_playlist_GoTo(vlc_playlist_t *playlist, ssize_t index)
 {
     vlc_playlist_AssertLocked(playlist);
-    assert(index == -1 || (size_t) index < playlist->items.size);
+    assert(index == -1 || (size_t) index < item_seq_Size(&playlist->items));
 
     int ret = vlc_playlist_SetCurrentMedia(playlist, index);
     if (ret != VLC_SUCCESS)
@@ -410,7 +417,7 @@ vlc_playlist_GoTo(vlc_playlist_t *playlist, ssize_t index)
 
     if (index != -1 && playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
     {
-        vlc_playlist_item_t *item = playlist->items.data[index];
+        vlc_playlist_item_t *item = item_seq_Get(&playlist->items, index);
         randomizer_Select(&playlist->randomizer, item);
     }
 
@@ -444,7 +451,7 @@ vlc_playlist_UpdateNextMedia(vlc_playlist_t *playlist)
         {
             ssize_t index = vlc_playlist_GetNextMediaIndex(playlist);
             if (index != -1)
-                media = playlist->items.data[index]->media;
+                media = item_seq_Get(&playlist->items, index)->media;
             /* fall through */
         }
         case VLC_PLAYLIST_MEDIA_STOPPED_STOP:
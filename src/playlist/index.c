@@ -0,0 +1,231 @@
+/*****************************************************************************
+ * playlist/index.c
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "index.h"
+
+#include <assert.h>
+
+#include "item.h"
+
+/*
+ * Both tables are open-addressing hash tables with linear probing, kept at
+ * most half full. Removal shifts the following entries of the probe sequence
+ * backwards, so that there are no tombstones.
+ */
+
+#define ITEM_INDEX_MIN_SIZE 64
+
+static size_t
+Hash(const struct item_index_table *table, uint64_t key)
+{
+    /* Fibonacci hashing, keeping the well-mixed high bits */
+    uint64_t h = key * UINT64_C(0x9E3779B97F4A7C15);
+    return (h ^ (h >> 32)) & table->mask;
+}
+
+static void
+table_Init(struct item_index_table *table)
+{
+    table->slots = NULL;
+    table->mask = 0;
+    table->count = 0;
+}
+
+static void
+table_Destroy(struct item_index_table *table)
+{
+    free(table->slots);
+}
+
+static void
+table_Clear(struct item_index_table *table)
+{
+    table_Destroy(table);
+    table_Init(table);
+}
+
+static void
+table_InsertSlot(struct item_index_table *table, uint64_t key,
+                 vlc_playlist_item_t *item)
+{
+    size_t i = Hash(table, key);
+    while (table->slots[i].item)
+        i = (i + 1) & table->mask;
+
+    table->slots[i].key = key;
+    table->slots[i].item = item;
+    table->count++;
+}
+
+static bool
+table_Grow(struct item_index_table *table)
+{
+    size_t old_size = table->slots ? table->mask + 1 : 0;
+    size_t size = old_size ? old_size * 2 : ITEM_INDEX_MIN_SIZE;
+
+    struct item_index_slot *slots = calloc(size, sizeof(*slots));
+    if (unlikely(!slots))
+        return false;
+
+    struct item_index_slot *old = table->slots;
+    table->slots = slots;
+    table->mask = size - 1;
+    table->count = 0;
+
+    for (size_t i = 0; i < old_size; ++i)
+        if (old[i].item)
+            table_InsertSlot(table, old[i].key, old[i].item);
+    free(old);
+    return true;
+}
+
+static bool
+table_Add(struct item_index_table *table, uint64_t key,
+          vlc_playlist_item_t *item)
+{
+    if (!table->slots || (table->count + 1) * 2 > table->mask + 1)
+        if (!table_Grow(table))
+            return false;
+
+    table_InsertSlot(table, key, item);
+    return true;
+}
+
+static void
+table_Remove(struct item_index_table *table, uint64_t key,
+             vlc_playlist_item_t *item)
+{
+    assert(table->slots);
+
+    size_t i = Hash(table, key);
+    while (table->slots[i].item != item)
+    {
+        /* the item must be in the table */
+        assert(table->slots[i].item);
+        i = (i + 1) & table->mask;
+    }
+
+    /* shift back the following entries which may not stay after a hole */
+    for (size_t j = i;;)
+    {
+        j = (j + 1) & table->mask;
+        if (!table->slots[j].item)
+            break;
+
+        size_t k = Hash(table, table->slots[j].key);
+        bool stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+        if (!stays)
+        {
+            table->slots[i] = table->slots[j];
+            i = j;
+        }
+    }
+    table->slots[i].item = NULL;
+    table->count--;
+}
+
+static uint64_t
+MediaKey(const input_item_t *media)
+{
+    return (uintptr_t) media;
+}
+
+void
+item_index_Init(struct item_index *index)
+{
+    table_Init(&index->by_id);
+    table_Init(&index->by_media);
+    index->valid = 0;
+}
+
+void
+item_index_Destroy(struct item_index *index)
+{
+    table_Destroy(&index->by_id);
+    table_Destroy(&index->by_media);
+}
+
+void
+item_index_Clear(struct item_index *index)
+{
+    table_Clear(&index->by_id);
+    table_Clear(&index->by_media);
+    index->valid = 0;
+}
+
+bool
+item_index_Add(struct item_index *index, vlc_playlist_item_t *item)
+{
+    if (!table_Add(&index->by_id, item->id, item))
+        return false;
+    if (!table_Add(&index->by_media, MediaKey(item->media), item))
+    {
+        table_Remove(&index->by_id, item->id, item);
+        return false;
+    }
+    return true;
+}
+
+void
+item_index_Remove(struct item_index *index, vlc_playlist_item_t *item)
+{
+    table_Remove(&index->by_id, item->id, item);
+    table_Remove(&index->by_media, MediaKey(item->media), item);
+}
+
+vlc_playlist_item_t *
+item_index_FindId(struct item_index *index, uint64_t id)
+{
+    struct item_index_table *table = &index->by_id;
+    if (!table->slots)
+        return NULL;
+
+    for (size_t i = Hash(table, id); table->slots[i].item;
+         i = (i + 1) & table->mask)
+        if (table->slots[i].key == id)
+            return table->slots[i].item;
+    return NULL;
+}
+
+vlc_playlist_item_t *
+item_index_NextMedia(struct item_index *index, const input_item_t *media,
+                     size_t *cursor)
+{
+    struct item_index_table *table = &index->by_media;
+    if (!table->slots)
+        return NULL;
+
+    uint64_t key = MediaKey(media);
+    size_t home = Hash(table, key);
+    for (;;)
+    {
+        struct item_index_slot *slot =
+            &table->slots[(home + *cursor) & table->mask];
+        if (!slot->item)
+            return NULL;
+        ++*cursor;
+        if (slot->key == key)
+            return slot->item;
+    }
+}
@@ -0,0 +1,125 @@
+/*****************************************************************************
+ * playlist/index.h
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PLAYLIST_INDEX_H
+#define VLC_PLAYLIST_INDEX_H
+
+#include <vlc_common.h>
+
+typedef struct vlc_playlist_item vlc_playlist_item_t;
+typedef struct input_item_t input_item_t;
+
+/**
+ * \defgroup playlist_index Playlist item index
+ * \ingroup playlist
+ *  @{ */
+
+struct item_index_slot
+{
+    uint64_t key;
+    vlc_playlist_item_t *item; /**< NULL if the slot is empty */
+};
+
+struct item_index_table
+{
+    struct item_index_slot *slots;
+    size_t mask;
+    size_t count;
+};
+
+/**
+ * Playlist helper to find items from their id or their media in constant
+ * time.
+ *
+ * The position of each item is cached in the item itself. Since a single
+ * insertion or removal shifts all the following items, positions are not
+ * updated eagerly: only the first `valid` items are known to be at their
+ * cached position, the following ones are renumbered lazily on lookup.
+ */
+struct item_index
+{
+    struct item_index_table by_id;
+    struct item_index_table by_media; /**< several items may share a media */
+    size_t valid;
+};
+
+/**
+ * Initialize an empty index.
+ */
+void
+item_index_Init(struct item_index *index);
+
+/**
+ * Destroy an index.
+ */
+void
+item_index_Destroy(struct item_index *index);
+
+/**
+ * Remove all items from the index.
+ */
+void
+item_index_Clear(struct item_index *index);
+
+/**
+ * Add an item to the index.
+ *
+ * \return true on success, false on allocation failure
+ */
+bool
+item_index_Add(struct item_index *index, vlc_playlist_item_t *item);
+
+/**
+ * Remove an item from the index.
+ */
+void
+item_index_Remove(struct item_index *index, vlc_playlist_item_t *item);
+
+/**
+ * Find the item having the given id.
+ *
+ * \return the item, or NULL if not found
+ */
+vlc_playlist_item_t *
+item_index_FindId(struct item_index *index, uint64_t id);
+
+/**
+ * Iterate over the items having the given media, in no particular order.
+ *
+ * \param cursor an opaque cursor, initialized to 0 by the caller
+ * \return the next item, or NULL if there are no more
+ */
+vlc_playlist_item_t *
+item_index_NextMedia(struct item_index *index, const input_item_t *media,
+                     size_t *cursor);
+
+/**
+ * Declare that the positions of the items from \p from have changed.
+ */
+static inline void
+item_index_Invalidate(struct item_index *index, size_t from)
+{
+    if (index->valid > from)
+        index->valid = from;
+}
+
+/** @} */
+
+#endif
@@ -23,6 +23,7 @@
 #endif
 
 #include "item.h"
+#include "sort.h"
 
 #include <vlc_playlist.h>
 #include <vlc_input_item.h>
@@ -36,7 +37,10 @@ vlc_playlist_item_New(input_item_t *media, uint64_t id)
 
     vlc_atomic_rc_init(&item->rc);
     item->id = id;
+    item->index = 0;
     item->preparser_req = NULL;
+    item->sort_meta = NULL;
+    item->partially_expanded = 0;
     item->media = media;
     input_item_Hold(media);
     return item;
@@ -53,6 +57,8 @@ vlc_playlist_item_Release(vlc_playlist_item_t *item)
 {
     if (vlc_atomic_rc_dec(&item->rc))
     {
+        if (item->sort_meta)
+            vlc_playlist_item_meta_Delete(item->sort_meta);
         input_item_Release(item->media);
         free(item);
     }
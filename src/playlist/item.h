@@ -31,7 +31,11 @@ struct vlc_playlist_item
 {
     input_item_t *media;
     uint64_t id;
+    size_t index; /**< cached position, see struct item_index */
     vlc_preparser_req *preparser_req;
+    struct vlc_playlist_item_meta *sort_meta; /**< cached sort keys */
+    size_t partially_expanded; /**< number of items of its subtree inserted
+                                    before it */
     vlc_atomic_rc_t rc;
 };
 
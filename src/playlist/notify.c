@@ -26,13 +26,15 @@
 
 #include "item.h"
 #include "playlist.h"
+#include "sort.h"
 
 static void
 vlc_playlist_NotifyCurrentState(vlc_playlist_t *playlist,
-                                vlc_playlist_listener_id *listener)
+                                vlc_playlist_listener_id *listener,
+                                vlc_playlist_item_t *const items[])
 {
     vlc_playlist_NotifyListener(playlist, listener, on_items_reset,
-                                playlist->items.data, playlist->items.size);
+                                items, item_seq_Size(&playlist->items));
     vlc_playlist_NotifyListener(playlist, listener, on_playback_repeat_changed,
                                 playlist->repeat);
     vlc_playlist_NotifyListener(playlist, listener, on_playback_order_changed,
@@ -54,17 +56,30 @@ vlc_playlist_AddListener(vlc_playlist_t *playlist,
 {
     vlc_playlist_AssertLocked(playlist);
 
+    /* the items are not stored contiguously, the listener expects an array */
+    vlc_playlist_item_t **items = NULL;
+    if (notify_current_state && item_seq_Size(&playlist->items))
+    {
+        items = item_seq_Flatten(&playlist->items);
+        if (unlikely(!items))
+            return NULL;
+    }
+
     vlc_playlist_listener_id *listener = malloc(sizeof(*listener));
     if (unlikely(!listener))
+    {
+        free(items);
         return NULL;
+    }
 
     listener->cbs = cbs;
     listener->userdata = userdata;
     vlc_list_append(&listener->node, &playlist->listeners);
 
     if (notify_current_state)
-        vlc_playlist_NotifyCurrentState(playlist, listener);
+        vlc_playlist_NotifyCurrentState(playlist, listener, items);
 
+    free(items);
     return listener;
 }
 
@@ -115,13 +130,15 @@ void
 vlc_playlist_NotifyMediaUpdated(vlc_playlist_t *playlist, input_item_t *media)
 {
     vlc_playlist_AssertLocked(playlist);
+    vlc_playlist_InvalidateSortKeys(playlist, media);
     if (!vlc_playlist_HasItemUpdatedListeners(playlist))
         /* no need to find the index if there are no listeners */
         return;
 
     ssize_t index;
     if (playlist->current != -1 &&
-            playlist->items.data[playlist->current]->media == media)
+            item_seq_Get(&playlist->items, playlist->current)->media
+                == media)
         /* the player typically sends events for the current item, so we can
          * often avoid to search */
         index = playlist->current;
@@ -133,5 +150,5 @@ vlc_playlist_NotifyMediaUpdated(vlc_playlist_t *playlist, input_item_t *media)
             return;
     }
     vlc_playlist_Notify(playlist, on_items_updated, index,
-                        &playlist->items.data[index], 1);
+                        item_seq_Ref(&playlist->items, index), 1);
 }
@@ -44,7 +44,8 @@ player_on_current_media_changed(vlc_player_t *player, input_item_t *new_media,
     vlc_playlist_AssertLocked(playlist);
 
     input_item_t *media = playlist->current != -1
-                        ? playlist->items.data[playlist->current]->media
+                        ? item_seq_Get(&playlist->items,
+                                       playlist->current)->media
                         : NULL;
     if (new_media == media)
     {
@@ -58,7 +59,7 @@ player_on_current_media_changed(vlc_player_t *player, input_item_t *new_media,
         index = vlc_playlist_IndexOfMedia(playlist, new_media);
         if (index != -1)
         {
-            vlc_playlist_item_t *item = playlist->items.data[index];
+            vlc_playlist_item_t *item = item_seq_Get(&playlist->items, index);
             if (playlist->order == VLC_PLAYLIST_PLAYBACK_ORDER_RANDOM)
                 randomizer_Select(&playlist->randomizer, item);
         }
@@ -127,7 +128,7 @@ on_player_media_subitems_changed(vlc_player_t *player, input_item_t *media,
     VLC_UNUSED(player);
     VLC_UNUSED(media);
     vlc_playlist_t *playlist = userdata;
-    vlc_playlist_ExpandItemFromNode(playlist, subitems);
+    vlc_playlist_ExpandItemFromFullNode(playlist, subitems);
 }
 
 static const struct vlc_player_cbs player_callbacks = {
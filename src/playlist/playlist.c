@@ -66,7 +66,8 @@ vlc_playlist_New(vlc_object_t *parent, enum vlc_playlist_preparsing rec,
     }
     playlist->stopped_action = VLC_PLAYLIST_MEDIA_STOPPED_CONTINUE;
 
-    vlc_vector_init(&playlist->items);
+    item_seq_Init(&playlist->items);
+    item_index_Init(&playlist->item_index);
     randomizer_Init(&playlist->randomizer);
     playlist->current = -1;
     playlist->has_prev = false;
@@ -75,6 +76,8 @@ vlc_playlist_New(vlc_object_t *parent, enum vlc_playlist_preparsing rec,
     playlist->repeat = VLC_PLAYLIST_PLAYBACK_REPEAT_NONE;
     playlist->order = VLC_PLAYLIST_PLAYBACK_ORDER_NORMAL;
     playlist->idgen = 0;
+    playlist->sorted_by = NULL;
+    playlist->sorted_by_count = 0;
 
     return playlist;
 }
@@ -91,6 +94,9 @@ vlc_playlist_Delete(vlc_playlist_t *playlist)
     vlc_playlist_PlayerDestroy(playlist);
     randomizer_Destroy(&playlist->randomizer);
     vlc_playlist_ClearItems(playlist);
+    item_seq_Destroy(&playlist->items);
+    item_index_Destroy(&playlist->item_index);
+    free(playlist->sorted_by);
     free(playlist);
 }
 
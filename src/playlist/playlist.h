@@ -26,7 +26,9 @@
 #include <vlc_preparser.h>
 #include <vlc_vector.h>
 #include "../player/player.h"
+#include "index.h"
 #include "randomizer.h"
+#include "sequence.h"
 
 typedef struct input_item_t input_item_t;
 
@@ -43,8 +45,6 @@ typedef struct input_item_t input_item_t;
 # define vlc_player_osd_Message(p, fmt...) VLC_UNUSED(p)
 #endif /* TEST_PLAYLIST */
 
-typedef struct VLC_VECTOR(vlc_playlist_item_t *) playlist_item_vector_t;
-
 struct vlc_playlist
 {
     vlc_player_t *player;
@@ -54,7 +54,8 @@ struct vlc_playlist
     enum vlc_playlist_preparsing recursive;
     /* all remaining fields are protected by the lock of the player */
     struct vlc_player_listener_id *player_listener;
-    playlist_item_vector_t items;
+    struct item_seq items;
+    struct item_index item_index;
     struct randomizer randomizer;
     ssize_t current;
     bool has_prev;
@@ -63,6 +64,9 @@ struct vlc_playlist
     enum vlc_playlist_playback_repeat repeat;
     enum vlc_playlist_playback_order order;
     uint64_t idgen;
+    /* criteria of the last sort, if the items have not been reordered since */
+    struct vlc_playlist_sort_criterion *sorted_by;
+    size_t sorted_by_count;
 };
 
 /* Also disable vlc_assert_locked in tests since the symbol is not exported */
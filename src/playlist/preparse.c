@@ -28,6 +28,7 @@
 #include "item.h"
 #include "playlist.h"
 #include "notify.h"
+#include "sort.h"
 
 typedef struct VLC_VECTOR(input_item_t *) media_vector_t;
 
@@ -75,6 +76,79 @@ vlc_playlist_ExpandItemFromNode(vlc_playlist_t *playlist,
     return vlc_playlist_ExpandItem(playlist, index, subitems);
 }
 
+int
+vlc_playlist_ExpandItemFromFullNode(vlc_playlist_t *playlist,
+                                    const input_item_node_t *subitems)
+{
+    vlc_playlist_AssertLocked(playlist);
+    input_item_t *media = subitems->p_item;
+    ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
+    if (index == -1)
+        return VLC_ENOENT;
+
+    vlc_playlist_item_t *item = item_seq_Get(&playlist->items, index);
+
+    media_vector_t flatten = VLC_VECTOR_INITIALIZER;
+    vlc_playlist_CollectChildren(playlist, &flatten, subitems);
+
+    /* the first items of the subtree may already be inserted before it */
+    size_t skip = item->partially_expanded;
+    if (skip > flatten.size)
+        skip = flatten.size;
+
+    int ret = vlc_playlist_Expand(playlist, index, flatten.data + skip,
+                                  flatten.size - skip);
+    vlc_vector_destroy(&flatten);
+
+    return ret;
+}
+
+int
+vlc_playlist_ExpandItemPartially(vlc_playlist_t *playlist, size_t index,
+                                 const input_item_node_t *node)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    media_vector_t flatten = VLC_VECTOR_INITIALIZER;
+    vlc_playlist_CollectChildren(playlist, &flatten, node);
+
+    int ret = vlc_playlist_ExpandPartially(playlist, index, flatten.data,
+                                           flatten.size);
+    vlc_vector_destroy(&flatten);
+
+    return ret;
+}
+
+int
+vlc_playlist_ExpandItemPartiallyFromNode(vlc_playlist_t *playlist,
+                                         const input_item_node_t *subitems)
+{
+    vlc_playlist_AssertLocked(playlist);
+    input_item_t *media = subitems->p_item;
+    ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
+    if (index == -1)
+        return VLC_ENOENT;
+
+    return vlc_playlist_ExpandItemPartially(playlist, index, subitems);
+}
+
+int
+vlc_playlist_FinishPartialExpansion(vlc_playlist_t *playlist,
+                                    input_item_t *media)
+{
+    vlc_playlist_AssertLocked(playlist);
+    ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
+    if (index == -1)
+        return VLC_ENOENT;
+
+    vlc_playlist_item_t *item = item_seq_Get(&playlist->items, index);
+    if (!item->partially_expanded)
+        return VLC_SUCCESS;
+
+    /* the parts already inserted replace the item */
+    return vlc_playlist_Expand(playlist, index, NULL, 0);
+}
+
 static void
 on_subtree_added(vlc_preparser_req *req, input_item_node_t *subtree,
                  void *userdata)
@@ -88,20 +162,47 @@ on_subtree_added(vlc_preparser_req *req, input_item_node_t *subtree,
     input_item_node_Delete(subtree);
 }
 
+static void
+on_partial_subtree_added(vlc_preparser_req *req, input_item_node_t *subtree,
+                         void *userdata)
+{
+    VLC_UNUSED(req); /* retrieved by subtree->p_item */
+    vlc_playlist_t *playlist = userdata;
+
+    vlc_playlist_Lock(playlist);
+    vlc_playlist_ExpandItemPartiallyFromNode(playlist, subtree);
+    vlc_playlist_Unlock(playlist);
+    input_item_node_Delete(subtree);
+}
+
 static void
 on_preparse_ended(vlc_preparser_req *req, int status, void *userdata)
 {
     input_item_t *media = vlc_preparser_req_GetItem(req);
     vlc_playlist_t *playlist = userdata;
 
+    if (status == -EINTR)
+        /* The request is only canceled when its item is removed (possibly
+         * synchronously, with the playlist locked): there is nothing left to
+         * expand. */
+        return;
+
     if (status != VLC_SUCCESS)
+    {
+        /* The parts of the subtree received before a failure or a timeout
+         * must not be inserted again by a later expansion */
+        vlc_playlist_Lock(playlist);
+        vlc_playlist_FinishPartialExpansion(playlist, media);
+        vlc_playlist_Unlock(playlist);
         return;
+    }
 
     vlc_playlist_Lock(playlist);
+    vlc_playlist_InvalidateSortKeys(playlist, media);
     ssize_t index = vlc_playlist_IndexOfMedia(playlist, media);
     if (index != -1)
         vlc_playlist_Notify(playlist, on_items_updated, index,
-                            &playlist->items.data[index], 1);
+                            item_seq_Ref(&playlist->items, index), 1);
     vlc_playlist_Unlock(playlist);
     vlc_preparser_req_Release(req);
 }
@@ -109,6 +210,7 @@ on_preparse_ended(vlc_preparser_req *req, int status, void *userdata)
 static const struct vlc_preparser_cbs preparser_callbacks = {
     .on_ended = on_preparse_ended,
     .on_subtree_added = on_subtree_added,
+    .on_partial_subtree_added = on_partial_subtree_added,
 };
 
 vlc_preparser_req *
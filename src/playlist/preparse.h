@@ -39,4 +39,39 @@ int
 vlc_playlist_ExpandItemFromNode(vlc_playlist_t *playlist,
                                 const input_item_node_t *subitems);
 
+/**
+ * Expand an item from its whole subtree.
+ *
+ * Unlike vlc_playlist_ExpandItemFromNode(), the subtree also contains the
+ * parts already inserted by a partial expansion (when the item is played
+ * while it is being preparsed), which are not inserted again.
+ */
+int
+vlc_playlist_ExpandItemFromFullNode(vlc_playlist_t *playlist,
+                                    const input_item_node_t *subitems);
+
+/**
+ * Insert the first part of the subtree of an item, before the item itself.
+ *
+ * The item is kept until its last part is received, and expanded by
+ * vlc_playlist_ExpandItem().
+ */
+int
+vlc_playlist_ExpandItemPartially(vlc_playlist_t *playlist, size_t index,
+                                 const input_item_node_t *node);
+
+int
+vlc_playlist_ExpandItemPartiallyFromNode(vlc_playlist_t *playlist,
+                                         const input_item_node_t *subitems);
+
+/**
+ * Finish the expansion of an item with the parts already received.
+ *
+ * If parts of its subtree were inserted, the item is removed, as if its last
+ * part were empty. Called when its preparsing fails or times out.
+ */
+int
+vlc_playlist_FinishPartialExpansion(vlc_playlist_t *playlist,
+                                    input_item_t *media);
+
 #endif
@@ -0,0 +1,448 @@
+/*****************************************************************************
+ * playlist/sequence.c
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "sequence.h"
+
+#include <assert.h>
+
+/*
+ * The items are split into chunks of at most ITEM_CHUNK_MAX items, and
+ * 'starts' stores the position of the first item of each chunk, so that an
+ * item is located by a binary search on the chunks.
+ *
+ * An insertion which does not fit in its chunk redistributes the chunk and
+ * the new items evenly over new chunks, which are therefore at least half
+ * full. A removal frees the chunks it empties, and merges the chunks around
+ * the removed slice if they fit in one.
+ *
+ * For a playlist of n items, an insertion or a removal costs
+ * O(ITEM_CHUNK_MAX + n / ITEM_CHUNK_MAX) instead of O(n), and a random access
+ * costs O(log(n / ITEM_CHUNK_MAX)). Sequential access, which is the common
+ * case, does not need a search.
+ */
+
+#define ITEM_CHUNK_MAX 512
+
+struct item_chunk
+{
+    size_t size;
+    struct item_chunk *next; /**< next spare chunk */
+    vlc_playlist_item_t *items[ITEM_CHUNK_MAX];
+};
+
+void
+item_seq_Init(struct item_seq *seq)
+{
+    seq->chunks = NULL;
+    seq->starts = NULL;
+    seq->count = 0;
+    seq->alloc = 0;
+    seq->size = 0;
+    seq->last = 0;
+    seq->spare = NULL;
+    seq->spares = 0;
+}
+
+void
+item_seq_Destroy(struct item_seq *seq)
+{
+    for (size_t i = 0; i < seq->count; ++i)
+        free(seq->chunks[i]);
+    while (seq->spare)
+    {
+        struct item_chunk *chunk = seq->spare;
+        seq->spare = chunk->next;
+        free(chunk);
+    }
+    free(seq->chunks);
+    free(seq->starts);
+}
+
+void
+item_seq_Clear(struct item_seq *seq)
+{
+    item_seq_Destroy(seq);
+    item_seq_Init(seq);
+}
+
+/**
+ * Make sure that `extra` chunks can be added without allocation.
+ */
+static bool
+item_seq_Reserve(struct item_seq *seq, size_t extra)
+{
+    if (seq->count + extra > seq->alloc)
+    {
+        size_t alloc = seq->alloc ? seq->alloc : 8;
+        while (alloc < seq->count + extra)
+            alloc *= 2;
+
+        struct item_chunk **chunks =
+            vlc_reallocarray(seq->chunks, alloc, sizeof(*chunks));
+        if (unlikely(!chunks))
+            return false;
+        seq->chunks = chunks;
+
+        size_t *starts = vlc_reallocarray(seq->starts, alloc, sizeof(*starts));
+        if (unlikely(!starts))
+            return false;
+        seq->starts = starts;
+
+        seq->alloc = alloc;
+    }
+
+    while (seq->spares < extra)
+    {
+        struct item_chunk *chunk = malloc(sizeof(*chunk));
+        if (unlikely(!chunk))
+            return false;
+        chunk->next = seq->spare;
+        seq->spare = chunk;
+        seq->spares++;
+    }
+    return true;
+}
+
+static struct item_chunk *
+item_seq_TakeSpare(struct item_seq *seq)
+{
+    struct item_chunk *chunk = seq->spare;
+    assert(chunk);
+    seq->spare = chunk->next;
+    seq->spares--;
+    chunk->size = 0;
+    return chunk;
+}
+
+static void
+item_seq_UpdateStarts(struct item_seq *seq, size_t from)
+{
+    for (size_t i = from; i < seq->count; ++i)
+        seq->starts[i] = i ? seq->starts[i - 1] + seq->chunks[i - 1]->size
+                           : 0;
+}
+
+static bool
+item_seq_InChunk(const struct item_seq *seq, size_t chunk, size_t index)
+{
+    return chunk < seq->count && index >= seq->starts[chunk]
+        && index - seq->starts[chunk] < seq->chunks[chunk]->size;
+}
+
+/**
+ * Return the chunk containing the item at the given position.
+ */
+static size_t
+item_seq_Locate(struct item_seq *seq, size_t index)
+{
+    assert(index < seq->size);
+
+    size_t last = seq->last;
+    if (item_seq_InChunk(seq, last, index))
+        return last;
+    if (item_seq_InChunk(seq, last + 1, index))
+        return seq->last = last + 1;
+
+    /* find the last chunk starting before index */
+    size_t lo = 0;
+    size_t hi = seq->count;
+    while (hi - lo > 1)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (seq->starts[mid] <= index)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return seq->last = lo;
+}
+
+vlc_playlist_item_t **
+item_seq_Ref(struct item_seq *seq, size_t index)
+{
+    size_t c = item_seq_Locate(seq, index);
+    return &seq->chunks[c]->items[index - seq->starts[c]];
+}
+
+vlc_playlist_item_t **
+item_seq_Run(struct item_seq *seq, size_t index, size_t *count)
+{
+    size_t c = item_seq_Locate(seq, index);
+    struct item_chunk *chunk = seq->chunks[c];
+    size_t offset = index - seq->starts[c];
+    if (*count > chunk->size - offset)
+        *count = chunk->size - offset;
+    return &chunk->items[offset];
+}
+
+void
+item_seq_Read(struct item_seq *seq, size_t index, size_t count,
+              vlc_playlist_item_t *out[])
+{
+    assert(index + count <= seq->size);
+    while (count)
+    {
+        size_t n = count;
+        vlc_playlist_item_t **run = item_seq_Run(seq, index, &n);
+        memcpy(out, run, n * sizeof(*out));
+        out += n;
+        index += n;
+        count -= n;
+    }
+}
+
+void
+item_seq_Write(struct item_seq *seq, size_t index, size_t count,
+               vlc_playlist_item_t *const items[])
+{
+    assert(index + count <= seq->size);
+    while (count)
+    {
+        size_t n = count;
+        vlc_playlist_item_t **run = item_seq_Run(seq, index, &n);
+        memcpy(run, items, n * sizeof(*items));
+        items += n;
+        index += n;
+        count -= n;
+    }
+}
+
+vlc_playlist_item_t **
+item_seq_Flatten(struct item_seq *seq)
+{
+    if (!seq->size)
+        return NULL;
+
+    vlc_playlist_item_t **array = vlc_alloc(seq->size, sizeof(*array));
+    if (likely(array))
+        item_seq_Read(seq, 0, seq->size, array);
+    return array;
+}
+
+bool
+item_seq_Insert(struct item_seq *seq, size_t index,
+                vlc_playlist_item_t *const items[], size_t count)
+{
+    assert(index <= seq->size);
+    if (!count)
+        return true;
+
+    /* the chunk to insert into, and the position of the insertion in it */
+    size_t c;
+    size_t offset;
+    if (index < seq->size)
+    {
+        c = item_seq_Locate(seq, index);
+        offset = index - seq->starts[c];
+    }
+    else if (seq->count)
+    {
+        c = seq->count - 1;
+        offset = seq->chunks[c]->size;
+    }
+    else
+    {
+        c = 0;
+        offset = 0;
+    }
+
+    size_t size = seq->count ? seq->chunks[c]->size : 0;
+    size_t total = size + count;
+    size_t n = (total + ITEM_CHUNK_MAX - 1) / ITEM_CHUNK_MAX;
+    /* an empty sequence needs one more chunk to insert into */
+    size_t extra = seq->count ? n - 1 : n;
+    if (!item_seq_Reserve(seq, extra))
+        return false;
+
+    if (!seq->count)
+    {
+        seq->chunks[0] = item_seq_TakeSpare(seq);
+        seq->count = 1;
+    }
+
+    struct item_chunk *chunk = seq->chunks[c];
+    if (n == 1)
+    {
+        memmove(&chunk->items[offset + count], &chunk->items[offset],
+                (size - offset) * sizeof(*items));
+        memcpy(&chunk->items[offset], items, count * sizeof(*items));
+        chunk->size = total;
+    }
+    else
+    {
+        /*
+         * Conceptually, the content is chunk[0..offset) + items +
+         * chunk[offset..size), redistributed evenly over n chunks. The new
+         * chunks are filled first, while the original chunk is intact.
+         */
+#define SOURCE(p) ((p) < offset ? chunk->items[p] \
+                 : (p) < offset + count ? items[(p) - offset] \
+                 : chunk->items[(p) - count])
+        size_t base = total / n;
+        size_t rem = total % n;
+        size_t first = base + (rem != 0);
+
+        memmove(&seq->chunks[c + n], &seq->chunks[c + 1],
+                (seq->count - c - 1) * sizeof(*seq->chunks));
+
+        size_t p = first;
+        for (size_t i = 1; i < n; ++i)
+        {
+            struct item_chunk *dst = item_seq_TakeSpare(seq);
+            dst->size = base + (i < rem);
+            for (size_t j = 0; j < dst->size; ++j, ++p)
+                dst->items[j] = SOURCE(p);
+            seq->chunks[c + i] = dst;
+        }
+        assert(p == total);
+
+        /* the first chunk keeps its first items, the tail may be shifted
+         * forward within the chunk, so copy backwards */
+        for (size_t q = first; q-- > offset;)
+            chunk->items[q] = SOURCE(q);
+        chunk->size = first;
+#undef SOURCE
+
+        seq->count += n - 1;
+    }
+
+    seq->size += count;
+    item_seq_UpdateStarts(seq, c);
+    return true;
+}
+
+static void
+item_seq_Merge(struct item_seq *seq, size_t c)
+{
+    /* merge chunk c + 1 into chunk c if they fit */
+    if (c + 1 >= seq->count)
+        return;
+
+    struct item_chunk *dst = seq->chunks[c];
+    struct item_chunk *src = seq->chunks[c + 1];
+    if (dst->size + src->size > ITEM_CHUNK_MAX)
+        return;
+
+    memcpy(&dst->items[dst->size], src->items, src->size * sizeof(*src->items));
+    dst->size += src->size;
+    free(src);
+
+    memmove(&seq->chunks[c + 1], &seq->chunks[c + 2],
+            (seq->count - c - 2) * sizeof(*seq->chunks));
+    seq->count--;
+}
+
+void
+item_seq_Remove(struct item_seq *seq, size_t index, size_t count)
+{
+    assert(index + count <= seq->size);
+    if (!count)
+        return;
+
+    size_t first = item_seq_Locate(seq, index);
+    size_t offset = index - seq->starts[first];
+    size_t c = first;
+    for (size_t remaining = count; remaining; ++c, offset = 0)
+    {
+        struct item_chunk *chunk = seq->chunks[c];
+        size_t n = chunk->size - offset;
+        if (n > remaining)
+            n = remaining;
+        memmove(&chunk->items[offset], &chunk->items[offset + n],
+                (chunk->size - offset - n) * sizeof(*chunk->items));
+        chunk->size -= n;
+        remaining -= n;
+    }
+
+    /* drop the chunks which have been emptied */
+    size_t w = first;
+    for (size_t i = first; i < c; ++i)
+    {
+        if (seq->chunks[i]->size)
+            seq->chunks[w++] = seq->chunks[i];
+        else
+            free(seq->chunks[i]);
+    }
+    memmove(&seq->chunks[w], &seq->chunks[c],
+            (seq->count - c) * sizeof(*seq->chunks));
+    seq->count -= c - w;
+    seq->size -= count;
+
+    /* the chunks around the removed slice may now fit in one */
+    size_t from = first ? first - 1 : 0;
+    for (size_t i = w + 1; i-- > from;)
+        item_seq_Merge(seq, i);
+
+    seq->last = from;
+    item_seq_UpdateStarts(seq, from);
+}
+
+static void
+item_seq_Reverse(struct item_seq *seq, size_t lo, size_t hi)
+{
+    while (lo + 1 < hi)
+    {
+        vlc_playlist_item_t **a = item_seq_Ref(seq, lo++);
+        vlc_playlist_item_t **b = item_seq_Ref(seq, --hi);
+        vlc_playlist_item_t *tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+}
+
+void
+item_seq_Move(struct item_seq *seq, size_t index, size_t count, size_t target)
+{
+    assert(index + count <= seq->size);
+    assert(target + count <= seq->size);
+    if (index == target || !count)
+        return;
+
+    size_t lo = index < target ? index : target;
+    size_t hi = (index < target ? target : index) + count;
+    if (hi - lo > 2 * ITEM_CHUNK_MAX)
+    {
+        /* the insertion needs at most one chunk more than its items, plus
+         * one if the removal empties the sequence */
+        size_t extra = (count + ITEM_CHUNK_MAX - 1) / ITEM_CHUNK_MAX + 2;
+        vlc_playlist_item_t **slice = vlc_alloc(count, sizeof(*slice));
+        if (likely(slice) && item_seq_Reserve(seq, extra))
+        {
+            item_seq_Read(seq, index, count, slice);
+            item_seq_Remove(seq, index, count);
+            bool ok = item_seq_Insert(seq, target, slice, count);
+            assert(ok); VLC_UNUSED(ok);
+            free(slice);
+            return;
+        }
+        free(slice);
+        /* fallback to the in-place rotation */
+    }
+
+    /* rotate [lo, hi) by reversals, no allocation needed */
+    size_t mid = index < target ? index + count : index;
+    item_seq_Reverse(seq, lo, mid);
+    item_seq_Reverse(seq, mid, hi);
+    item_seq_Reverse(seq, lo, hi);
+}
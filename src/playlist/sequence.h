@@ -0,0 +1,149 @@
+/*****************************************************************************
+ * playlist/sequence.h
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PLAYLIST_SEQUENCE_H
+#define VLC_PLAYLIST_SEQUENCE_H
+
+#include <vlc_common.h>
+
+typedef struct vlc_playlist_item vlc_playlist_item_t;
+
+/**
+ * \defgroup playlist_sequence Playlist item sequence
+ * \ingroup playlist
+ *  @{ */
+
+struct item_chunk;
+
+/**
+ * Sequence of playlist items, stored in bounded chunks.
+ *
+ * Inserting or removing items only shifts the items of the chunk where the
+ * change happens, and the (much smaller) array of chunks, instead of all the
+ * following items.
+ *
+ * See sequence.c for implementation details.
+ */
+struct item_seq
+{
+    struct item_chunk **chunks;
+    size_t *starts; /**< position of the first item of each chunk */
+    size_t count; /**< number of chunks */
+    size_t alloc; /**< allocated size of chunks and starts */
+    size_t size; /**< number of items */
+    size_t last; /**< last chunk accessed, to speed up sequential access */
+    struct item_chunk *spare; /**< preallocated chunks */
+    size_t spares; /**< number of preallocated chunks */
+};
+
+/**
+ * Initialize an empty sequence.
+ */
+void
+item_seq_Init(struct item_seq *seq);
+
+/**
+ * Destroy a sequence (the items are not released).
+ */
+void
+item_seq_Destroy(struct item_seq *seq);
+
+/**
+ * Remove all items (the items are not released).
+ */
+void
+item_seq_Clear(struct item_seq *seq);
+
+static inline size_t
+item_seq_Size(const struct item_seq *seq)
+{
+    return seq->size;
+}
+
+/**
+ * Return a pointer to the slot of the item at the given position.
+ */
+vlc_playlist_item_t **
+item_seq_Ref(struct item_seq *seq, size_t index);
+
+static inline vlc_playlist_item_t *
+item_seq_Get(struct item_seq *seq, size_t index)
+{
+    return *item_seq_Ref(seq, index);
+}
+
+/**
+ * Return the contiguous run of items starting at the given position.
+ *
+ * This allows to iterate over the items without a lookup per item.
+ *
+ * \param count the maximum number of items, updated to the length of the run
+ */
+vlc_playlist_item_t **
+item_seq_Run(struct item_seq *seq, size_t index, size_t *count);
+
+/**
+ * Copy items to a flat array.
+ */
+void
+item_seq_Read(struct item_seq *seq, size_t index, size_t count,
+              vlc_playlist_item_t *out[]);
+
+/**
+ * Overwrite items with the content of a flat array.
+ */
+void
+item_seq_Write(struct item_seq *seq, size_t index, size_t count,
+               vlc_playlist_item_t *const items[]);
+
+/**
+ * Copy all the items to a new flat array (NULL if empty or on error).
+ */
+vlc_playlist_item_t **
+item_seq_Flatten(struct item_seq *seq);
+
+/**
+ * Insert items at the given position.
+ *
+ * \return true on success, false on allocation failure (the sequence is left
+ *         unchanged)
+ */
+bool
+item_seq_Insert(struct item_seq *seq, size_t index,
+                vlc_playlist_item_t *const items[], size_t count);
+
+/**
+ * Remove items (they are not released).
+ */
+void
+item_seq_Remove(struct item_seq *seq, size_t index, size_t count);
+
+/**
+ * Move a slice of items so that it starts at target.
+ *
+ * Same semantics as vlc_vector_move_slice().
+ */
+void
+item_seq_Move(struct item_seq *seq, size_t index, size_t count,
+              size_t target);
+
+/** @} */
+
+#endif
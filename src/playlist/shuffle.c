@@ -28,17 +28,23 @@
 #include "item.h"
 #include "notify.h"
 #include "playlist.h"
+#include "sort.h"
 
 void
 vlc_playlist_Shuffle(vlc_playlist_t *playlist)
 {
     vlc_playlist_AssertLocked(playlist);
-    if (playlist->items.size < 2)
+    if (item_seq_Size(&playlist->items) < 2)
         /* we use size_t (unsigned), so the following loop would be incorrect */
         return;
 
+    size_t size = item_seq_Size(&playlist->items);
+    vlc_playlist_item_t **items = item_seq_Flatten(&playlist->items);
+    if (unlikely(!items))
+        return;
+
     vlc_playlist_item_t *current = playlist->current != -1
-                                 ? playlist->items.data[playlist->current]
+                                 ? items[playlist->current]
                                  : NULL;
 
     /* initialize separately instead of using vlc_lrand48() to avoid locking the
@@ -47,15 +53,18 @@ vlc_playlist_Shuffle(vlc_playlist_t *playlist)
     vlc_rand_bytes(xsubi, sizeof(xsubi));
 
     /* Fisher-Yates shuffle */
-    for (size_t i = playlist->items.size - 1; i != 0; --i)
+    for (size_t i = size - 1; i != 0; --i)
     {
         size_t selected = (size_t) (nrand48(xsubi) % (i + 1));
 
         /* swap items i and selected */
-        vlc_playlist_item_t *tmp = playlist->items.data[i];
-        playlist->items.data[i] = playlist->items.data[selected];
-        playlist->items.data[selected] = tmp;
+        vlc_playlist_item_t *tmp = items[i];
+        items[i] = items[selected];
+        items[selected] = tmp;
     }
+    item_seq_Write(&playlist->items, 0, size, items);
+    item_index_Invalidate(&playlist->item_index, 0);
+    vlc_playlist_ForgetSortOrder(playlist);
 
     struct vlc_playlist_state state;
     if (current)
@@ -67,8 +76,9 @@ vlc_playlist_Shuffle(vlc_playlist_t *playlist)
         playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
     }
 
-    vlc_playlist_Notify(playlist, on_items_reset, playlist->items.data,
-                        playlist->items.size);
+    vlc_playlist_Notify(playlist, on_items_reset, items, size);
     if (current)
         vlc_playlist_state_NotifyChanges(playlist, &state);
+
+    free(items);
 }
@@ -30,18 +30,32 @@
 #include "item.h"
 #include "notify.h"
 #include "playlist.h"
+#include "sort.h"
+
+#ifdef HAVE_STRCOLL
+/* collation keys compare as the strings compare with strcoll() */
+# define CollationCompare strcmp
+#else
+# define CollationCompare strcasecmp
+#endif
 
 /**
  * Struct containing a copy of (parsed) media metadata, used for sorting
  * without locking all the items.
+ *
+ * It is cached in the item: the fields of a sort key are initialized the
+ * first time the item is sorted by this key, and kept until the media is
+ * updated.
  */
 struct vlc_playlist_item_meta {
-    vlc_playlist_item_t *item;
-    size_t index;
+    unsigned revision; /**< media revision the fields were read from */
+    unsigned keys; /**< bitmask of the initialized sort keys */
     const char *title_or_name;
+    const char *title_or_name_key; /**< collation key */
     vlc_tick_t duration;
     const char *artist;
     const char *album;
+    const char *album_key; /**< collation key */
     const char *album_artist;
     const char *genre;
     const char *url;
@@ -71,6 +85,27 @@ vlc_playlist_item_meta_CopyString(const char **to, const char *from)
     return VLC_SUCCESS;
 }
 
+static int
+vlc_playlist_item_meta_CopyCollationKey(const char **to, const char *from)
+{
+#ifdef HAVE_STRCOLL
+    if (from)
+    {
+        size_t size = strxfrm(NULL, from, 0) + 1;
+        char *key = malloc(size);
+        if (unlikely(!key))
+            return VLC_ENOMEM;
+        strxfrm(key, from, size);
+        *to = key;
+    }
+    else
+        *to = NULL;
+    return VLC_SUCCESS;
+#else
+    return vlc_playlist_item_meta_CopyString(to, from);
+#endif
+}
+
 static int
 vlc_playlist_item_meta_GetNumber(const char * str, int64_t * to)
 {
@@ -96,9 +131,9 @@ vlc_playlist_item_meta_GetNumber(const char * str, int64_t * to)
 
 static int
 vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
+                                 input_item_t *media,
                                  enum vlc_playlist_sort_key key)
 {
-    input_item_t *media = meta->item->media;
     switch (key)
     {
         case VLC_PLAYLIST_SORT_KEY_TITLE:
@@ -106,8 +141,12 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Title);
             if (EMPTY_STR(value))
                 value = media->psz_name;
-            return vlc_playlist_item_meta_CopyString(&meta->title_or_name,
-                                                     value);
+            int ret = vlc_playlist_item_meta_CopyString(&meta->title_or_name,
+                                                        value);
+            if (ret != VLC_SUCCESS)
+                return ret;
+            return vlc_playlist_item_meta_CopyCollationKey(
+                                    &meta->title_or_name_key, value);
         }
         case VLC_PLAYLIST_SORT_KEY_DURATION:
         {
@@ -127,7 +166,11 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
         case VLC_PLAYLIST_SORT_KEY_ALBUM:
         {
             const char *value = input_item_GetMetaLocked(media, vlc_meta_Album);
-            return vlc_playlist_item_meta_CopyString(&meta->album, value);
+            int ret = vlc_playlist_item_meta_CopyString(&meta->album, value);
+            if (ret != VLC_SUCCESS)
+                return ret;
+            return vlc_playlist_item_meta_CopyCollationKey(&meta->album_key,
+                                                           value);
         }
         case VLC_PLAYLIST_SORT_KEY_ALBUM_ARTIST:
         {
@@ -212,65 +255,127 @@ vlc_playlist_item_meta_InitField(struct vlc_playlist_item_meta *meta,
     }
 }
 
-static void
-vlc_playlist_item_meta_DestroyFields(struct vlc_playlist_item_meta *meta)
+void
+vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta)
 {
     free((void *) meta->title_or_name);
+    free((void *) meta->title_or_name_key);
     free((void *) meta->artist);
     free((void *) meta->album);
+    free((void *) meta->album_key);
     free((void *) meta->album_artist);
     free((void *) meta->genre);
     free((void *) meta->url);
+    free(meta);
 }
 
 static int
 vlc_playlist_item_meta_InitFields(struct vlc_playlist_item_meta *meta,
+        input_item_t *media,
         const struct vlc_playlist_sort_criterion criteria[], size_t count)
 {
     for (size_t i = 0; i < count; ++i)
     {
-        const struct vlc_playlist_sort_criterion *criterion = &criteria[i];
-        int ret = vlc_playlist_item_meta_InitField(meta, criterion->key);
+        enum vlc_playlist_sort_key key = criteria[i].key;
+        if (meta->keys & (1u << key))
+            continue;
+
+        int ret = vlc_playlist_item_meta_InitField(meta, media, key);
         if (unlikely(ret != VLC_SUCCESS))
-        {
-            vlc_playlist_item_meta_DestroyFields(meta);
             return ret;
-        }
+        meta->keys |= 1u << key;
     }
     return VLC_SUCCESS;
 }
 
-static struct vlc_playlist_item_meta *
-vlc_playlist_item_meta_New(size_t index, vlc_playlist_item_t *item,
-                           const struct vlc_playlist_sort_criterion criteria[],
-                           size_t count)
+static bool
+vlc_playlist_item_HasSortKeys(vlc_playlist_item_t *item,
+        const struct vlc_playlist_sort_criterion criteria[], size_t count)
+{
+    if (!item->sort_meta)
+        return false;
+    if (item->sort_meta->revision != input_item_GetRevision(item->media))
+        return false; /* the media changed since the fields were read */
+
+    for (size_t i = 0; i < count; ++i)
+        if (!(item->sort_meta->keys & (1u << criteria[i].key)))
+            return false;
+    return true;
+}
+
+static int
+vlc_playlist_item_InitSortKeys(vlc_playlist_item_t *item,
+        const struct vlc_playlist_sort_criterion criteria[], size_t count)
 {
-    /* assume that NULL representation is all-zeros */
-    struct vlc_playlist_item_meta *meta = calloc(1, sizeof(*meta));
-    if (unlikely(!meta))
-        return NULL;
+    if (vlc_playlist_item_HasSortKeys(item, criteria, count))
+        return VLC_SUCCESS;
 
-    meta->item = item;
-    meta->index = index;
+    if (item->sort_meta
+     && item->sort_meta->revision != input_item_GetRevision(item->media))
+    {
+        vlc_playlist_item_meta_Delete(item->sort_meta);
+        item->sort_meta = NULL;
+    }
+
+    if (!item->sort_meta)
+    {
+        /* assume that NULL representation is all-zeros */
+        item->sort_meta = calloc(1, sizeof(*item->sort_meta));
+        if (unlikely(!item->sort_meta))
+            return VLC_ENOMEM;
+    }
 
     vlc_mutex_lock(&item->media->lock);
-    int ret = vlc_playlist_item_meta_InitFields(meta, criteria, count);
+    if (item->sort_meta->keys == 0)
+        item->sort_meta->revision = input_item_GetRevision(item->media);
+    int ret = vlc_playlist_item_meta_InitFields(item->sort_meta, item->media,
+                                                criteria, count);
     vlc_mutex_unlock(&item->media->lock);
 
     if (unlikely(ret != VLC_SUCCESS))
     {
-        free(meta);
-        return NULL;
+        /* the fields initialized so far would be overwritten (and leaked) on
+         * the next attempt */
+        vlc_playlist_item_meta_Delete(item->sort_meta);
+        item->sort_meta = NULL;
     }
 
-    return meta;
+    return ret;
 }
 
-static void
-vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta)
+void
+vlc_playlist_InvalidateSortKeys(vlc_playlist_t *playlist, input_item_t *media)
 {
-    vlc_playlist_item_meta_DestroyFields(meta);
-    free(meta);
+    vlc_playlist_AssertLocked(playlist);
+
+    size_t cursor = 0;
+    vlc_playlist_item_t *item;
+    while ((item = item_index_NextMedia(&playlist->item_index, media,
+                                        &cursor)))
+        if (item->sort_meta)
+        {
+            vlc_playlist_item_meta_Delete(item->sort_meta);
+            item->sort_meta = NULL;
+        }
+}
+
+void
+vlc_playlist_ForgetSortOrder(vlc_playlist_t *playlist)
+{
+    vlc_playlist_AssertLocked(playlist);
+
+    free(playlist->sorted_by);
+    playlist->sorted_by = NULL;
+    playlist->sorted_by_count = 0;
+}
+
+static bool
+vlc_playlist_IsSortedBy(vlc_playlist_t *playlist,
+        const struct vlc_playlist_sort_criterion criteria[], size_t count)
+{
+    return playlist->sorted_by
+        && playlist->sorted_by_count == count
+        && !memcmp(playlist->sorted_by, criteria, count * sizeof(*criteria));
 }
 
 static inline int
@@ -283,14 +388,35 @@ CompareStrings(const char *a, const char *b)
     return a ? 1 : -1;
 }
 
+/* same as vlc_filenamecmp(), using the precomputed collation keys */
 static inline int
-CompareFilenameStrings(const char *a, const char *b)
+CompareFilenameStrings(const char *a, const char *a_key,
+                       const char *b, const char *b_key)
 {
-    if (a && b)
-        return vlc_filenamecmp(a, b);
-    if (!a && !b)
-        return 0;
-    return a ? 1 : -1;
+    if (!a || !b)
+    {
+        if (!a && !b)
+            return 0;
+        return a ? 1 : -1;
+    }
+
+    size_t i;
+    char ca, cb;
+
+    for (i = 0; (ca = a[i]) == (cb = b[i]); i++)
+        if (ca == '\0')
+            return 0;
+
+    if ((unsigned)(ca - '0') > 9 || (unsigned)(cb - '0') > 9)
+        return CollationCompare(a_key, b_key);
+
+    unsigned long long ua = strtoull(a + i, NULL, 10);
+    unsigned long long ub = strtoull(b + i, NULL, 10);
+
+    if (ua == ub)
+        return CollationCompare(a_key, b_key);
+
+    return (ua > ub) ? +1 : -1;
 }
 
 static inline int
@@ -333,13 +459,17 @@ CompareMetaByKey(const struct vlc_playlist_item_meta *a,
     switch (key)
     {
         case VLC_PLAYLIST_SORT_KEY_TITLE:
-            return CompareFilenameStrings(a->title_or_name, b->title_or_name);
+            return CompareFilenameStrings(a->title_or_name,
+                                          a->title_or_name_key,
+                                          b->title_or_name,
+                                          b->title_or_name_key);
         case VLC_PLAYLIST_SORT_KEY_DURATION:
             return CompareIntegers(a->duration, b->duration);
         case VLC_PLAYLIST_SORT_KEY_ARTIST:
             return CompareStrings(a->artist, b->artist);
         case VLC_PLAYLIST_SORT_KEY_ALBUM:
-            return CompareFilenameStrings(a->album, b->album);
+            return CompareFilenameStrings(a->album, a->album_key,
+                                          b->album, b->album_key);
         case VLC_PLAYLIST_SORT_KEY_ALBUM_ARTIST:
             return CompareStrings(a->album_artist, b->album_artist);
         case VLC_PLAYLIST_SORT_KEY_GENRE:
@@ -368,6 +498,13 @@ CompareMetaByKey(const struct vlc_playlist_item_meta *a,
      }
 }
 
+/* item to sort, with its initial position */
+struct sort_entry
+{
+    vlc_playlist_item_t *item;
+    size_t index;
+};
+
 /* context for qsort_r() */
 struct sort_request
 {
@@ -376,13 +513,13 @@ struct sort_request
 };
 
 static int
-compare_meta(const void *lhs, const void *rhs, void *userdata)
+compare_entries(const void *lhs, const void *rhs, void *userdata)
 {
     struct sort_request *req = userdata;
-    const struct vlc_playlist_item_meta *a =
-            *(const struct vlc_playlist_item_meta **) lhs;
-    const struct vlc_playlist_item_meta *b =
-            *(const struct vlc_playlist_item_meta **) rhs;
+    const struct sort_entry *ea = lhs;
+    const struct sort_entry *eb = rhs;
+    const struct vlc_playlist_item_meta *a = ea->item->sort_meta;
+    const struct vlc_playlist_item_meta *b = eb->item->sort_meta;
 
     for (size_t i = 0; i < req->count; ++i)
     {
@@ -399,46 +536,113 @@ compare_meta(const void *lhs, const void *rhs, void *userdata)
 
     /* If the items are equals regarding the sorting criteria, keep their
      * initial relative order, to make the sort stable. */
-    assert(a->index != b->index);
-    return a->index < b->index ? -1 : 1;
+    assert(ea->index != eb->index);
+    return ea->index < eb->index ? -1 : 1;
 }
 
-static void
-vlc_playlist_DeleteMetaArray(struct vlc_playlist_item_meta *array[],
-                             size_t count)
+/**
+ * Sort all the items.
+ */
+static int
+vlc_playlist_SortAll(vlc_playlist_t *playlist, struct sort_request *req,
+                     vlc_playlist_item_t *items[])
 {
-    for (size_t i = 0; i < count; ++i)
-        vlc_playlist_item_meta_Delete(array[i]);
-    free(array);
+    size_t size = item_seq_Size(&playlist->items);
+    struct sort_entry *entries = vlc_alloc(size, sizeof(*entries));
+    if (unlikely(!entries))
+        return VLC_ENOMEM;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        vlc_playlist_item_t *item = item_seq_Get(&playlist->items, i);
+        int ret = vlc_playlist_item_InitSortKeys(item, req->criteria,
+                                                 req->count);
+        if (unlikely(ret != VLC_SUCCESS))
+        {
+            free(entries);
+            return ret;
+        }
+        entries[i].item = item;
+        entries[i].index = i;
+    }
+
+    vlc_qsort(entries, size, sizeof(*entries), compare_entries, req);
+
+    for (size_t i = 0; i < size; ++i)
+        items[i] = entries[i].item;
+
+    free(entries);
+    return VLC_SUCCESS;
 }
 
-static struct vlc_playlist_item_meta **
-vlc_playlist_NewMetaArray(vlc_playlist_t *playlist,
-        const struct vlc_playlist_sort_criterion criteria[], size_t count)
+/**
+ * Sort the items added or updated since the last sort by the same criteria,
+ * and insert them among the others, which are still sorted.
+ */
+static int
+vlc_playlist_SortChanges(vlc_playlist_t *playlist, struct sort_request *req,
+                         vlc_playlist_item_t *items[])
 {
-    struct vlc_playlist_item_meta **array =
-            vlc_alloc(playlist->items.size, sizeof(*array));
+    size_t size = item_seq_Size(&playlist->items);
+    struct sort_entry *entries = vlc_alloc(size, sizeof(*entries));
+    if (unlikely(!entries))
+        return VLC_ENOMEM;
 
-    if (unlikely(!array))
-        return NULL;
+    /* the sorted items are stored from the start, the others from the end */
+    struct sort_entry *sorted = entries;
+    struct sort_entry *changed = entries + size;
+    size_t sorted_count = 0;
+    size_t changed_count = 0;
 
-    size_t i;
-    for (i = 0; i < playlist->items.size; ++i)
+    for (size_t i = 0; i < size; ++i)
     {
-        array[i] = vlc_playlist_item_meta_New(i, playlist->items.data[i],
-                                              criteria, count);
-        if (unlikely(!array[i]))
-            break;
+        vlc_playlist_item_t *item = item_seq_Get(&playlist->items, i);
+        if (vlc_playlist_item_HasSortKeys(item, req->criteria, req->count))
+            sorted[sorted_count++] = (struct sort_entry) { item, i };
+        else
+        {
+            int ret = vlc_playlist_item_InitSortKeys(item, req->criteria,
+                                                     req->count);
+            if (unlikely(ret != VLC_SUCCESS))
+            {
+                free(entries);
+                return ret;
+            }
+            changed_count++;
+            changed[-(ptrdiff_t) changed_count] =
+                (struct sort_entry) { item, i };
+        }
     }
+    changed -= changed_count;
+
+    vlc_qsort(changed, changed_count, sizeof(*changed), compare_entries, req);
 
-    if (i < playlist->items.size)
+    /* merge, finding the position of each changed item by binary search */
+    size_t out = 0;
+    size_t lo = 0;
+    for (size_t i = 0; i < changed_count; ++i)
     {
-        /* allocation failure */
-        vlc_playlist_DeleteMetaArray(array, i);
-        return NULL;
+        size_t hi = sorted_count;
+        size_t start = lo;
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (compare_entries(&sorted[mid], &changed[i], req) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        while (start < lo)
+            items[out++] = sorted[start++].item;
+        items[out++] = changed[i].item;
     }
+    while (lo < sorted_count)
+        items[out++] = sorted[lo++].item;
+    assert(out == size);
 
-    return array;
+    free(entries);
+    return VLC_SUCCESS;
 }
 
 int
@@ -449,24 +653,52 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
     assert(count > 0);
     vlc_playlist_AssertLocked(playlist);
 
-    vlc_playlist_item_t *current = playlist->current != -1
-                                 ? playlist->items.data[playlist->current]
-                                 : NULL;
+    vlc_playlist_item_t *current =
+        playlist->current != -1 ? item_seq_Get(&playlist->items,
+                                               playlist->current)
+                                : NULL;
 
-    struct vlc_playlist_item_meta **array =
-        vlc_playlist_NewMetaArray(playlist, criteria, count);
-    if (unlikely(!array))
+    size_t size = item_seq_Size(&playlist->items);
+    vlc_playlist_item_t **items = vlc_alloc(size, sizeof(*items));
+    if (unlikely(!items))
         return VLC_ENOMEM;
 
     struct sort_request req = { criteria, count };
 
-    vlc_qsort(array, playlist->items.size, sizeof(*array), compare_meta, &req);
+    bool incremental = vlc_playlist_IsSortedBy(playlist, criteria, count);
+    vlc_playlist_ForgetSortOrder(playlist);
 
-    /* apply the sorting result to the playlist */
-    for (size_t i = 0; i < playlist->items.size; ++i)
-        playlist->items.data[i] = array[i]->item;
+    int ret = incremental ? vlc_playlist_SortChanges(playlist, &req, items)
+                          : vlc_playlist_SortAll(playlist, &req, items);
+    if (unlikely(ret != VLC_SUCCESS))
+    {
+        free(items);
+        return ret;
+    }
+
+    playlist->sorted_by = vlc_alloc(count, sizeof(*criteria));
+    if (likely(playlist->sorted_by))
+    {
+        memcpy(playlist->sorted_by, criteria, count * sizeof(*criteria));
+        playlist->sorted_by_count = count;
+    }
 
-    vlc_playlist_DeleteMetaArray(array, playlist->items.size);
+    if (incremental)
+    {
+        /* nothing to notify if the items are still in the same order */
+        size_t i = 0;
+        while (i < size && items[i] == item_seq_Get(&playlist->items, i))
+            ++i;
+        if (i == size)
+        {
+            free(items);
+            return VLC_SUCCESS;
+        }
+    }
+
+    /* apply the sorting result to the playlist */
+    item_seq_Write(&playlist->items, 0, size, items);
+    item_index_Invalidate(&playlist->item_index, 0);
 
     struct vlc_playlist_state state;
     if (current)
@@ -478,10 +710,10 @@ vlc_playlist_Sort(vlc_playlist_t *playlist,
         playlist->has_next = vlc_playlist_ComputeHasNext(playlist);
     }
 
-    vlc_playlist_Notify(playlist, on_items_reset, playlist->items.data,
-                        playlist->items.size);
+    vlc_playlist_Notify(playlist, on_items_reset, items, size);
     if (current)
         vlc_playlist_state_NotifyChanges(playlist, &state);
 
+    free(items);
     return VLC_SUCCESS;
 }
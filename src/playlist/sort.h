@@ -0,0 +1,42 @@
+/*****************************************************************************
+ * playlist/sort.h
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifndef VLC_PLAYLIST_SORT_H
+#define VLC_PLAYLIST_SORT_H
+
+typedef struct vlc_playlist vlc_playlist_t;
+typedef struct input_item_t input_item_t;
+
+/* sort keys cached in an item */
+struct vlc_playlist_item_meta;
+
+/* called when the last reference to an item is released */
+void
+vlc_playlist_item_meta_Delete(struct vlc_playlist_item_meta *meta);
+
+/* forget the sort keys of the items of a media, after it has changed */
+void
+vlc_playlist_InvalidateSortKeys(vlc_playlist_t *playlist, input_item_t *media);
+
+/* forget the last sort, after the items have been reordered */
+void
+vlc_playlist_ForgetSortOrder(vlc_playlist_t *playlist);
+
+#endif
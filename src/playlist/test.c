@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include "item.h"
+#include "notify.h"
 #include "playlist.h"
 #include "preparse.h"
 
@@ -269,7 +270,7 @@ test_expand_item(void)
     assert(ret == VLC_SUCCESS);
 
     /* create a subtree for item 8 with 4 children */
-    input_item_t *item_to_expand = playlist->items.data[8]->media;
+    input_item_t *item_to_expand = vlc_playlist_Get(playlist, 8)->media;
     input_item_node_t *root = input_item_node_Create(item_to_expand);
     for (int i = 0; i < 4; ++i)
     {
@@ -315,6 +316,196 @@ test_expand_item(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_expand_item_partially(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[15];
+    CreateDummyMediaArray(media, 15);
+
+    /* initial playlist with 10 items */
+    int ret = vlc_playlist_Append(playlist, media, 10);
+    assert(ret == VLC_SUCCESS);
+
+    playlist->current = 9;
+    playlist->has_prev = true;
+    playlist->has_next = false;
+
+    /* the subtree of item 8 is received in 3 parts */
+    input_item_t *item_to_expand = vlc_playlist_Get(playlist, 8)->media;
+    input_item_node_t *part = input_item_node_Create(item_to_expand);
+    for (int i = 0; i < 2; ++i)
+    {
+        input_item_node_t *node = input_item_node_AppendItem(part, media[i + 10]);
+        assert(node);
+    }
+
+    ret = vlc_playlist_ExpandItemPartiallyFromNode(playlist, part);
+    assert(ret == VLC_SUCCESS);
+    input_item_node_Delete(part);
+
+    part = input_item_node_Create(item_to_expand);
+    for (int i = 0; i < 2; ++i)
+    {
+        input_item_node_t *node = input_item_node_AppendItem(part, media[i + 12]);
+        assert(node);
+    }
+
+    ret = vlc_playlist_ExpandItemPartiallyFromNode(playlist, part);
+    assert(ret == VLC_SUCCESS);
+    input_item_node_Delete(part);
+
+    /* the expanded item is kept after its first parts */
+    assert(vlc_playlist_Count(playlist) == 14);
+    EXPECT_AT(8, 10);
+    EXPECT_AT(9, 11);
+    EXPECT_AT(10, 12);
+    EXPECT_AT(11, 13);
+    EXPECT_AT(12, 8);
+    EXPECT_AT(13, 9);
+    assert(playlist->current == 13);
+
+    part = input_item_node_Create(item_to_expand);
+    input_item_node_t *node = input_item_node_AppendItem(part, media[14]);
+    assert(node);
+
+    ret = vlc_playlist_ExpandItemFromNode(playlist, part);
+    assert(ret == VLC_SUCCESS);
+    input_item_node_Delete(part);
+
+    assert(vlc_playlist_Count(playlist) == 14);
+    EXPECT_AT(7, 7);
+    EXPECT_AT(11, 13);
+    EXPECT_AT(12, 14);
+    EXPECT_AT(13, 9);
+    assert(playlist->current == 13);
+
+    DestroyMediaArray(media, 15);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+test_expand_item_partially_timeout(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[14];
+    CreateDummyMediaArray(media, 14);
+
+    /* initial playlist with 10 items */
+    int ret = vlc_playlist_Append(playlist, media, 10);
+    assert(ret == VLC_SUCCESS);
+
+    /* the first part of the subtree of item 8 is received */
+    input_item_t *item_to_expand = vlc_playlist_Get(playlist, 8)->media;
+    input_item_node_t *part = input_item_node_Create(item_to_expand);
+    for (int i = 0; i < 2; ++i)
+    {
+        input_item_node_t *node = input_item_node_AppendItem(part, media[i + 10]);
+        assert(node);
+    }
+
+    ret = vlc_playlist_ExpandItemPartiallyFromNode(playlist, part);
+    assert(ret == VLC_SUCCESS);
+    input_item_node_Delete(part);
+
+    assert(vlc_playlist_Count(playlist) == 12);
+    EXPECT_AT(10, 8);
+
+    /* the preparsing times out: the received part replaces the item */
+    ret = vlc_playlist_FinishPartialExpansion(playlist, item_to_expand);
+    assert(ret == VLC_SUCCESS);
+
+    assert(vlc_playlist_Count(playlist) == 11);
+    EXPECT_AT(7, 7);
+    EXPECT_AT(8, 10);
+    EXPECT_AT(9, 11);
+    EXPECT_AT(10, 9);
+
+    /* a later expansion of the item does not insert the items again */
+    part = input_item_node_Create(item_to_expand);
+    for (int i = 0; i < 4; ++i)
+    {
+        input_item_node_t *node = input_item_node_AppendItem(part, media[i + 10]);
+        assert(node);
+    }
+
+    ret = vlc_playlist_ExpandItemFromNode(playlist, part);
+    assert(ret == VLC_ENOENT);
+    input_item_node_Delete(part);
+
+    assert(vlc_playlist_Count(playlist) == 11);
+
+    /* an item that was not partially expanded is kept on failure */
+    ret = vlc_playlist_FinishPartialExpansion(playlist, media[9]);
+    assert(ret == VLC_SUCCESS);
+    assert(vlc_playlist_Count(playlist) == 11);
+    EXPECT_AT(10, 9);
+
+    DestroyMediaArray(media, 14);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+test_expand_item_partially_from_player(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[15];
+    CreateDummyMediaArray(media, 15);
+
+    /* initial playlist with 10 items */
+    int ret = vlc_playlist_Append(playlist, media, 10);
+    assert(ret == VLC_SUCCESS);
+
+    /* the first part of the subtree of item 8 is received from the
+     * preparser */
+    input_item_t *item_to_expand = vlc_playlist_Get(playlist, 8)->media;
+    input_item_node_t *part = input_item_node_Create(item_to_expand);
+    for (int i = 0; i < 3; ++i)
+    {
+        input_item_node_t *node = input_item_node_AppendItem(part, media[i + 10]);
+        assert(node);
+    }
+
+    ret = vlc_playlist_ExpandItemPartiallyFromNode(playlist, part);
+    assert(ret == VLC_SUCCESS);
+    input_item_node_Delete(part);
+
+    assert(vlc_playlist_Count(playlist) == 13);
+    EXPECT_AT(10, 12);
+    EXPECT_AT(11, 8);
+
+    /* the item is played meanwhile, and the player posts the whole subtree */
+    input_item_node_t *root = input_item_node_Create(item_to_expand);
+    for (int i = 0; i < 5; ++i)
+    {
+        input_item_node_t *node = input_item_node_AppendItem(root, media[i + 10]);
+        assert(node);
+    }
+
+    ret = vlc_playlist_ExpandItemFromFullNode(playlist, root);
+    assert(ret == VLC_SUCCESS);
+    input_item_node_Delete(root);
+
+    /* the items already inserted are not duplicated */
+    assert(vlc_playlist_Count(playlist) == 14);
+    EXPECT_AT(7, 7);
+    EXPECT_AT(8, 10);
+    EXPECT_AT(9, 11);
+    EXPECT_AT(10, 12);
+    EXPECT_AT(11, 13);
+    EXPECT_AT(12, 14);
+    EXPECT_AT(13, 9);
+
+    DestroyMediaArray(media, 15);
+    vlc_playlist_Delete(playlist);
+}
+
 struct playlist_state
 {
     size_t playlist_size;
@@ -1065,6 +1256,132 @@ test_index_of(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_index_of_after_changes(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[10];
+    CreateDummyMediaArray(media, 10);
+
+    /* initial playlist with 8 items */
+    int ret = vlc_playlist_Append(playlist, media, 8);
+    assert(ret == VLC_SUCCESS);
+
+    uint64_t id5 = vlc_playlist_Get(playlist, 5)->id;
+    assert(vlc_playlist_IndexOfId(playlist, id5) == 5);
+
+    /* insert media[8] at 2, and media[3] again at the end */
+    ret = vlc_playlist_InsertOne(playlist, 2, media[8]);
+    assert(ret == VLC_SUCCESS);
+    ret = vlc_playlist_AppendOne(playlist, media[3]);
+    assert(ret == VLC_SUCCESS);
+
+    /* 0 1 8 2 3 4 5 6 7 3 */
+    assert(vlc_playlist_IndexOfId(playlist, id5) == 6);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[8]) == 2);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[3]) == 4);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[7]) == 8);
+
+    vlc_playlist_Move(playlist, 6, 2, 0);
+
+    /* 5 6 0 1 8 2 3 4 7 3 */
+    assert(vlc_playlist_IndexOfId(playlist, id5) == 0);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[1]) == 3);
+
+    vlc_playlist_item_t *item = vlc_playlist_Get(playlist, 6);
+    vlc_playlist_item_Hold(item);
+    vlc_playlist_Remove(playlist, 1, 6);
+
+    /* 5 4 7 3 */
+    assert(vlc_playlist_IndexOf(playlist, item) == -1);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[3]) == 3);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[8]) == -1);
+    assert(vlc_playlist_IndexOfId(playlist, item->id) == -1);
+    assert(vlc_playlist_IndexOfId(playlist, id5) == 0);
+    vlc_playlist_item_Release(item);
+
+    /* lookups must keep working while the index grows */
+    for (int i = 0; i < 200; ++i)
+    {
+        ret = vlc_playlist_InsertOne(playlist, 1, media[9]);
+        assert(ret == VLC_SUCCESS);
+    }
+    assert(vlc_playlist_IndexOfMedia(playlist, media[9]) == 1);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[7]) == 202);
+    vlc_playlist_Remove(playlist, 1, 199);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[9]) == 1);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[4]) == 2);
+
+    vlc_playlist_Clear(playlist);
+    assert(vlc_playlist_IndexOfId(playlist, id5) == -1);
+    assert(vlc_playlist_IndexOfMedia(playlist, media[5]) == -1);
+
+    DestroyMediaArray(media, 10);
+    vlc_playlist_Delete(playlist);
+}
+
+static void
+test_large_edits(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    /* enough items to span several storage chunks */
+    const size_t count = 3000;
+    input_item_t **media = malloc(count * sizeof(*media));
+    assert(media);
+    CreateDummyMediaArray(media, count);
+
+    /* insert the second half, then the first half before it */
+    int ret = vlc_playlist_Append(playlist, &media[count / 2],
+                                  count - count / 2);
+    assert(ret == VLC_SUCCESS);
+    ret = vlc_playlist_Insert(playlist, 0, media, count / 2);
+    assert(ret == VLC_SUCCESS);
+
+    assert(vlc_playlist_Count(playlist) == count);
+    for (size_t i = 0; i < count; ++i)
+        EXPECT_AT(i, i);
+
+    /* move the last 1000 items to the start */
+    vlc_playlist_Move(playlist, count - 1000, 1000, 0);
+    for (size_t i = 0; i < 1000; ++i)
+        EXPECT_AT(i, count - 1000 + i);
+    for (size_t i = 1000; i < count; ++i)
+        EXPECT_AT(i, i - 1000);
+
+    /* and back */
+    vlc_playlist_Move(playlist, 0, 1000, count - 1000);
+    for (size_t i = 0; i < count; ++i)
+        EXPECT_AT(i, i);
+
+    /* remove every other item, one by one */
+    for (size_t i = 0; i < count / 2; ++i)
+        vlc_playlist_RemoveOne(playlist, i);
+
+    assert(vlc_playlist_Count(playlist) == count / 2);
+    for (size_t i = 0; i < count / 2; ++i)
+    {
+        EXPECT_AT(i, 2 * i + 1);
+        assert(vlc_playlist_IndexOfMedia(playlist, media[2 * i + 1])
+                == (ssize_t) i);
+    }
+
+    vlc_playlist_Remove(playlist, 10, count / 2 - 20);
+    assert(vlc_playlist_Count(playlist) == 20);
+    for (size_t i = 0; i < 10; ++i)
+    {
+        EXPECT_AT(i, 2 * i + 1);
+        EXPECT_AT(10 + i, count - 20 + 2 * i + 1);
+    }
+
+    DestroyMediaArray(media, count);
+    free(media);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_prev(void)
 {
@@ -2349,6 +2666,113 @@ test_sort(void)
     vlc_playlist_Delete(playlist);
 }
 
+static void
+test_sort_changes(void)
+{
+    vlc_playlist_t *playlist = vlc_playlist_New(NULL, VLC_PLAYLIST_PREPARSING_DISABLED, 0, 0);
+    assert(playlist);
+
+    input_item_t *media[8];
+    media[0] = CreateDummyMedia(5); media[0]->i_duration = 10;
+    media[1] = CreateDummyMedia(2); media[1]->i_duration = 20;
+    media[2] = CreateDummyMedia(8); media[2]->i_duration = 30;
+    media[3] = CreateDummyMedia(2); media[3]->i_duration = 10;
+    media[4] = CreateDummyMedia(6); media[4]->i_duration = 20;
+    media[5] = CreateDummyMedia(2); media[5]->i_duration = 5;
+    media[6] = CreateDummyMedia(0); media[6]->i_duration = 30;
+    media[7] = CreateDummyMedia(9); media[7]->i_duration = 10;
+
+    int ret = vlc_playlist_Append(playlist, media, 4);
+    assert(ret == VLC_SUCCESS);
+
+    struct vlc_playlist_callbacks cbs = {
+        .on_items_reset = callback_on_items_reset,
+    };
+
+    struct callback_ctx ctx = CALLBACK_CTX_INITIALIZER;
+    vlc_playlist_listener_id *listener =
+            vlc_playlist_AddListener(playlist, &cbs, &ctx, false);
+    assert(listener);
+
+    struct vlc_playlist_sort_criterion criteria[] = {
+        { VLC_PLAYLIST_SORT_KEY_TITLE, VLC_PLAYLIST_SORT_ORDER_ASCENDING },
+    };
+
+    vlc_playlist_Sort(playlist, criteria, 1);
+
+    EXPECT_AT(0, 1);
+    EXPECT_AT(1, 3);
+    EXPECT_AT(2, 0);
+    EXPECT_AT(3, 2);
+    assert(ctx.vec_items_reset.size == 1);
+
+    /* sorting again does not change anything */
+    vlc_playlist_Sort(playlist, criteria, 1);
+    assert(ctx.vec_items_reset.size == 1);
+
+    /* the new items are merged as if the whole playlist was sorted */
+    ret = vlc_playlist_Insert(playlist, 0, &media[4], 2);
+    assert(ret == VLC_SUCCESS);
+    ret = vlc_playlist_Append(playlist, &media[6], 2);
+    assert(ret == VLC_SUCCESS);
+
+    vlc_playlist_Sort(playlist, criteria, 1);
+
+    EXPECT_AT(0, 6);
+    EXPECT_AT(1, 5);
+    EXPECT_AT(2, 1);
+    EXPECT_AT(3, 3);
+    EXPECT_AT(4, 0);
+    EXPECT_AT(5, 4);
+    EXPECT_AT(6, 2);
+    EXPECT_AT(7, 7);
+    assert(ctx.vec_items_reset.size == 2);
+
+    /* an updated item is moved according to its new metadata */
+    input_item_SetTitle(media[2], "item-1");
+    vlc_playlist_NotifyMediaUpdated(playlist, media[2]);
+
+    vlc_playlist_Sort(playlist, criteria, 1);
+
+    EXPECT_AT(0, 6);
+    EXPECT_AT(1, 2);
+    EXPECT_AT(2, 5);
+    EXPECT_AT(3, 1);
+    EXPECT_AT(4, 3);
+    EXPECT_AT(5, 0);
+    EXPECT_AT(6, 4);
+    EXPECT_AT(7, 7);
+    assert(ctx.vec_items_reset.size == 3);
+
+    /* after a move, the whole playlist is sorted again */
+    vlc_playlist_Move(playlist, 0, 1, 7);
+    vlc_playlist_Sort(playlist, criteria, 1);
+
+    EXPECT_AT(0, 6);
+    EXPECT_AT(1, 2);
+    EXPECT_AT(7, 7);
+    assert(ctx.vec_items_reset.size == 4);
+
+    /* a media changed without notifying the playlist is detected as well */
+    input_item_SetTitle(media[7], "item-3");
+    vlc_playlist_Sort(playlist, criteria, 1);
+
+    EXPECT_AT(0, 6);
+    EXPECT_AT(1, 2);
+    EXPECT_AT(2, 5);
+    EXPECT_AT(3, 1);
+    EXPECT_AT(4, 3);
+    EXPECT_AT(5, 7);
+    EXPECT_AT(6, 0);
+    EXPECT_AT(7, 4);
+    assert(ctx.vec_items_reset.size == 5);
+
+    callback_ctx_destroy(&ctx);
+    vlc_playlist_RemoveListener(playlist, listener);
+    DestroyMediaArray(media, 8);
+    vlc_playlist_Delete(playlist);
+}
+
 static void
 test_stable_sort(void)
 {
@@ -2433,6 +2857,9 @@ int main(void)
     test_remove();
     test_clear();
     test_expand_item();
+    test_expand_item_partially();
+    test_expand_item_partially_timeout();
+    test_expand_item_partially_from_player();
     test_items_added_callbacks();
     test_items_moved_callbacks();
     test_items_removed_callbacks();
@@ -2441,6 +2868,8 @@ int main(void)
     test_playback_order_changed_callbacks();
     test_callbacks_on_add_listener();
     test_index_of();
+    test_index_of_after_changes();
+    test_large_edits();
     test_prev();
     test_next();
     test_goto();
@@ -2458,6 +2887,7 @@ int main(void)
     test_random();
     test_shuffle();
     test_sort();
+    test_sort_changes();
     test_stable_sort();
     return 0;
 }
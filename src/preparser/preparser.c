@@ -41,6 +41,7 @@ union vlc_preparser_cbs_internal
     const struct vlc_preparser_cbs *parser;
     const struct vlc_thumbnailer_cbs *thumbnailer;
     const struct vlc_thumbnailer_to_files_cbs *thumbnailer_to_files;
+    const struct vlc_thumbnailer_batch_cbs *thumbnailer_batch;
 };
 
 struct vlc_preparser_t
@@ -79,10 +80,13 @@ struct vlc_preparser_req
     picture_t *pic;
     struct task_thumbnail_output *outputs;
     size_t output_count;
+    struct vlc_thumbnailer_arg *thumb_args; /**< batch arguments (or NULL) */
+    size_t thumb_arg_count;
 
     vlc_sem_t preparse_ended;
     int preparse_status;
     atomic_bool interrupted;
+    atomic_bool input_ended;
 
     struct vlc_runnable runnable; /**< to be passed to the executor */
 
@@ -108,6 +112,8 @@ PreparserRequestNew(vlc_preparser_t *preparser, void (*run)(void *), input_item_
     req->pic = NULL;
     req->outputs = NULL;
     req->output_count = 0;
+    req->thumb_args = NULL;
+    req->thumb_arg_count = 0;
     vlc_atomic_rc_init(&req->rc);
 
     if (thumb_arg == NULL)
@@ -123,6 +129,7 @@ PreparserRequestNew(vlc_preparser_t *preparser, void (*run)(void *), input_item_
     vlc_sem_init(&req->preparse_ended, 0);
     req->preparse_status = VLC_EGENERIC;
     atomic_init(&req->interrupted, false);
+    atomic_init(&req->input_ended, false);
 
     req->runnable.run = run;
     req->runnable.userdata = req;
@@ -141,6 +148,7 @@ PreparserRequestDelete(struct vlc_preparser_req *req)
     for (size_t i = 0; i < req->output_count; ++i)
         free(req->outputs[i].file_path);
     free(req->outputs);
+    free(req->thumb_args);
     if (req->i11e_ctx != NULL)
         vlc_interrupt_destroy(req->i11e_ctx);
     free(req);
@@ -198,6 +206,22 @@ OnParserSubtreeAdded(input_item_t *item, input_item_node_t *subtree,
         req->cbs.parser->on_subtree_added(req, subtree, req->userdata);
 }
 
+static void
+OnParserPartialSubtreeAdded(input_item_t *item, input_item_node_t *subtree,
+                            void *req_)
+{
+    VLC_UNUSED(item);
+    struct vlc_preparser_req *req = req_;
+
+    if (atomic_load(&req->interrupted))
+    {
+        input_item_node_Delete(subtree);
+        return;
+    }
+
+    req->cbs.parser->on_partial_subtree_added(req, subtree, req->userdata);
+}
+
 static void
 OnParserAttachmentsAdded(input_item_t *item,
                          input_attachment_t *const *array,
@@ -238,10 +262,17 @@ Parse(struct vlc_preparser_req *req, vlc_tick_t deadline)
         .on_subtree_added = OnParserSubtreeAdded,
         .on_attachments_added = OnParserAttachmentsAdded,
     };
+    static const input_item_parser_cbs_t partial_cbs = {
+        .on_ended = OnParserEnded,
+        .on_subtree_added = OnParserSubtreeAdded,
+        .on_attachments_added = OnParserAttachmentsAdded,
+        .on_partial_subtree_added = OnParserPartialSubtreeAdded,
+    };
 
     vlc_object_t *obj = req->preparser->owner;
     const struct input_item_parser_cfg cfg = {
-        .cbs = &cbs,
+        .cbs = req->cbs.parser->on_partial_subtree_added != NULL
+             ? &partial_cbs : &cbs,
         .cbs_data = req,
         .subitems = req->options & VLC_PREPARSER_OPTION_SUBITEMS,
         .interact = req->options & VLC_PREPARSER_OPTION_INTERACT,
@@ -335,10 +366,53 @@ on_thumbnailer_input_event( input_thread_t *input,
         req->pic = picture_Hold(event->thumbnail);
         req->preparse_status = VLC_SUCCESS;
     }
+    else
+        atomic_store(&req->input_ended, true);
     vlc_sem_post(&req->preparse_ended);
     return true;
 }
 
+static input_thread_t *
+ThumbnailerCreateInput(struct vlc_preparser_req *req, bool keyframe_only)
+{
+    static const struct vlc_input_thread_callbacks cbs = {
+        .on_event = on_thumbnailer_input_event,
+    };
+
+    const struct vlc_input_thread_cfg cfg = {
+        .type = INPUT_TYPE_THUMBNAILING,
+        .hw_dec = req->thumb_arg.hw_dec ? INPUT_CFG_HW_DEC_ENABLED
+                                        : INPUT_CFG_HW_DEC_DISABLED,
+        .cbs = &cbs,
+        .cbs_data = req,
+        .thumbnailing.keyframe_only = keyframe_only,
+    };
+
+    return input_Create(req->preparser->owner, req->item, &cfg);
+}
+
+static void
+ThumbnailerSeek(input_thread_t *input, const struct vlc_thumbnailer_arg *arg)
+{
+    assert(arg->seek.speed == VLC_THUMBNAILER_SEEK_PRECISE
+        || arg->seek.speed == VLC_THUMBNAILER_SEEK_FAST);
+    bool fast_seek = arg->seek.speed == VLC_THUMBNAILER_SEEK_FAST;
+
+    switch (arg->seek.type)
+    {
+        case VLC_THUMBNAILER_SEEK_NONE:
+            break;
+        case VLC_THUMBNAILER_SEEK_TIME:
+            input_SetTime(input, arg->seek.time, fast_seek);
+            break;
+        case VLC_THUMBNAILER_SEEK_POS:
+            input_SetPosition(input, arg->seek.pos, fast_seek);
+            break;
+        default:
+            vlc_assert_unreachable();
+    }
+}
+
 static int
 WriteToFile(const block_t *block, const char *path, unsigned mode)
 {
@@ -444,44 +518,17 @@ ThumbnailerRun(void *userdata)
     struct vlc_preparser_req *req = userdata;
     vlc_preparser_t *preparser = req->preparser;
 
-    static const struct vlc_input_thread_callbacks cbs = {
-        .on_event = on_thumbnailer_input_event,
-    };
-
-    const struct vlc_input_thread_cfg cfg = {
-        .type = INPUT_TYPE_THUMBNAILING,
-        .hw_dec = req->thumb_arg.hw_dec ? INPUT_CFG_HW_DEC_ENABLED
-                                        : INPUT_CFG_HW_DEC_DISABLED,
-        .cbs = &cbs,
-        .cbs_data = req,
-    };
-
     vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
                           vlc_tick_now() + preparser->timeout :
                           VLC_TICK_INVALID;
 
-    input_thread_t* input =
-            input_Create( preparser->owner, req->item, &cfg );
+    bool keyframe_only =
+        req->thumb_arg.seek.speed == VLC_THUMBNAILER_SEEK_FAST;
+    input_thread_t* input = ThumbnailerCreateInput(req, keyframe_only);
     if (!input)
         goto error;
 
-    assert(req->thumb_arg.seek.speed == VLC_THUMBNAILER_SEEK_PRECISE
-        || req->thumb_arg.seek.speed == VLC_THUMBNAILER_SEEK_FAST);
-    bool fast_seek = req->thumb_arg.seek.speed == VLC_THUMBNAILER_SEEK_FAST;
-
-    switch (req->thumb_arg.seek.type)
-    {
-        case VLC_THUMBNAILER_SEEK_NONE:
-            break;
-        case VLC_THUMBNAILER_SEEK_TIME:
-            input_SetTime(input, req->thumb_arg.seek.time, fast_seek);
-            break;
-        case VLC_THUMBNAILER_SEEK_POS:
-            input_SetPosition(input, req->thumb_arg.seek.pos, fast_seek);
-            break;
-        default:
-            vlc_assert_unreachable();
-    }
+    ThumbnailerSeek(input, &req->thumb_arg);
 
     int ret = input_Start(input);
     if (ret != VLC_SUCCESS)
@@ -548,6 +595,124 @@ error:
         vlc_preparser_req_Release(req);
 }
 
+static int
+ThumbnailerWait(struct vlc_preparser_req *req, vlc_tick_t deadline)
+{
+    for (;;)
+    {
+        if (deadline == VLC_TICK_INVALID)
+            vlc_sem_wait(&req->preparse_ended);
+        else if (vlc_sem_timedwait(&req->preparse_ended, deadline))
+            return VLC_ETIMEOUT;
+
+        if (atomic_load(&req->interrupted))
+            return -EINTR;
+        if (req->pic != NULL)
+            return VLC_SUCCESS;
+        if (atomic_load(&req->input_ended))
+            return VLC_EGENERIC;
+    }
+}
+
+static void
+ThumbnailerBatchRun(void *userdata)
+{
+    vlc_thread_set_name("vlc-run-thumb");
+
+    struct vlc_preparser_req *req = userdata;
+    vlc_preparser_t *preparser = req->preparser;
+    const struct vlc_thumbnailer_batch_cbs *cbs = req->cbs.thumbnailer_batch;
+    input_thread_t *input = NULL;
+    bool input_fresh = false;
+    int status = VLC_SUCCESS;
+
+    bool keyframe_only = true;
+    for (size_t i = 0; i < req->thumb_arg_count; ++i)
+        if (req->thumb_args[i].seek.speed != VLC_THUMBNAILER_SEEK_FAST)
+            keyframe_only = false;
+
+    for (size_t i = 0; i < req->thumb_arg_count; ++i)
+    {
+        const struct vlc_thumbnailer_arg *arg = &req->thumb_args[i];
+
+        if (input == NULL)
+        {
+            atomic_store(&req->input_ended, false);
+            input = ThumbnailerCreateInput(req, keyframe_only);
+            if (input == NULL)
+            {
+                status = VLC_EGENERIC;
+                break;
+            }
+
+            ThumbnailerSeek(input, arg);
+            if (input_Start(input) != VLC_SUCCESS)
+            {
+                input_Close(input);
+                input = NULL;
+                status = VLC_EGENERIC;
+                break;
+            }
+            input_fresh = true;
+        }
+        else
+        {   /* Reuse the opened input: the decoder is rearmed by the seek */
+            ThumbnailerSeek(input, arg);
+            input_fresh = false;
+        }
+
+        vlc_tick_t deadline = preparser->timeout != VLC_TICK_INVALID ?
+                              vlc_tick_now() + preparser->timeout :
+                              VLC_TICK_INVALID;
+
+        int ret = ThumbnailerWait(req, deadline);
+        if (ret == -EINTR)
+        {
+            status = -EINTR;
+            break;
+        }
+
+        if (ret != VLC_SUCCESS)
+        {
+            /* The input is not reused after a timeout, as the late
+             * thumbnail would be mistaken for the next one. */
+            input_Stop(input);
+            input_Close(input);
+            input = NULL;
+
+            if (ret == VLC_EGENERIC && !input_fresh && req->pic == NULL)
+            {   /* The input reached its end before processing the seek:
+                 * try again from a new input. */
+                i--;
+                continue;
+            }
+        }
+
+        picture_t *pic = req->pic;
+        req->pic = NULL;
+
+        cbs->on_thumbnail(req, i, pic != NULL ? VLC_SUCCESS : ret, pic,
+                          req->userdata);
+        if (pic != NULL)
+            picture_Release(pic);
+    }
+
+    if (input != NULL)
+    {
+        input_Stop(input);
+        input_Close(input);
+    }
+    if (req->pic != NULL)
+    {
+        picture_Release(req->pic);
+        req->pic = NULL;
+    }
+
+    PreparserRemoveTask(preparser, req);
+    cbs->on_ended(req, status, req->userdata);
+    vlc_preparser_req_Release(req);
+}
+
 static void
 Interrupt(struct vlc_preparser_req *req)
 {
@@ -847,6 +1012,44 @@ vlc_preparser_GenerateThumbnailToFiles( vlc_preparser_t *preparser, input_item_t
     return PreparserRequestRetain(req);
 }
 
+vlc_preparser_req *
+vlc_preparser_GenerateThumbnails( vlc_preparser_t *preparser, input_item_t *item,
+                                  const struct vlc_thumbnailer_arg *args,
+                                  size_t arg_count,
+                                  const struct vlc_thumbnailer_batch_cbs *cbs,
+                                  void *cbs_userdata )
+{
+    assert(preparser->thumbnailer != NULL);
+    assert(cbs != NULL && cbs->on_thumbnail != NULL && cbs->on_ended != NULL);
+    assert(args != NULL && arg_count > 0);
+
+    union vlc_preparser_cbs_internal req_cbs = {
+        .thumbnailer_batch = cbs,
+    };
+
+    struct vlc_preparser_req *req =
+        PreparserRequestNew(preparser, ThumbnailerBatchRun, item,
+                            VLC_PREPARSER_TYPE_THUMBNAIL, &args[0], req_cbs,
+                            cbs_userdata);
+    if (req == NULL)
+        return NULL;
+
+    req->thumb_args = vlc_alloc(arg_count, sizeof(*args));
+    if (unlikely(req->thumb_args == NULL))
+    {
+        PreparserRequestDelete(req);
+        return NULL;
+    }
+    memcpy(req->thumb_args, args, arg_count * sizeof(*args));
+    req->thumb_arg_count = arg_count;
+
+    PreparserAddTask(preparser, req);
+
+    vlc_executor_Submit(preparser->thumbnailer, &req->runnable);
+
+    return PreparserRequestRetain(req);
+}
+
 size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req *req )
 {
     vlc_mutex_lock(&preparser->lock);
@@ -895,6 +1098,13 @@ size_t vlc_preparser_Cancel( vlc_preparser_t *preparser, vlc_preparser_req *req
                     req_itr->cbs.parser->on_ended(req_itr, req_itr->preparse_status,
                                                   req_itr->userdata);
                 }
+                else if (req_itr->thumb_args != NULL)
+                {
+                    assert(req_itr->options & VLC_PREPARSER_TYPE_THUMBNAIL);
+                    req_itr->cbs.thumbnailer_batch->on_ended(req_itr,
+                                                             req_itr->preparse_status,
+                                                             req_itr->userdata);
+                }
                 else if (req_itr->options & VLC_PREPARSER_TYPE_THUMBNAIL)
                 {
                     assert((req_itr->options & VLC_PREPARSER_TYPE_THUMBNAIL_TO_FILES) == 0);
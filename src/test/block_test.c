@@ -86,11 +86,70 @@ static void test_block (void)
     //assert (block == NULL);
 }
 
+static void test_block_Share (void)
+{
+    block_t *block = block_Alloc (sizeof (text));
+    assert (block != NULL);
+    memcpy (block->p_buffer, text, sizeof (text));
+    block->i_pts = VLC_TICK_FROM_SEC(1);
+
+    /* not shareable: copied */
+    block_t *copy = vlc_frame_Share (block);
+    assert (copy != NULL);
+    assert (copy->p_buffer != block->p_buffer);
+    assert (!vlc_frame_IsShared (block));
+    block_Release (copy);
+
+    block = vlc_frame_MakeShareable (block);
+    assert (block != NULL);
+    assert (!vlc_frame_IsShared (block));
+
+    block_t *shared = vlc_frame_Share (block);
+    assert (shared != NULL);
+    assert (shared->p_buffer == block->p_buffer);
+    assert (shared->i_buffer == block->i_buffer);
+    assert (shared->i_pts == VLC_TICK_FROM_SEC(1));
+    assert (vlc_frame_IsShared (block));
+    assert (vlc_frame_IsShared (shared));
+
+    /* copy on write */
+    block_t *writable = vlc_frame_MakeWritable (shared);
+    assert (writable != NULL);
+    assert (writable->p_buffer != block->p_buffer);
+    assert (!memcmp (writable->p_buffer, text, sizeof (text)));
+    memset (writable->p_buffer, 'A', writable->i_buffer);
+    assert (!memcmp (block->p_buffer, text, sizeof (text)));
+    assert (!vlc_frame_IsShared (block));
+    block_Release (writable);
+
+    /* prepending to a shared payload does not overwrite its spare space */
+    shared = vlc_frame_Share (block);
+    assert (shared != NULL);
+    shared = block_Realloc (shared, 2, shared->i_buffer);
+    assert (shared != NULL);
+    assert (shared->p_buffer + 2 != block->p_buffer);
+    shared->p_buffer[0] = shared->p_buffer[1] = 'A';
+    assert (!memcmp (shared->p_buffer + 2, text, sizeof (text)));
+    block_Release (shared);
+
+    /* the last reference can be written in place */
+    shared = vlc_frame_Share (block);
+    assert (shared != NULL);
+    block_Release (block);
+    assert (!vlc_frame_IsShared (shared));
+    uint8_t *buf = shared->p_buffer;
+    shared = vlc_frame_MakeWritable (shared);
+    assert (shared != NULL);
+    assert (shared->p_buffer == buf);
+    block_Release (shared);
+}
+
 int main (void)
 {
     test_block_File(false);
     test_block_File(true);
     test_block ();
+    test_block_Share ();
     return 0;
 }
 
@@ -0,0 +1,185 @@
+/*****************************************************************************
+ * input_item.c: Test for input item metadata snapshots
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#undef NDEBUG
+#include <assert.h>
+
+#include <vlc_common.h>
+#include <vlc_atomic.h>
+#include <vlc_input_item.h>
+#include <vlc_threads.h>
+
+const char vlc_module_name[] = "test_input_item";
+
+static void test_snapshot(void)
+{
+    input_item_t *item = input_item_New("file:///tmp/song.mp3", "song");
+    assert(item);
+
+    const struct input_item_meta_snapshot *snap =
+        input_item_AcquireMetaSnapshot(item);
+    assert(snap);
+    assert(!strcmp(snap->name, "song"));
+    assert(!strcmp(snap->uri, "file:///tmp/song.mp3"));
+    assert(snap->meta[vlc_meta_Title] == NULL);
+    input_item_ReleaseMetaSnapshot(item, snap);
+
+    /* the snapshot is shared as long as the item is not modified */
+    const struct input_item_meta_snapshot *again =
+        input_item_AcquireMetaSnapshot(item);
+    assert(again == snap);
+    input_item_ReleaseMetaSnapshot(item, again);
+
+    input_item_SetTitle(item, "title");
+    input_item_SetArtist(item, "artist");
+    input_item_SetDuration(item, VLC_TICK_FROM_SEC(42));
+
+    snap = input_item_AcquireMetaSnapshot(item);
+    assert(snap);
+    assert(!strcmp(snap->meta[vlc_meta_Title], "title"));
+    assert(!strcmp(snap->meta[vlc_meta_Artist], "artist"));
+    assert(snap->meta[vlc_meta_Album] == NULL);
+    assert(snap->duration == VLC_TICK_FROM_SEC(42));
+    input_item_ReleaseMetaSnapshot(item, snap);
+
+    /* direct meta changes are detected too */
+    vlc_mutex_lock(&item->lock);
+    vlc_meta_Set(item->p_meta, vlc_meta_Album, "album");
+    vlc_mutex_unlock(&item->lock);
+
+    snap = input_item_AcquireMetaSnapshot(item);
+    assert(snap);
+    assert(!strcmp(snap->meta[vlc_meta_Album], "album"));
+
+    /* nested snapshots */
+    const struct input_item_meta_snapshot *nested =
+        input_item_AcquireMetaSnapshot(item);
+    assert(nested == snap);
+    input_item_ReleaseMetaSnapshot(item, nested);
+    assert(!strcmp(snap->name, "song"));
+    input_item_ReleaseMetaSnapshot(item, snap);
+
+    /* a replaced snapshot remains valid until it is released */
+    snap = input_item_AcquireMetaSnapshot(item);
+    assert(snap);
+    input_item_SetTitle(item, "new title");
+    const struct input_item_meta_snapshot *fresh =
+        input_item_AcquireMetaSnapshot(item);
+    assert(fresh && fresh != snap);
+    assert(!strcmp(fresh->meta[vlc_meta_Title], "new title"));
+    assert(!strcmp(snap->meta[vlc_meta_Title], "title"));
+    input_item_ReleaseMetaSnapshot(item, snap);
+    input_item_ReleaseMetaSnapshot(item, fresh);
+    input_item_SetTitle(item, "title");
+
+    input_item_SetName(item, "renamed");
+    char *name = input_item_GetName(item);
+    assert(name && !strcmp(name, "renamed"));
+    free(name);
+
+    char *title = input_item_GetTitleFbName(item);
+    assert(title && !strcmp(title, "title"));
+    free(title);
+
+    input_item_Release(item);
+}
+
+#define READERS 4
+#define WRITES 2000
+
+struct stress_ctx
+{
+    input_item_t *item;
+    atomic_bool stop;
+};
+
+static void *reader_thread(void *data)
+{
+    struct stress_ctx *ctx = data;
+
+    while (!atomic_load(&ctx->stop))
+    {
+        const struct input_item_meta_snapshot *snap =
+            input_item_AcquireMetaSnapshot(ctx->item);
+        assert(snap);
+
+        /* the title and the artist are always written together */
+        const char *title = snap->meta[vlc_meta_Title];
+        const char *artist = snap->meta[vlc_meta_Artist];
+        if (title != NULL)
+        {
+            assert(artist != NULL);
+            assert(!strcmp(title + strlen("title"), artist + strlen("artist")));
+        }
+        input_item_ReleaseMetaSnapshot(ctx->item, snap);
+    }
+    return NULL;
+}
+
+static void test_concurrent(void)
+{
+    struct stress_ctx ctx;
+    ctx.item = input_item_New("file:///tmp/song.mp3", "song");
+    assert(ctx.item);
+    atomic_init(&ctx.stop, false);
+
+    vlc_thread_t threads[READERS];
+    for (size_t i = 0; i < READERS; ++i)
+        assert(vlc_clone(&threads[i], reader_thread, &ctx) == 0);
+
+    for (int i = 0; i < WRITES; ++i)
+    {
+        char title[32], artist[32];
+        snprintf(title, sizeof(title), "title%d", i);
+        snprintf(artist, sizeof(artist), "artist%d", i);
+
+        vlc_mutex_lock(&ctx.item->lock);
+        vlc_meta_Set(ctx.item->p_meta, vlc_meta_Title, title);
+        vlc_meta_Set(ctx.item->p_meta, vlc_meta_Artist, artist);
+        vlc_mutex_unlock(&ctx.item->lock);
+    }
+
+    atomic_store(&ctx.stop, true);
+    for (size_t i = 0; i < READERS; ++i)
+        vlc_join(threads[i], NULL);
+
+    char *title = input_item_GetTitle(ctx.item);
+    assert(title);
+    char expected[32];
+    snprintf(expected, sizeof(expected), "title%d", WRITES - 1);
+    assert(!strcmp(title, expected));
+    free(title);
+
+    input_item_Release(ctx.item);
+}
+
+int main(void)
+{
+    test_snapshot();
+    test_concurrent();
+    return 0;
+}
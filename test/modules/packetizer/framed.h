@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * framed.h: h264/hevc framed access units packetizer unit testing
+ *****************************************************************************
+ * Copyright (C) 2026 VLC authors and VideoLAN
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 2.1 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston MA 02110-1301, USA.
+ *****************************************************************************/
+#include "../../../modules/packetizer/hxxx_nal.h"
+
+static bool is_xps(vlc_fourcc_t codec, const uint8_t *p_nal)
+{
+    if(codec == VLC_CODEC_H264)
+        return (p_nal[0] & 0x1f) == 7 || (p_nal[0] & 0x1f) == 8;
+    const uint8_t i_type = (p_nal[0] & 0x7e) >> 1;
+    return i_type >= 32 && i_type <= 34;
+}
+
+/* Builds an avcC/hvcC with the parameter sets of an annexB access unit */
+static size_t make_xxc(vlc_fourcc_t codec, const block_t *p_au, uint8_t *p_xxc)
+{
+    size_t i_xxc = codec == VLC_CODEC_H264 ? 5 : 23;
+    uint8_t i_count = 0;
+
+    hxxx_iterator_ctx_t it;
+    hxxx_iterator_init(&it, p_au->p_buffer, p_au->i_buffer, 0);
+    const uint8_t *p_nal; size_t i_nal;
+    while(hxxx_annexb_iterate_next(&it, &p_nal, &i_nal))
+    {
+        if(!is_xps(codec, p_nal))
+            continue;
+        if(codec == VLC_CODEC_H264)
+        {
+            /* one NAL per array: SPS then PPS */
+            if((p_nal[0] & 0x1f) == 7)
+                memcpy(&p_xxc[1], &p_nal[1], 3);
+            p_xxc[i_xxc++] = (p_nal[0] & 0x1f) == 7 ? 0xe1 : 0x01;
+        }
+        else
+        {
+            p_xxc[i_xxc++] = (p_nal[0] & 0x7e) >> 1;
+            p_xxc[i_xxc++] = 0x00;
+            p_xxc[i_xxc++] = 0x01;
+        }
+        p_xxc[i_xxc++] = i_nal >> 8;
+        p_xxc[i_xxc++] = i_nal;
+        memcpy(&p_xxc[i_xxc], p_nal, i_nal);
+        i_xxc += i_nal;
+        i_count++;
+    }
+
+    p_xxc[0] = 0x01;
+    if(codec == VLC_CODEC_H264)
+    {
+        p_xxc[4] = 0xff; /* 4 bytes NAL length */
+    }
+    else
+    {
+        p_xxc[21] = 0x03; /* 4 bytes NAL length */
+        p_xxc[22] = i_count;
+    }
+    return i_count ? i_xxc : 0;
+}
+
+/* Replaces the 4 bytes startcodes with NAL lengths */
+static block_t *make_framed(const block_t *p_au)
+{
+    block_t *p_framed = block_Alloc(p_au->i_buffer);
+    if(!p_framed)
+        return NULL;
+    block_CopyProperties(p_framed, p_au);
+    size_t i_framed = 0;
+
+    hxxx_iterator_ctx_t it;
+    hxxx_iterator_init(&it, p_au->p_buffer, p_au->i_buffer, 0);
+    const uint8_t *p_nal; size_t i_nal;
+    while(hxxx_annexb_iterate_next(&it, &p_nal, &i_nal))
+    {
+        SetDWBE(&p_framed->p_buffer[i_framed], i_nal);
+        memcpy(&p_framed->p_buffer[i_framed + 4], p_nal, i_nal);
+        i_framed += 4 + i_nal;
+    }
+    p_framed->i_buffer = i_framed;
+    return p_framed;
+}
+
+/* Feeds the annexB access units as length prefixed ones and expects
+ * the same access units back */
+static int test_packetize_framed(const char *run,
+                                 const uint8_t *p_data, size_t i_data,
+                                 const struct params_s *params)
+{
+    decoder_t *p = create_packetizer(params->vlc,
+                                     params->i_rate_num,
+                                     params->i_rate_den,
+                                     params->codec, NULL, 0);
+    EXPECT(p != NULL);
+
+    block_t *in = block_Alloc(i_data);
+    EXPECT(in != NULL);
+    memcpy(in->p_buffer, p_data, i_data);
+    in->i_dts = VLC_TICK_0;
+
+    block_t *auchain = NULL;
+    block_t **auappend = &auchain;
+    block_t *out;
+    while((out = p->pf_packetize(p, &in)))
+        block_ChainLastAppend(&auappend, out);
+    while((out = p->pf_packetize(p, NULL)))
+        block_ChainLastAppend(&auappend, out);
+    delete_packetizer(p);
+    EXPECT(auchain != NULL);
+
+    uint8_t xxc[512];
+    size_t i_xxc = make_xxc(params->codec, auchain, xxc);
+    EXPECT(i_xxc > 0);
+
+    p = create_packetizer(params->vlc, params->i_rate_num,
+                          params->i_rate_den, params->codec, xxc, i_xxc);
+    EXPECT(p != NULL);
+    EXPECT(p->fmt_out.i_extra > 0);
+
+    unsigned i_count = 0;
+    for(const block_t *au = auchain; au; au = au->p_next)
+    {
+        in = make_framed(au);
+        EXPECT(in != NULL);
+        /* the payload shared with another reader must be left untouched */
+        in = vlc_frame_MakeShareable(in);
+        block_t *shared = vlc_frame_Share(in);
+        EXPECT(shared != NULL);
+        block_t *framed = make_framed(au);
+        EXPECT(framed != NULL);
+        out = p->pf_packetize(p, &in);
+        EXPECT(in == NULL);
+        EXPECT(shared->i_buffer == framed->i_buffer);
+        EXPECT(!memcmp(shared->p_buffer, framed->p_buffer, framed->i_buffer));
+        block_Release(shared);
+        block_Release(framed);
+        if(!out)
+            continue;
+        EXPECT(out->i_buffer == au->i_buffer);
+        EXPECT(!memcmp(out->p_buffer, au->p_buffer, au->i_buffer));
+        EXPECT(out->i_dts == au->i_dts);
+        EXPECT(out->i_pts == au->i_pts);
+        EXPECT((out->i_flags & BLOCK_FLAG_TYPE_MASK) ==
+               (au->i_flags & BLOCK_FLAG_TYPE_MASK));
+        block_Release(out);
+        ++i_count;
+    }
+    EXPECT(p->pf_packetize(p, NULL) == NULL);
+    EXPECT(i_count == params->i_frame_count);
+
+    block_ChainRelease(auchain);
+    delete_packetizer(p);
+
+    return OK;
+}
@@ -26,6 +26,7 @@
 #include "../../libvlc/test.h"
 
 #include "packetizer.h"
+#include "framed.h"
 
 /* 16x16, keyint 25, 50frames */
 const uint8_t test_samples_raw_h265[] = {
@@ -146,6 +147,10 @@ int main(void)
     RUN("skip 1st Iframe", test_packetize,
         test_samples_raw_h265 + 10, test_samples_raw_h265_len - 10, 0);
 
+    params.i_frame_count = 2*25;
+    RUN("framed", test_packetize_framed,
+        test_samples_raw_h265, test_samples_raw_h265_len, 0);
+
     libvlc_release(vlc);
     return 0;
 }
@@ -69,7 +69,8 @@ static void delete_packetizer(decoder_t *p_pack)
 
 static decoder_t *create_packetizer(libvlc_instance_t *vlc,
                                     unsigned num, unsigned den,
-                                    vlc_fourcc_t codec)
+                                    vlc_fourcc_t codec,
+                                    const uint8_t *p_extra, size_t i_extra)
 {
     struct packetizer_owner *owner;
     owner = vlc_object_create(vlc->p_libvlc_int, sizeof(*owner));
@@ -84,6 +85,19 @@ static decoder_t *create_packetizer(libvlc_instance_t *vlc,
     owner->fmt_in.video.i_frame_rate = num;
     owner->fmt_in.video.i_frame_rate_base = den;
     owner->fmt_in.b_packetized = false;
+    if(i_extra)
+    {
+        /* length prefixed access units, as from mp4 */
+        owner->fmt_in.p_extra = malloc(i_extra);
+        if(owner->fmt_in.p_extra)
+        {
+            memcpy(owner->fmt_in.p_extra, p_extra, i_extra);
+            owner->fmt_in.i_extra = i_extra;
+        }
+        owner->fmt_in.b_framed = true;
+        if(codec == VLC_CODEC_H264)
+            owner->fmt_in.i_original_fourcc = VLC_FOURCC('a', 'v', 'c', '1');
+    }
     p_pack->fmt_in = &owner->fmt_in;
 
     decoder_LoadModule( p_pack, true, false );
@@ -99,7 +113,7 @@ static int test_packetize(const char *run,
     decoder_t *p = create_packetizer(params->vlc,
                                      params->i_rate_num,
                                      params->i_rate_den,
-                                     params->codec);
+                                     params->codec, NULL, 0);
     EXPECT(p != NULL);
 
     stream_t *s = vlc_stream_MemoryNew(params->obj,
@@ -155,3 +169,4 @@ static int test_packetize(const char *run,
 
     return OK;
 }
+
@@ -257,7 +257,10 @@ static int OutputCheckerSend(sout_stream_t *stream, void *id, vlc_frame_t *f)
 static void *OutputCheckerAdd(sout_stream_t *stream, const es_format_t *fmt,
                               const char *es_id)
 {
-    (void)stream; (void)fmt; (void)es_id;
+    (void)stream; (void)es_id;
+    struct transcode_scenario *scenario = &transcode_scenarios[current_scenario];
+    if (scenario->report_add != NULL)
+        scenario->report_add(fmt);
     return (void*)0x42;
 }
 
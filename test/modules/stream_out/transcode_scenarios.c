@@ -40,6 +40,8 @@ static struct scenario_data
     bool encoder_opened;
     bool encoder_closed;
     bool error_reported;
+    int es_ids[2];
+    unsigned es_count;
 } scenario_data;
 
 static void decoder_fixed_size(decoder_t *dec, vlc_fourcc_t chroma,
@@ -194,6 +196,16 @@ static void encoder_i420_800_600_no_vctx(encoder_t *enc)
 }
 #endif
 
+static void encoder_i420_any_size(encoder_t *enc)
+{
+    /* Keep the size requested by the transcode module, one encoder is
+     * opened per rendition */
+    enc->fmt_in.video.i_chroma
+        = enc->fmt_in.i_codec
+        = VLC_CODEC_I420;
+    scenario_data.encoder_opened = true;
+}
+
 static void encoder_encode_dummy(encoder_t *enc, picture_t *pic)
 {
     (void)enc; (void)pic;
@@ -222,6 +234,28 @@ static void wait_output_reported(const vlc_frame_t *out)
     vlc_sem_post(&scenario_data.wait_stop);
 }
 
+static void wait_output_ignored(const vlc_frame_t *out)
+{
+    (void)out;
+}
+
+static void wait_es_ids_distinct(const es_format_t *fmt)
+{
+    assert(scenario_data.es_count < ARRAY_SIZE(scenario_data.es_ids));
+    for (unsigned i = 0; i < scenario_data.es_count; ++i)
+        assert(scenario_data.es_ids[i] != fmt->i_id);
+    scenario_data.es_ids[scenario_data.es_count++] = fmt->i_id;
+
+    if (scenario_data.es_count == ARRAY_SIZE(scenario_data.es_ids))
+        vlc_sem_post(&scenario_data.wait_stop);
+}
+
+static void converter_any_size(filter_t *filter)
+{
+    (void)filter;
+    scenario_data.converter_opened = true;
+}
+
 static void converter_fixed_size(filter_t *filter, vlc_fourcc_t chroma_in,
         vlc_fourcc_t chroma_out, unsigned width, unsigned height)
 {
@@ -365,6 +399,18 @@ struct transcode_scenario transcode_scenarios[] =
     .decoder_decode = decoder_decode_error,
     .report_error = wait_error_reported,
     .encoder_close = encoder_close,
+},{
+    /* Each rendition must be sent downstream with its own ES id */
+    .source = source_800_600,
+    .sout = "sout=#transcode{renditions=400x300}:output_checker",
+    .decoder_setup = decoder_i420_800_600,
+    .decoder_decode = decoder_decode_dummy,
+    .encoder_setup = encoder_i420_any_size,
+    .encoder_encode = encoder_encode_dummy,
+    .encoder_close = encoder_close,
+    .converter_setup = converter_any_size,
+    .report_output = wait_output_ignored,
+    .report_add = wait_es_ids_distinct,
 }};
 size_t transcode_scenarios_count = ARRAY_SIZE(transcode_scenarios);
 
@@ -374,6 +420,7 @@ void transcode_scenario_init(void)
     scenario_data.output_frame_count = 0;
     scenario_data.converter_opened = false;
     scenario_data.encoder_opened = false;
+    scenario_data.es_count = 0;
     vlc_sem_init(&scenario_data.wait_stop, 0);
 }
 
@@ -338,6 +338,70 @@ static int test_annexb( const char *psz_tag )
     return 0;
 }
 
+static int test_ep3b_find( const char *psz_tag )
+{
+    uint8_t buf[80];
+    memset( buf, 0x42, sizeof(buf) );
+    buf[20] = 0x00; buf[21] = 0x00; buf[22] = 0x01; /* not an escape */
+    buf[40] = 0x00; buf[41] = 0x00; buf[42] = 0x03;
+
+    for( size_t i = 0; i < sizeof(buf); i++ )
+    {
+        /* matches at every offset and on both vector and tail paths */
+        const uint8_t *p = hxxx_ep3b_Find_Bits( &buf[i], &buf[sizeof(buf)] );
+        test_assert(p ? p - buf : -1, i <= 40 ? 40 : -1);
+        p = hxxx_ep3b_Find( &buf[i], &buf[sizeof(buf)] );
+        test_assert(p ? p - buf : -1, i <= 40 ? 40 : -1);
+        p = hxxx_ep3b_Find( buf, &buf[i] );
+        test_assert(p ? p - buf : -1, i >= 43 ? 40 : -1);
+    }
+
+    /* no escape, plain reader */
+    bs_t bs;
+    struct hxxx_bsfw_ep3b_ctx_s bsctx;
+    hxxx_bsfw_ep3b_init( &bs, &bsctx, buf, 40 );
+    test_assert(bs.p_priv == NULL, 1);
+    for( size_t i=0; i<40; i++ )
+        test_assert(bs_read(&bs, 8), buf[i]);
+    test_assert(bs_eof( &bs ), 1);
+
+    hxxx_bsfw_ep3b_init( &bs, &bsctx, &buf[38], 6 );
+    test_assert(bs.p_priv == &bsctx, 1);
+    test_assert(bs_read(&bs, 32), 0x42420000);
+    test_assert(bs_read(&bs, 8), 0x42);
+    test_assert(bs_eof( &bs ), 1);
+
+    /* header reader, escapes before, across and after the scanned prefix */
+    uint8_t slice[HXXX_EP3B_HEADER_SCAN * 2];
+    const size_t escapes[] = { 1, 10, HXXX_EP3B_HEADER_SCAN - 4,
+                               HXXX_EP3B_HEADER_SCAN - 3,
+                               HXXX_EP3B_HEADER_SCAN - 2,
+                               HXXX_EP3B_HEADER_SCAN - 1,
+                               HXXX_EP3B_HEADER_SCAN + 10 };
+    for( size_t i = 0; i <= ARRAY_SIZE(escapes); i++ )
+    {
+        memset( slice, 0x42, sizeof(slice) );
+        if( i < ARRAY_SIZE(escapes) )
+        {
+            slice[escapes[i]] = slice[escapes[i] + 1] = 0x00;
+            slice[escapes[i] + 2] = 0x03;
+        }
+        bs_t ref;
+        struct hxxx_bsfw_ep3b_ctx_s refctx;
+        hxxx_bsfw_ep3b_ctx_init( &refctx );
+        bs_init_custom( &ref, slice, sizeof(slice),
+                        &hxxx_bsfw_ep3b_callbacks, &refctx );
+        hxxx_bsfw_ep3b_init_header( &bs, &bsctx, slice, sizeof(slice) );
+        while( !bs_eof( &ref ) )
+        {
+            test_assert(bs_pos( &bs ), bs_pos( &ref ));
+            test_assert(bs_read( &bs, 5 ), bs_read( &ref, 5 ));
+        }
+        test_assert(bs_eof( &bs ), 1);
+    }
+
+    return 0;
+}
 
 int main( void )
 {
@@ -376,5 +440,8 @@ int main( void )
     if( test_annexb( "annexb ") )
         return 1;
 
+    if( test_ep3b_find( "ep3b find" ) )
+        return 1;
+
     return 0;
 }
@@ -1978,6 +1978,67 @@ test_seeks(struct ctx *ctx)
     test_end(ctx);
 }
 
+/* Returns the number of buffering restarts: the initial ones, then one per
+ * seek processed by the input */
+static size_t
+test_scrubbing_seeks(struct ctx *ctx, bool superseded_seeks)
+{
+    vlc_player_t *player = ctx->player;
+
+    struct media_params params = DEFAULT_MEDIA_PARAMS(VLC_TICK_FROM_SEC(10));
+    player_set_current_mock_media(ctx, "media1", &params, false);
+
+    assert(!vlc_player_IsScrubbing(player));
+    vlc_player_SetScrubbing(player, true);
+    assert(vlc_player_IsScrubbing(player));
+    player_start(ctx);
+
+    /* The input thread waits for the player lock to send its first event,
+     * so all the seeks are queued before it handles any of them */
+    if (superseded_seeks)
+    {
+        vlc_player_SetTimeFast(player, VLC_TICK_FROM_SEC(2));
+        vlc_player_SetTimeFast(player, VLC_TICK_FROM_SEC(1));
+        vlc_player_SetPosition(player, 0.2f);
+    }
+    vlc_tick_t seek_time = VLC_TICK_FROM_SEC(9);
+    vlc_player_SetTimeFast(player, seek_time);
+
+    vec_on_position_changed *positions = &ctx->report.on_position_changed;
+    while (positions->size == 0 || VEC_LAST(positions).time < seek_time)
+        vlc_player_CondWait(player, &ctx->wait);
+    assert_position(ctx, &VEC_LAST(positions));
+
+    size_t seek_count = 0;
+    float buffering;
+    vlc_vector_foreach(buffering, &ctx->report.on_buffering_changed)
+        if (buffering == 0.0f)
+            seek_count++;
+
+    vlc_player_SetScrubbing(player, false);
+    assert(!vlc_player_IsScrubbing(player));
+
+    test_prestop(ctx);
+
+    wait_state(ctx, VLC_PLAYER_STATE_STOPPED);
+    assert_normal_state(ctx);
+
+    test_end(ctx);
+
+    return seek_count;
+}
+
+static void
+test_scrubbing(struct ctx *ctx)
+{
+    test_log("scrubbing\n");
+
+    /* only the last seek is taken into account */
+    size_t seek_count = test_scrubbing_seeks(ctx, false);
+    size_t scrub_seek_count = test_scrubbing_seeks(ctx, true);
+    assert(scrub_seek_count == seek_count);
+}
+
 #define assert_media_name(media, name) do { \
     assert(media); \
     char *media_name = input_item_GetName(media); \
@@ -3152,6 +3213,7 @@ main(void)
     test_set_current_media(&ctx);
     test_next_media(&ctx);
     test_seeks(&ctx);
+    test_scrubbing(&ctx);
     test_pause(&ctx);
     test_capabilities_pause(&ctx);
     test_capabilities_seek(&ctx);
@@ -186,6 +186,116 @@ static void test_thumbnails( libvlc_instance_t* p_vlc )
     }
 }
 
+struct test_batch_ctx
+{
+    vlc_cond_t cond;
+    vlc_mutex_t lock;
+    size_t next_idx;
+    const vlc_tick_t *expected_times;
+    bool b_done;
+};
+
+static void thumbnailer_batch_thumbnail( vlc_preparser_req *req, size_t index,
+                                         int status, picture_t* thumbnail,
+                                         void *data )
+{
+    (void) req;
+    struct test_batch_ctx* p_ctx = data;
+    vlc_mutex_lock( &p_ctx->lock );
+
+    assert( index == p_ctx->next_idx && "Unexpected thumbnail order" );
+    assert( status == VLC_SUCCESS );
+    assert( thumbnail != NULL );
+    assert( thumbnail->format.i_chroma == VLC_CODEC_ARGB );
+
+    /* The mock demuxer outputs a frame every 40ms (25fps) */
+    vlc_tick_t expected_date = VLC_TICK_0 + p_ctx->expected_times[index];
+    assert( thumbnail->date > expected_date - VLC_TICK_FROM_MS( 40 ) &&
+            thumbnail->date < expected_date + VLC_TICK_FROM_MS( 40 ) &&
+            "Thumbnail not taken at the requested time" );
+    p_ctx->next_idx++;
+
+    vlc_mutex_unlock( &p_ctx->lock );
+}
+
+static void thumbnailer_batch_ended( vlc_preparser_req *req, int status,
+                                     void *data )
+{
+    struct test_batch_ctx* p_ctx = data;
+    vlc_mutex_lock( &p_ctx->lock );
+
+    assert( status == VLC_SUCCESS );
+    p_ctx->b_done = true;
+    vlc_cond_signal( &p_ctx->cond );
+    vlc_mutex_unlock( &p_ctx->lock );
+    vlc_preparser_req_Release( req );
+}
+
+static void test_batch_thumbnails( libvlc_instance_t* p_vlc )
+{
+    struct test_batch_ctx ctx;
+    vlc_cond_init( &ctx.cond );
+    vlc_mutex_init( &ctx.lock );
+    ctx.next_idx = 0;
+    ctx.b_done = false;
+
+    const struct vlc_preparser_cfg cfg = {
+        .types = VLC_PREPARSER_TYPE_THUMBNAIL,
+        .timeout = VLC_TICK_INVALID,
+    };
+    vlc_preparser_t* p_thumbnailer = vlc_preparser_New(
+                VLC_OBJECT( p_vlc->p_libvlc_int ), &cfg );
+    assert( p_thumbnailer != NULL );
+
+    char* psz_mrl;
+    if ( asprintf( &psz_mrl, "mock://video_track_count=1;audio_track_count=1"
+                   ";length=%" PRId64 ";video_chroma=ARGB", MOCK_DURATION ) < 0 )
+        assert( !"Failed to allocate mock mrl" );
+    input_item_t* p_item = input_item_New( psz_mrl, "mock item" );
+    assert( p_item != NULL );
+
+    /* Several thumbnails from a single input, including a backward seek */
+    struct vlc_thumbnailer_arg args[4];
+    for ( size_t i = 0; i < ARRAY_SIZE(args); ++i )
+    {
+        args[i].seek.type = VLC_THUMBNAILER_SEEK_TIME;
+        args[i].seek.speed = VLC_THUMBNAILER_SEEK_FAST;
+        args[i].hw_dec = false;
+    }
+    args[0].seek.time = VLC_TICK_FROM_SEC( 10 );
+    args[1].seek.time = VLC_TICK_FROM_SEC( 120 );
+    args[2].seek.time = VLC_TICK_FROM_SEC( 60 );
+    args[3].seek.type = VLC_THUMBNAILER_SEEK_POS;
+    args[3].seek.pos = .9f;
+
+    const vlc_tick_t expected_times[ARRAY_SIZE(args)] = {
+        VLC_TICK_FROM_SEC( 10 ), VLC_TICK_FROM_SEC( 120 ),
+        VLC_TICK_FROM_SEC( 60 ), MOCK_DURATION * 9 / 10,
+    };
+    ctx.expected_times = expected_times;
+
+    static const struct vlc_thumbnailer_batch_cbs cbs = {
+        .on_thumbnail = thumbnailer_batch_thumbnail,
+        .on_ended = thumbnailer_batch_ended,
+    };
+
+    vlc_mutex_lock( &ctx.lock );
+    vlc_preparser_req *req =
+        vlc_preparser_GenerateThumbnails( p_thumbnailer, p_item, args,
+                                          ARRAY_SIZE(args), &cbs, &ctx );
+    assert( req != NULL );
+
+    while ( ctx.b_done == false )
+        vlc_cond_wait( &ctx.cond, &ctx.lock );
+    assert( ctx.next_idx == ARRAY_SIZE(args) );
+    vlc_mutex_unlock( &ctx.lock );
+
+    input_item_Release( p_item );
+    free( psz_mrl );
+
+    vlc_preparser_Delete( p_thumbnailer );
+}
+
 static void thumbnailer_callback_cancel( vlc_preparser_req *req, int status,
                                          picture_t* p_thumbnail, void *data )
 {
@@ -244,6 +354,7 @@ int main( void )
     assert(vlc);
 
     test_thumbnails( vlc );
+    test_batch_thumbnails( vlc );
     test_cancel_thumbnail( vlc );
 
     libvlc_release( vlc );